@@ -1 +1,5 @@
-g++ cppcompiler/Lexer/main.cpp -o compiler.app -std=c++17
\ No newline at end of file
+g++ cppcompiler/Lexer/main.cpp -o compiler.app -std=c++17 -pthread
+g++ -O2 cppcompiler/Lexer/Benchmark/benchmark.cpp -o benchmark.app -std=c++17 -pthread
+g++ cppcompiler/Lexer/Test/LexerTest.cpp -o lexertest.app -std=c++17 -pthread && ./lexertest.app
+g++ cppcompiler/Parser/Test/ParserTest.cpp -o parsertest.app -std=c++17 -pthread && ./parsertest.app
+g++ cppcompiler/Typer/Test/TyperTest.cpp -o typertest.app -std=c++17 -pthread && ./typertest.app
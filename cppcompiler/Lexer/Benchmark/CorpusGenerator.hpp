@@ -0,0 +1,118 @@
+//
+//  CorpusGenerator.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "../SourceBuffer.hpp"
+
+// Builds a program of any size out of the constructs used in programs/*.yw:
+// generic structs and functions, string literals, numbers, comments and directives.
+// Every snippet is numbered, so identifiers keep being new as the corpus grows.
+// The same seed and size always give the same corpus.
+
+const char* const corpus_snippets[] = {
+    "struct Node$<Value> {\n"
+    "    next: Node$<Value>*;\n"
+    "    value: Value;\n"
+    "    count: Int;\n"
+    "}\n\n",
+
+    "func list$_append<T>(head: Node$<T>*, value: T) -> Int {\n"
+    "    node := new Node$<T>;\n"
+    "    node.value = value;\n"
+    "    current := head;\n"
+    "    i := 0;\n"
+    "    while (current.next != null) {\n"
+    "        current = current.next;\n"
+    "        i = i + 1;\n"
+    "    }\n"
+    "    current.next = node;\n"
+    "    return i * 31 + 1024;\n"
+    "}\n\n",
+
+    "func print$(value: Int) {\n"
+    "    // prints the value $\n"
+    "    printf(\"value %d\\n\", value);\n"
+    "    message := \"a string literal with \\\"quotes\\\" and \\t tabs\";\n"
+    "    /* block comment /* nested */ */\n"
+    "}\n\n",
+
+    "func math$(x: Float) -> Float {\n"
+    "    a := 3.14159 * x;\n"
+    "    b := 2.5e10 / (x + 1.0);\n"
+    "    c := cast(Float) $ - 0.001;\n"
+    "    if (a > b && c <= 100) { return a; } else { return b + c; }\n"
+    "}\n\n",
+
+    "func text$() -> String {\n"
+    "    return \"\"\"\n"
+    "multi-line string $\n"
+    "    with \"quotes\" inside\n"
+    "\"\"\";\n"
+    "}\n\n",
+
+    "func malloc$(size: Int) -> Void* #foreign;\n"
+    "func `free`(pointer: Void*) #foreign;\n\n",
+
+    "enum Kind$ { first; second; third; }\n"
+    "func kind$(kind: Kind$) -> Bool {\n"
+    "    switch (kind) {\n"
+    "        case first: { return true; }\n"
+    "        case second: { fallthrough; }\n"
+    "        case third: { return false; }\n"
+    "    }\n"
+    "    defer free(kind);\n"
+    "    return sizeof(Kind$) == 8;\n"
+    "}\n\n",
+};
+const int CORPUS_SNIPPETS_COUNT = sizeof(corpus_snippets) / sizeof(corpus_snippets[0]);
+const int CORPUS_PARSEABLE_SNIPPETS_COUNT = CORPUS_SNIPPETS_COUNT - 1; // the parser has no enums and switches yet
+
+// xorshift, good enough to pick snippets
+unsigned int corpus_random(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// the corpus is at most as long as the size, and ends after a whole snippet
+// only the first snippets_count snippets are used
+void corpus_generate(SourceBuffer *buffer, long size, unsigned int seed, int snippets_count) {
+    memset(buffer, 0, sizeof(*buffer));
+    buffer->characters = (char*) calloc(size + SOURCE_BUFFER_PADDING, 1);
+
+    char snippet[1024];
+    unsigned int state = seed != 0 ? seed : 1;
+    long length = 0;
+
+    for (int n = 0; ; n++) {
+        const char *format = corpus_snippets[corpus_random(&state) % snippets_count];
+        char number[16];
+        int number_length = snprintf(number, sizeof(number), "%d", n);
+
+        int snippet_length = 0;
+        for (const char *c = format; *c != 0; c++) {
+            if (*c == '$') {
+                memcpy(snippet + snippet_length, number, number_length);
+                snippet_length += number_length;
+            } else {
+                snippet[snippet_length++] = *c;
+            }
+        }
+
+        if (length + snippet_length > size) {
+            break;
+        }
+        memcpy(buffer->characters + length, snippet, snippet_length);
+        length += snippet_length;
+    }
+    buffer->length = length;
+}
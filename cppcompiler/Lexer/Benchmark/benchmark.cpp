@@ -0,0 +1,311 @@
+//
+//  benchmark.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+// Lexer benchmark over generated corpora, nothing is printed while the clock runs.
+// Also times the whole frontend, lexing then parsing against both at once through ParserPipeline.cpp.
+// Prints one JSON object per line and input, so the results can be compared between commits.
+//
+// benchmark.app [-size 1K|64K|1M|16M|1G]... [-file path]... [-repeat 5] [-label name] [-write path]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <string>
+#include <iostream>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <chrono>
+#include <fstream>
+#include <sys/resource.h>
+
+// ALLOCATION COUNTING
+
+// the pipelined frontend allocates on the lexing and the parsing thread at once
+std::atomic<long> benchmark_allocations(0);
+std::atomic<long> benchmark_allocated_bytes(0);
+
+inline void benchmark_count_allocation(size_t size) {
+    benchmark_allocations.fetch_add(1, std::memory_order_relaxed);
+    benchmark_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* counted_malloc(size_t size) {
+    benchmark_count_allocation(size);
+    return malloc(size);
+}
+
+void* counted_calloc(size_t count, size_t size) {
+    benchmark_count_allocation(count * size);
+    return calloc(count, size);
+}
+
+void* counted_realloc(void *pointer, size_t size) {
+    benchmark_count_allocation(size);
+    return realloc(pointer, size);
+}
+
+void* operator new(size_t size) {
+    benchmark_count_allocation(size);
+    void *pointer = malloc(size);
+    if (pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept {
+    (void) size;
+    free(pointer);
+}
+
+// only the lexer's own allocations are counted, the system headers are already included
+#define malloc(size) counted_malloc(size)
+#define calloc(count, size) counted_calloc(count, size)
+#define realloc(pointer, size) counted_realloc(pointer, size)
+#include "../Lexer.cpp"
+#undef malloc
+#undef calloc
+#undef realloc
+
+#include "../LexerIncremental.cpp"
+#include "../TokenWriter.hpp"
+#include "../../Parser/Parser.cpp"
+#include "../../Parser/ParserPipeline.cpp"
+#include "CorpusGenerator.hpp"
+
+using namespace std::chrono;
+
+const int BENCHMARK_MAX_INPUTS = 64;
+
+struct BenchmarkInput {
+    long size; // generated when there is no path
+    char *path;
+};
+typedef struct BenchmarkInput BenchmarkInput;
+
+struct BenchmarkArguments {
+    BenchmarkInput inputs[BENCHMARK_MAX_INPUTS];
+    int inputs_count;
+    int repeat;
+    const char *label;
+    char *write_path;
+};
+typedef struct BenchmarkArguments BenchmarkArguments;
+
+// 64K, 16M, 1G
+long parse_size(const char *string) {
+    char *suffix;
+    long size = strtol(string, &suffix, 10);
+    switch (*suffix) {
+        case 'K': case 'k': return size << 10;
+        case 'M': case 'm': return size << 20;
+        case 'G': case 'g': return size << 30;
+        default: return size;
+    }
+}
+
+bool parse_benchmark_arguments(BenchmarkArguments *arguments, int argc, char **argv) {
+    memset(arguments, 0, sizeof(*arguments));
+    arguments->repeat = 5;
+    arguments->label = "";
+
+    for (int i = 1; i < argc; i++) {
+        char *argument = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(argument, "-size") == 0 && has_value && arguments->inputs_count < BENCHMARK_MAX_INPUTS) {
+            arguments->inputs[arguments->inputs_count++].size = parse_size(argv[++i]);
+        } else if (strcmp(argument, "-file") == 0 && has_value && arguments->inputs_count < BENCHMARK_MAX_INPUTS) {
+            arguments->inputs[arguments->inputs_count++].path = argv[++i];
+        } else if (strcmp(argument, "-repeat") == 0 && has_value) {
+            arguments->repeat = atoi(argv[++i]);
+        } else if (strcmp(argument, "-label") == 0 && has_value) {
+            arguments->label = argv[++i];
+        } else if (strcmp(argument, "-write") == 0 && has_value) {
+            arguments->write_path = argv[++i];
+        } else {
+            return false;
+        }
+    }
+
+    if (arguments->inputs_count == 0) {
+        const long default_sizes[] = { 1 << 10, 64 << 10, 1 << 20, 16 << 20, 64 << 20 };
+        for (long size : default_sizes) {
+            arguments->inputs[arguments->inputs_count++].size = size;
+        }
+    }
+    if (arguments->repeat < 1) {
+        arguments->repeat = 1;
+    }
+    return true;
+}
+
+// in kilobytes, the largest the process has been so far
+long peak_rss_kilobytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+// from the source to the tree, the fastest of the runs
+// two phases: all tokens are lexed, then parsed, pipelined: parsed while they're lexed
+// the peaks are the most tokens that each way held in memory at once
+void benchmark_frontend(BenchmarkArguments *arguments, SourceBuffer *source, double *two_phase_seconds,
+                        double *pipeline_seconds, int *two_phase_peak_tokens, int *pipeline_peak_tokens) {
+    *two_phase_seconds = std::numeric_limits<double>::max();
+    *pipeline_seconds = std::numeric_limits<double>::max();
+    Lexer *lexer = lexer_create();
+    Parser *parser = parser_create();
+
+    for (int r = 0; r < arguments->repeat; r++) {
+        auto start = high_resolution_clock::now();
+        Output *output = lexer_analyze(lexer, source->characters, source->length);
+        Ast *ast = parser_parse(parser, output);
+        *two_phase_seconds = std::min(*two_phase_seconds, duration<double>(high_resolution_clock::now() - start).count());
+        *two_phase_peak_tokens = output->tokens.high_water_mark;
+        ast_free(ast);
+        output_free(output);
+
+        start = high_resolution_clock::now();
+        ast = lexer_parse_pipelined(lexer, parser, source->characters, source->length, pipeline_peak_tokens);
+        *pipeline_seconds = std::min(*pipeline_seconds, duration<double>(high_resolution_clock::now() - start).count());
+        output = ast->output;
+        ast_free(ast);
+        output_free(output);
+    }
+    parser_free(parser);
+    lexer_free(lexer);
+}
+
+void benchmark_input(BenchmarkArguments *arguments, BenchmarkInput *input) {
+    SourceBuffer source;
+    if (input->path != NULL) {
+        if (!source_buffer_open(&source, input->path)) {
+            fprintf(stderr, "Could not load file: %s\n", input->path);
+            exit(1);
+        }
+    } else {
+        corpus_generate(&source, input->size, 1, CORPUS_SNIPPETS_COUNT);
+    }
+
+    if (arguments->write_path != NULL) {
+        FILE *file = fopen(arguments->write_path, "wb");
+        if (file != NULL) {
+            fwrite(source.characters, 1, source.length, file);
+            fclose(file);
+        }
+    }
+
+    // the fastest of the runs, the allocations of the last one
+    double best_seconds = std::numeric_limits<double>::max();
+    int tokens_count = 0;
+    long allocations = 0;
+    long allocated_bytes = 0;
+
+    for (int r = 0; r < arguments->repeat; r++) {
+        Lexer *lexer = lexer_create();
+
+        benchmark_allocations = 0;
+        benchmark_allocated_bytes = 0;
+        auto start = high_resolution_clock::now();
+        Output *output = lexer_analyze(lexer, source.characters, source.length);
+        auto stop = high_resolution_clock::now();
+        allocations = benchmark_allocations;
+        allocated_bytes = benchmark_allocated_bytes;
+
+        double seconds = duration<double>(stop - start).count();
+        if (seconds < best_seconds) {
+            best_seconds = seconds;
+        }
+        tokens_count = output->tokens_count;
+        output_free(output);
+        lexer_free(lexer);
+    }
+    // before the runs below, which are not the lexer's, but the process's peak so far
+    long peak_rss_kb = peak_rss_kilobytes();
+
+    // one character typed in the middle of the file
+    Lexer *lexer = lexer_create();
+    Output *output = lexer_analyze(lexer, source.characters, source.length);
+    TextEdit edit;
+    edit.offset = (int) source.length / 2;
+    edit.removed_length = 0;
+    edit.inserted = " ";
+    edit.inserted_length = 1;
+    int edited_count;
+    char *edited = text_edit_apply(source.characters, source.length, edit, &edited_count);
+    auto relex_start = high_resolution_clock::now();
+    lexer_relex(lexer, output, edited, edited_count, edit);
+    double relex_seconds = duration<double>(high_resolution_clock::now() - relex_start).count();
+
+    // what -tokens prints, written to nowhere
+    std::ofstream discarded("/dev/null", std::ios::binary);
+    auto dump_start = high_resolution_clock::now();
+    TokenWriter writer;
+    token_writer_init(&writer, &discarded, TOKEN_FORMAT_TEXT);
+    token_writer_output(&writer, output);
+    token_writer_free(&writer);
+    double dump_seconds = duration<double>(high_resolution_clock::now() - dump_start).count();
+    output_free(output);
+    lexer_free(lexer);
+    free(edited);
+
+    // the parser stops at the first error, so a generated corpus is made of what it can parse
+    SourceBuffer parseable;
+    if (input->path == NULL) {
+        corpus_generate(&parseable, input->size, 1, CORPUS_PARSEABLE_SNIPPETS_COUNT);
+    }
+    double two_phase_seconds, pipeline_seconds;
+    int two_phase_tokens, pipeline_tokens;
+    benchmark_frontend(arguments, input->path == NULL ? &parseable : &source,
+                       &two_phase_seconds, &pipeline_seconds, &two_phase_tokens, &pipeline_tokens);
+    if (input->path == NULL) {
+        source_buffer_free(&parseable);
+    }
+
+    printf("{\"label\":\"%s\",\"input\":\"%s\",\"bytes\":%ld,\"tokens\":%d,\"seconds\":%.6f,"
+           "\"mb_per_second\":%.2f,\"tokens_per_second\":%.0f,\"allocations\":%ld,\"allocated_bytes\":%ld,"
+           "\"peak_rss_kb\":%ld,\"relex_seconds\":%.6f,\"dump_seconds\":%.6f,"
+           "\"two_phase_seconds\":%.6f,\"pipeline_seconds\":%.6f,\"two_phase_tokens\":%d,\"pipeline_tokens\":%d,"
+           "\"simd\":\"%s\"}\n",
+           arguments->label, input->path != NULL ? input->path : "generated", source.length, tokens_count,
+           best_seconds, source.length / best_seconds / 1000000, tokens_count / best_seconds,
+           allocations, allocated_bytes, peak_rss_kb, relex_seconds, dump_seconds,
+           two_phase_seconds, pipeline_seconds, two_phase_tokens, pipeline_tokens, scan.name);
+    fflush(stdout);
+
+    source_buffer_free(&source);
+}
+
+int main(int argc, char **argv) {
+    BenchmarkArguments arguments;
+    if (!parse_benchmark_arguments(&arguments, argc, argv)) {
+        fprintf(stderr, "usage: %s [-size 1K|64K|1M|16M|1G]... [-file path]... "
+                        "[-repeat count] [-label name] [-write path]\n", argv[0]);
+        return 1;
+    }
+
+    // peak RSS only grows, so it is per input when the inputs go from small to large
+    for (int i = 0; i < arguments.inputs_count; i++) {
+        benchmark_input(&arguments, &arguments.inputs[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+//
+//  Interner.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+// Gives every distinct identifier a stable number,
+// so that later passes compare symbols instead of strings.
+// Keywords and literal names are interned first, in the order of the Keyword enum,
+// so a single lookup tells if an identifier is a keyword.
+
+typedef unsigned int Symbol;
+
+const int KEYWORD_COUNT = 18;
+const char* const keyword_names[KEYWORD_COUNT] = {
+    "func", "break", "continue", "fallthrough", "while", "for", "enum", "struct", "defer", "if", "else",
+    "switch", "case", "return", "cast", "sizeof", "new", "free"
+};
+
+const Symbol SYMBOL_VOID = KEYWORD_COUNT;
+const Symbol SYMBOL_NULL = KEYWORD_COUNT + 1;
+const Symbol SYMBOL_TRUE = KEYWORD_COUNT + 2;
+const Symbol SYMBOL_FALSE = KEYWORD_COUNT + 3;
+const Symbol SYMBOL_PRESEEDED_COUNT = KEYWORD_COUNT + 4;
+
+struct InternedString {
+    unsigned int offset; // in Interner::characters
+    unsigned int length;
+    unsigned int hash;
+};
+typedef struct InternedString InternedString;
+
+struct Interner {
+    Symbol *slots; // symbol + 1, 0 is an empty slot
+    unsigned int slots_capacity; // power of 2
+
+    InternedString *strings; // indexed by symbol
+    unsigned int strings_count;
+    unsigned int strings_capacity;
+
+    char *characters;
+    unsigned int characters_length;
+    unsigned int characters_capacity;
+};
+typedef struct Interner Interner;
+
+unsigned int interner_hash(const char *characters, unsigned int length) {
+    unsigned int hash = 2166136261u; // FNV-1a
+    for (unsigned int c = 0; c < length; c++) {
+        hash ^= (unsigned char) characters[c];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+char* interner_characters(Interner *interner, Symbol symbol) {
+    return interner->characters + interner->strings[symbol].offset;
+}
+
+unsigned int interner_length(Interner *interner, Symbol symbol) {
+    return interner->strings[symbol].length;
+}
+
+void interner_grow_slots(Interner *interner) {
+    unsigned int capacity = interner->slots_capacity == 0 ? 256 : interner->slots_capacity * 2;
+    Symbol *slots = (Symbol*) calloc(capacity, sizeof(Symbol));
+
+    for (unsigned int s = 0; s < interner->strings_count; s++) {
+        unsigned int index = interner->strings[s].hash & (capacity - 1);
+        while (slots[index] != 0) {
+            index = (index + 1) & (capacity - 1);
+        }
+        slots[index] = s + 1;
+    }
+
+    free(interner->slots);
+    interner->slots = slots;
+    interner->slots_capacity = capacity;
+}
+
+Symbol interner_add(Interner *interner, const char *characters, unsigned int length, unsigned int hash) {
+    if (interner->strings_count == interner->strings_capacity) {
+        interner->strings_capacity = interner->strings_capacity == 0 ? 256 : interner->strings_capacity * 2;
+        interner->strings = (InternedString*) realloc(interner->strings,
+                                                      interner->strings_capacity * sizeof(InternedString));
+    }
+    if (interner->characters_length + length + 1 > interner->characters_capacity) {
+        unsigned int capacity = interner->characters_capacity == 0 ? 4096 : interner->characters_capacity;
+        while (interner->characters_length + length + 1 > capacity) {
+            capacity *= 2;
+        }
+        interner->characters = (char*) realloc(interner->characters, capacity);
+        interner->characters_capacity = capacity;
+    }
+
+    InternedString *string = &interner->strings[interner->strings_count];
+    string->offset = interner->characters_length;
+    string->length = length;
+    string->hash = hash;
+    memcpy(interner->characters + string->offset, characters, length);
+    interner->characters[string->offset + length] = 0;
+    interner->characters_length += length + 1;
+
+    Symbol symbol = interner->strings_count;
+    interner->strings_count += 1;
+    return symbol;
+}
+
+Symbol interner_intern(Interner *interner, const char *characters, unsigned int length) {
+    // keep the load factor under a half
+    if ((interner->strings_count + 1) * 2 > interner->slots_capacity) {
+        interner_grow_slots(interner);
+    }
+
+    unsigned int hash = interner_hash(characters, length);
+    unsigned int mask = interner->slots_capacity - 1;
+    unsigned int index = hash & mask;
+
+    while (interner->slots[index] != 0) {
+        Symbol symbol = interner->slots[index] - 1;
+        InternedString *string = &interner->strings[symbol];
+        if (string->hash == hash && string->length == length
+            && memcmp(interner->characters + string->offset, characters, length) == 0) {
+            return symbol;
+        }
+        index = (index + 1) & mask;
+    }
+
+    Symbol symbol = interner_add(interner, characters, length, hash);
+    interner->slots[index] = symbol + 1;
+    return symbol;
+}
+
+void interner_init(Interner *interner) {
+    memset(interner, 0, sizeof(*interner));
+    for (int k = 0; k < KEYWORD_COUNT; k++) {
+        interner_intern(interner, keyword_names[k], strlen(keyword_names[k]));
+    }
+    interner_intern(interner, "void", 4);
+    interner_intern(interner, "null", 4);
+    interner_intern(interner, "true", 4);
+    interner_intern(interner, "false", 5);
+}
+
+void interner_free(Interner *interner) {
+    free(interner->slots);
+    free(interner->strings);
+    free(interner->characters);
+    memset(interner, 0, sizeof(*interner));
+}
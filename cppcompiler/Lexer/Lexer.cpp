@@ -7,506 +7,530 @@
 //
 
 #include "Lexer.hpp"
+#include "LexerNumbers.hpp"
 
-Cursor *cursor;
-int tokens_count;
-Token *tokens;
-int i = 0;
-char character;
-char* code;
-unsigned long stringCount;
-
-int value_length = 0; // value length
-char* value = (char*) malloc(1000); // @Todo: dynamic buffer for longer strings
-
-char* get_value_in_range(int min, int max) {
-    char* copy = new char[max-min];
-    auto pointer = (char*) &value + min;
-    strcpy(copy, pointer);
-    return copy;
+void value_reset(Lexer *lexer) {
+    memset(lexer->value, 0, lexer->value_length);
+    lexer->value_length = 0;
 }
 
-char* get_value() {
-    char* copy = new char[value_length];
-    strcpy(copy, value);
-    return copy;
+void value_reserve(Lexer *lexer, int count) {
+    while (lexer->value_length + count + 1 >= lexer->value_capacity) {
+        lexer->value = (char*) realloc(lexer->value, lexer->value_capacity * 2);
+        memset(lexer->value + lexer->value_capacity, 0, lexer->value_capacity);
+        lexer->value_capacity *= 2;
+    }
 }
 
-void value_reset() {
-    memset(value, 0, value_length);
-    value_length = 0;
+void value_append_range(Lexer *lexer, const char *characters, int count) {
+    value_reserve(lexer, count);
+    memcpy(lexer->value + lexer->value_length, characters, count);
+    lexer->value_length += count;
 }
 
-void value_append(char character) {
-    value[value_length] = character;
-    value_length += 1;
+void value_append(Lexer *lexer, char character) {
+    value_reserve(lexer, 1);
+    lexer->value[lexer->value_length] = character;
+    lexer->value_length += 1;
 }
 
-int index_in_value_of(char character) {
-    for (int i = 0; i < value_length; i++) {  
-        if (value[i] == character) {
-            return i;
+bool next_char_count(Lexer *lexer, int n) {
+    for (int w = 0; w < n; w++) {
+        lexer->i += 1;
+        if (lexer->characters_count <= lexer->i) {
+            return false;
         }
+        lexer->character = lexer->characters[lexer->i];
     }
-    return -1;
+    return true;
 }
 
-void value_append_string(char* string) {
-    int length = strlen(string);
-    for (int i = 0; i < length; i++) {
-        value_append(string[i]);
-    }
+bool next_char(Lexer *lexer) {
+    return next_char_count(lexer, 1);
 }
 
-function<bool (char)> identifier_comparator = [](char c) {
-    bool is_matching = is_in_range(c, TOKENRANGE_LOWERCASE_MIN, TOKENRANGE_LOWERCASE_MAX)
-        || is_in_range(c, TOKENRANGE_UPPERCASE_MIN, TOKENRANGE_UPPERCASE_MAX)
-        || is_in_range(c, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX)
-        || c == CHAR_UNDERSCORE
-        || c == CHAR_ASTERISK
-        || c == CHAR_ACCENT;
-    bool is_legal = last_char_of(value) != CHAR_ASTERISK 
-        || last_char_of(value) == CHAR_ASTERISK && c == CHAR_ASTERISK;
-    return is_matching && is_legal;
-};
-
-function<bool (char)> number_comparator = [](char c) {
-    return is_in_range(c, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX)
-           || c == CHAR_UNDERSCORE
-           || c == CHAR_DOT
-           || c == CHAR_E 
-           || c == CHAR_DASH;
-};
-
-void advance(int count) {
-    for (int w = 0; w < count; w++) {
-        i += 1;
-        if (character == CHAR_NEWLINE) {
-            advance_cursor_line(cursor);
-        } else {
-            advance_cursor_characters(cursor, count);
-        }
+// moves past the character if it matches
+bool consume(Lexer *lexer, char query) {
+    if (lexer->character == query) {
+        next_char(lexer);
+        return true;
     }
+    return false;
 }
 
-bool next_char_count(int n) {
-    for (int w = 0; w < n; w++) {
-        advance(1);
+// moves to the index, lines are only counted when a cursor is needed
+void advance_to(Lexer *lexer, int index) {
+    lexer->i = index;
+    lexer->character = lexer->characters[lexer->i];
+}
 
-        if (stringCount <= i) {
+bool consume_string(Lexer *lexer, char *string) { // @Todo: test
+    int index = 0;
+    while (string[index] != 0 && lexer->characters_count > lexer->i + index) {
+        if (lexer->characters[lexer->i + index] == string[index]) {
+            index += 1;
+        } else {
             return false;
         }
-        character = code[i];
     }
+    next_char_count(lexer, index); // @Todo: test: nextChar(count-1)
     return true;
 }
 
-bool next_char() {
-    return next_char_count(1);
+char* peek_next_count(Lexer *lexer, int n) {
+    auto nextIndex = lexer->i + n;
+    if (lexer->characters_count <= nextIndex) { return NULL; }
+    return &lexer->characters[nextIndex];
 }
 
-bool consume(char query) {
-    if (character == query) {
-        next_char_count(0);
-        return true;
-    }
-    return false;
+char* peek_next(Lexer *lexer) {
+    return peek_next_count(lexer, 1);
+}
+
+// the token ends at the current character
+void make_token(Lexer *lexer, TokenType type, int start, uint32_t payload) {
+    token_arena_push(&lexer->output->tokens, type, start, lexer->i, payload);
 }
 
-char* consume_next(function <int (char)> compare) {
-    int nextIndex = i + 1;
-    if (stringCount <= nextIndex) {
-        return NULL;
+bool is_next_three_quotes_after(Lexer *lexer, int n) {
+    if (!(lexer->characters_count > lexer->i + 2 + n)) {
+        return false;
     }
-    auto character = &code[nextIndex];
-    if (compare(*character)) { // @Todo: test
-        advance(1);
-        return character;
+    return lexer->characters[lexer->i+n] == CHAR_QUOTE
+        && lexer->characters[lexer->i+1+n] == CHAR_QUOTE
+        && lexer->characters[lexer->i+2+n] == CHAR_QUOTE;
+}
+
+// a speculative lexer only stops, the caller decides if the error is real
+// otherwise the error is recorded, and lex_token skips to where lexing can continue
+void fail_with_error(Lexer *lexer, LexerError error, int start, int end) {
+    lexer->has_failed = true;
+    lexer->error = error;
+    lexer->error_offset = start;
+    if (!lexer->is_speculative) {
+        Diagnostic diagnostic;
+        diagnostic.error = error;
+        diagnostic.offset = start;
+        diagnostic.end_offset = end;
+        diagnostic.token = lexer->output->tokens.count;
+        diagnostics_append(&lexer->output->diagnostics, diagnostic);
     }
-    return NULL;
 }
 
-bool consume_next_char(char query) {
-    return consume_next([query](char character) {
-        return character == query;
-    }) != NULL;
+// moves to the character before the next separator or new line, which is lexed as usual
+void recover_from_error(Lexer *lexer) {
+    int from = lexer->i + 1 < lexer->characters_count ? lexer->i + 1 : lexer->characters_count;
+    int next = scan.find_any_of3(lexer->characters, from, lexer->characters_count,
+                                 CHAR_SEMICOLON, CHAR_COMMA, CHAR_NEWLINE);
+    advance_to(lexer, next - 1);
+    lexer->has_failed = false;
 }
 
-bool consume_string(char *string) { // @Todo: test
-    int index = 0;
-    while (string[index] != 0 && stringCount > i + index) {
-        if (code[i + index] == string[index]) {
-            index += 1;
-        } else {
-            return false;
+// STRING LITERAL
+void lex_string_literal(Lexer *lexer) {
+    int start = lexer->i;
+
+    auto is_multiline = is_next_three_quotes_after(lexer, 0);
+    if (is_multiline) {
+        next_char_count(lexer, 3);
+        if (!consume(lexer, CHAR_NEWLINE)) {
+            fail_with_error(lexer, ERROR_NEWLINE_EXPECTED_BEFORE_MULTILINE_STRING_LITERAL, start, lexer->i);
+            return;
+        }
+    } else {
+        if (!next_char(lexer)) {
+            fail_with_error(lexer, ERROR_UNEXPECTED_END_OF_FILE, start, lexer->i);
+            return;
         }
     }
-    next_char_count(index); // @Todo: test: nextChar(count-1)
-    return true;
-}
 
-// goes through an array with strings of 3 characters
-char* consume_one_of(char *array) {
-    // @Todo: check for eof
-    
-    int index = 0;
-    while (array[index] != 0 && stringCount > i) { // if reached the end (array[i][0] == 0)
-        bool is_matching = true;
-        int length = 0;
-        for (int w = 0; w < 3; w++) {
-            char array_value = array[index + w];
-            char code_value = code[i + w];
-
-            if (array_value != 0 && array_value != code_value) {
-                is_matching = false;
-                break;
+    // the value is only copied out of the source when it contains escape sequences
+    int value_start = lexer->i;
+    bool has_escapes = false;
+
+    value_reset(lexer);
+    while (lexer->characters_count > lexer->i) {
+        // if char == C.newline { /* @Todo: wtf is this? */ }
+
+        // characters before the next quote, backslash or new line need no checks,
+        // except for the last one, which can be followed by one of those
+        int special = scan.find_any_of3(lexer->characters, lexer->i, lexer->characters_count,
+                                        CHAR_QUOTE, CHAR_BACKSLASH, CHAR_NEWLINE);
+        if (special - 1 > lexer->i) {
+            value_append_range(lexer, lexer->characters + lexer->i, special - 1 - lexer->i);
+            advance_to(lexer, special - 1);
+        }
+
+        if (lexer->character == CHAR_BACKSLASH) {
+            auto next = peek_next(lexer);
+            if (next == NULL) {
+                fail_with_error(lexer, ERROR_UNEXPECTED_END_OF_FILE, start, lexer->i);
+                return;
+            }
+
+            switch (*next) {
+            case CHAR_ZERO: { value_append(lexer, 0); break; }
+            case CHAR_N: { value_append(lexer, CHAR_NEWLINE); break; }
+            case CHAR_R: { value_append(lexer, CHAR_RETURN); break; }
+            case CHAR_T: { value_append(lexer, CHAR_TAB); break; }
+            case CHAR_BACKSLASH: { value_append(lexer, CHAR_BACKSLASH); break; }
+            case CHAR_QUOTE: { value_append(lexer, CHAR_QUOTE); break; }
+            default: { fail_with_error(lexer, ERROR_UNEXPECTED_CHARACTER_TO_ESCAPE, lexer->i, lexer->i + 1); return; }
             }
-            if (array_value != 0 && array_value == code_value) {
-                length += 1;
+
+            has_escapes = true;
+            if (!next_char(lexer) || !next_char(lexer)) {
+                fail_with_error(lexer, ERROR_UNEXPECTED_END_OF_FILE, start, lexer->i);
+                return;
             }
+            continue;
         }
 
-        if (is_matching) {
-            auto result = new char[length];
-            result[0] = code[i + 0];
-            if (length > 1) {
-                result[1] = code[i + 1];
+        if (is_multiline) {
+            if (peek_next(lexer) == NULL) {
+                fail_with_error(lexer, ERROR_UNEXPECTED_END_OF_FILE, start, lexer->i);
+                return;
+            } else if (is_next_three_quotes_after(lexer, 0)) {
+                fail_with_error(lexer, ERROR_NEWLINE_EXPECTED_AFTER_MULTILINE_STRING_LITERAL, start, lexer->i);
+                return;
+            } else if (lexer->character == CHAR_NEWLINE && is_next_three_quotes_after(lexer, 1)) {
+                int value_end = lexer->i;
+                next_char_count(lexer, 4);
+
+                auto next = peek_next(lexer);
+                if (next != NULL && *next != CHAR_NEWLINE && *next != CHAR_SEMICOLON) {
+                    fail_with_error(lexer, ERROR_NEWLINE_EXPECTED_AFTER_MULTILINE_STRING_LITERAL, start, lexer->i);
+                    return;
+                } else {
+                    Slice value = has_escapes
+                        ? string_arena_append(&lexer->output->strings, lexer->value, lexer->value_length)
+                        : make_slice(value_start, value_end - value_start);
+                    make_token(lexer, STRINGLITERAL, start, token_arena_push_string(&lexer->output->tokens, value));
+                    break;
+                }
             }
-            if (length > 2) {
-                result[2] = code[i + 2];
+        } else {
+            if (lexer->character == CHAR_QUOTE) {
+                Slice value = has_escapes
+                    ? string_arena_append(&lexer->output->strings, lexer->value, lexer->value_length)
+                    : make_slice(value_start, lexer->i - value_start);
+                make_token(lexer, STRINGLITERAL, start, token_arena_push_string(&lexer->output->tokens, value));
+                break;
+            } else if (peek_next(lexer) != NULL && *peek_next(lexer) == CHAR_NEWLINE) {
+                fail_with_error(lexer, ERROR_NEW_LINE_IN_STRING_LITERAL, start, lexer->i);
+                return;
             }
-
-            // 1 symbol is consumed at the end of the loop
-            next_char_count(length - 1);
-            return result;
         }
 
-        index += 3;
+        value_append(lexer, lexer->character);
+        if (!next_char(lexer)) {
+            fail_with_error(lexer, ERROR_UNEXPECTED_END_OF_FILE, start, lexer->i);
+            return;
+        }
     }
-    return NULL;
-}
-
-char* peek_next_count(int n) {
-    auto nextIndex = i + n;
-    if (stringCount <= nextIndex) { return NULL; }
-    return &code[nextIndex];
-}
-
-char* peek_next() {
-    return peek_next_count(1);
 }
 
-void token_append(Token *token, Cursor *start, Cursor *end) {
-    token->start = *start;
-    token->end = *end;
-    tokens[tokens_count] = *token;
-    tokens_count += 1;
-}
+// COMMENTS
+void lex_comment(Lexer *lexer) {
+    char *code = lexer->characters;
+    int count = lexer->characters_count;
 
-Token* make_token(TokenType type) {
-    Token *token = (Token*) malloc(sizeof(*token));
-    token->type = type;
-    return token;
-}
+    if (*peek_next(lexer) == CHAR_SLASH) {
+        int end = scan.find_any_of3(code, lexer->i + 2, count, CHAR_NEWLINE, CHAR_NEWLINE, CHAR_NEWLINE);
+        advance_to(lexer, end == count ? end - 1 : end);
+        return;
+    }
 
-Token* make_token_separator() {
-    Token *token = make_token(SEPARATOR);
-    token->stringValue = get_value();
-    return token;
+    // comments can be nested
+    int level = 1;
+    int index = lexer->i + 2;
+    while (level > 0) {
+        index = scan.find_any_of3(code, index, count - 1, CHAR_SLASH, CHAR_ASTERISK, CHAR_ASTERISK);
+        if (index >= count - 1) {
+            break;
+        }
+        if (code[index] == CHAR_SLASH && code[index + 1] == CHAR_ASTERISK) {
+            level += 1;
+            index += 2;
+        } else if (code[index] == CHAR_ASTERISK && code[index + 1] == CHAR_SLASH) {
+            level -= 1;
+            index += 2;
+        } else {
+            index += 1;
+        }
+    }
+    advance_to(lexer, level == 0 ? index - 1 : count - 1);
 }
 
-bool is_next_three_quotes_after(int n) {
-    if (!(stringCount > i + 2 + n)) {
-        return false;
+// KEYWORDS / IDENTIFIERS / DIRECTIVES / BOOL LITERALS
+void lex_identifier(Lexer *lexer) {
+    int start = lexer->i;
+
+    bool is_directive = lexer->character == CHAR_POUND;
+    if (is_directive) {
+        if (!next_char(lexer) || lexer->character == 0 || lexer->character == CHAR_SPACE) {
+            fail_with_error(lexer, ERROR_EMPTY_DIRECTIVE_NAME, start, lexer->i);
+            return;
+        } else if (!is_character_class(lexer->character, CHARCLASS_LOWERCASE | CHARCLASS_UPPERCASE)
+                   && lexer->character != CHAR_UNDERSCORE)  {
+                fail_with_error(lexer, ERROR_UNEXPECTED_DIRECTIVE_NAME, start, lexer->i);
+                return;
+            }
     }
-    return code[i+n] == CHAR_QUOTE && code[i+1+n] == CHAR_QUOTE && code[i+2+n] == CHAR_QUOTE;
-}
 
-void fail_with_error(const char* message, Cursor *start, Cursor *end, int line_number) {
-    std::cout << "error occured: " << message << "\n(context: L" << line_number << ")" << endl;
-    exit(1);
-}
+    // only trailing asterisks are allowed
+    int end = scan.identifier_end(lexer->characters, lexer->i + 1, lexer->characters_count);
+    while (end < lexer->characters_count && lexer->characters[end] == CHAR_ASTERISK) {
+        end += 1;
+    }
 
-Output* lexer_analyze(char* string) {
+    char *identifier = lexer->characters + lexer->i;
+    int identifier_length = end - lexer->i;
+    advance_to(lexer, end - 1);
 
-    // initialization
-    cursor = new Cursor();
-    tokens = new Token[1024];
+    bool is_not_keyword = identifier[0] == CHAR_ACCENT
+        && identifier[identifier_length - 1] == CHAR_ACCENT
+        && identifier_length >= 3;
+    if (is_not_keyword) {
+        identifier += 1;
+        identifier_length -= 2;
+    }
 
-    cursor->line_number = 1;
+    auto accent = (char*) memchr(identifier, CHAR_ACCENT, identifier_length);
+    if (accent != NULL) {
+        int accent_offset = (int) (accent - lexer->characters);
+        fail_with_error(lexer, ERROR_UNEXPECTED_CHARACTER, accent_offset, accent_offset);
+        return;
+    }
 
-    code = string;
-    stringCount = strlen(string);
-    character = string[0];
+    Symbol symbol = interner_intern(&lexer->interner, identifier, identifier_length);
+
+    if (symbol == SYMBOL_VOID) {
+        make_token(lexer, VOIDLITERAL, start, 0); // @Todo: looks wrong
+    } else if (symbol == SYMBOL_NULL) {
+        make_token(lexer, NULLLITERAL, start, 0);
+    } else if (symbol == SYMBOL_TRUE) {
+        make_token(lexer, BOOLLITERAL, start, true);
+    } else if (symbol == SYMBOL_FALSE) {
+        make_token(lexer, BOOLLITERAL, start, false);
+    } else if (!is_not_keyword && symbol < KEYWORD_COUNT) {
+        make_token(lexer, KEYWORD, start, symbol);
+    } else if (is_directive) {
+        if (identifier_length == 0) {
+            fail_with_error(lexer, ERROR_EMPTY_DIRECTIVE_NAME, start, lexer->i);
+            return;
+        }
+        make_token(lexer, DIRECTIVE, start, symbol);
+    } else if (identifier_length == 1 && *identifier == CHAR_UNDERSCORE) {
+        fail_with_error(lexer, ERROR_INVALID_IDENTIFIER_UNDERSCORE, start, lexer->i);
+        return;
+    } else {
+        make_token(lexer, IDENTIFIER, start, symbol);
+    }
+}
 
-    while (stringCount > i) {
-        bool should_fallthrough = false;
+// NUMBER LITERALS
+// returns false if this is not a number, but a punctuator or an operator
+bool lex_number(Lexer *lexer) {
+    int start = lexer->i;
+    char *code = lexer->characters;
+    int count = lexer->characters_count;
 
-        if (character == CHAR_QUOTE) {
-            // STRING LITERAL
-            Cursor *start = copy_cursor(cursor);
+    if (!is_character_class(lexer->character, CHARCLASS_NUMBER)) {
+        char* next = peek_next(lexer);
+        if (next == NULL || !is_character_class(*next, CHARCLASS_NUMBER)) {
+            return false;
+        }
+    }
 
-            auto is_multiline = is_next_three_quotes_after(0);
-            if (is_multiline) {
-                next_char_count(3);
-                if (!consume(CHAR_NEWLINE)) {
-                    fail_with_error("newlineExpectedBeforeMultilineStringLiteral", cursor, cursor, __LINE__);
-                }
-            } else {
-                if (!next_char()) {
-                    fail_with_error("unexpectedEndOfFile", cursor, cursor, __LINE__);
-                }
+    int digits_start = lexer->character == CHAR_DASH ? start + 1 : start;
+    char prefix = digits_start + 1 < count ? code[digits_start + 1] : 0;
+    bool is_float = false;
+    int end;
+
+    if (code[digits_start] == CHAR_ZERO && (prefix == CHAR_X || prefix == CHAR_B)) {
+        // 0x1F, 0b1010
+        int base = prefix == CHAR_X ? 16 : 2;
+        int digits = 0;
+        end = digits_start + 2;
+        while (end < count && (code[end] == CHAR_UNDERSCORE || digit_value(code[end], base) != -1)) {
+            digits += code[end] != CHAR_UNDERSCORE;
+            end += 1;
+        }
+        if (digits == 0) {
+            advance_to(lexer, end - 1);
+            fail_with_error(lexer, ERROR_UNEXPECTED_CHARACTER_IN_NUMBER, end, end);
+            return true;
+        }
+    } else {
+        bool has_dot = lexer->character == CHAR_DOT;
+        int exponent = -1; // where the e is
+        int exponent_digits = 0;
+        char last = lexer->character; // underscores are skipped
+        end = start + 1;
+        while (end < count && is_character_class(code[end], CHARCLASS_NUMBER_BODY)) {
+            char next = code[end];
+            if (next == CHAR_DASH && last != CHAR_E) {
+                advance_to(lexer, end);
+                fail_with_error(lexer, ERROR_UNEXPECTED_MINUS_IN_NUMBER_LITERAL, start, lexer->i);
+                return true;
             }
-
-            value_reset();
-            while (stringCount > i) {
-                // if char == C.newline { /* @Todo: wtf is this? */ }
-
-                if (character == CHAR_BACKSLASH) {
-                    auto next = peek_next();
-                    if (next == NULL) {
-                        fail_with_error("unexpectedEndOfFile", cursor, cursor, __LINE__);
-                    }
-
-                    switch (*next) {
-                    case CHAR_ZERO: { value_append(0); break; }
-                    case CHAR_N: { value_append(CHAR_NEWLINE); break; }
-                    case CHAR_R: { value_append(CHAR_RETURN); break; }
-                    case CHAR_T: { value_append(CHAR_TAB); break; }
-                    case CHAR_BACKSLASH: { value_append(CHAR_BACKSLASH); break; }
-                    case CHAR_QUOTE: { value_append(CHAR_QUOTE); break; }
-                    default: { fail_with_error("unexpectedCharacterToEscape", cursor, cursor, __LINE__); }
-                    }
-
-                    if (!next_char() || !next_char()) {
-                        fail_with_error("unexpectedEndOfFile", cursor, cursor, __LINE__);
-                    }
-                    continue;
-                }
-
-                if (is_multiline) {
-                    if (peek_next() == NULL) {
-                        fail_with_error("unexpectedEndOfFile", cursor, cursor, __LINE__);
-                    } else if (is_next_three_quotes_after(0)) {
-                        fail_with_error("newlineExpectedAfterMultilineStringLiteral", cursor, cursor, __LINE__);
-                    } else if (character == CHAR_NEWLINE && is_next_three_quotes_after(1)) {
-                        next_char_count(4);
-
-                        auto next = peek_next();
-                        if (*next != CHAR_NEWLINE && *next != CHAR_SEMICOLON) {
-                            fail_with_error("newlineExpectedAfterMultilineStringLiteral", cursor, cursor, __LINE__);
-                        } else {
-                            auto token = make_token(STRINGLITERAL);
-                            token->stringValue = get_value();
-                            token_append(token, start, cursor);
-                            break;
-                        }
-                    }
-                } else {
-                    if (consume(CHAR_QUOTE)) { // @Note: if consume(string: [C.quote]) {
-                        auto token = make_token(STRINGLITERAL);
-                        token->stringValue = get_value();
-                        token_append(token, start, cursor);
-                        break;
-                    } else if (*peek_next() == CHAR_NEWLINE) {
-                        fail_with_error("newLineInStringLiteral", cursor, cursor, __LINE__);
-                    }
-                }
-
-                value_append(character);
-                if (!next_char()) {
-                    fail_with_error("unexpectedEndOfFile", cursor, cursor, __LINE__);
-                }
+            if (next == CHAR_DOT && (has_dot || exponent != -1)) {
+                advance_to(lexer, end);
+                fail_with_error(lexer, ERROR_UNEXPECTED_DOT_IN_FLOAT_LITERAL, start, lexer->i);
+                return true;
             }
-        } else if (character == CHAR_SEMICOLON || character == CHAR_COMMA) {
-            // SEPARATORS
-            value_reset();
-            value_append(character);
-            auto separator_token = make_token_separator();
-            token_append(separator_token, cursor, cursor);
-        } else if (character == CHAR_NEWLINE || character == CHAR_SPACE) {
-            // skip
-        } else if (
-               is_in_range(character, TOKENRANGE_LOWERCASE_MIN, TOKENRANGE_LOWERCASE_MAX)
-            || is_in_range(character, TOKENRANGE_UPPERCASE_MIN, TOKENRANGE_UPPERCASE_MAX)
-            || character == CHAR_UNDERSCORE
-            || character == CHAR_POUND 
-            || character == CHAR_ACCENT
-        ) {
-            // KEYWORDS / IDENTIFIERS / DIRECTIVES / BOOL LITERALS
-            Cursor *start = copy_cursor(cursor);
-
-            bool is_directive = consume(CHAR_POUND);
-            if (is_directive) {
-                if (!next_char() || character == 0 || character == CHAR_SPACE) {
-                    fail_with_error("emptyDirectiveName", start, cursor, __LINE__);
-                } else if (
-                       !is_in_range(character, TOKENRANGE_LOWERCASE_MIN, TOKENRANGE_LOWERCASE_MAX)
-                    && !is_in_range(character, TOKENRANGE_UPPERCASE_MIN, TOKENRANGE_UPPERCASE_MAX)
-                    && character != CHAR_UNDERSCORE
-                    )  {
-                        fail_with_error("unexpectedDirectiveName", start, cursor, __LINE__);
-                    }
+            if (next == CHAR_E && exponent != -1) {
+                advance_to(lexer, end);
+                fail_with_error(lexer, ERROR_UNEXPECTED_E_IN_FLOAT_LITERAL, start, lexer->i);
+                return true;
             }
-
-            value_reset();
-            value_append(character);
-
-            while (true) {
-                char* next = consume_next(identifier_comparator);
-                if (next == NULL) {
-                    break;
-                }
-                value_append(*next);
+            has_dot |= next == CHAR_DOT;
+            if (next == CHAR_E) {
+                exponent = end;
+            } else if (exponent != -1 && is_character_class(next, CHARCLASS_NUMBER)) {
+                exponent_digits += 1;
             }
-
-            bool is_not_keyword = value[0] == CHAR_ACCENT 
-                && last_char_of(value) == CHAR_ACCENT
-                && value_length >= 3;
-            if (is_not_keyword) {
-                char *copy = get_value_in_range(1, value_length-1);
-                value_reset();
-                value_append_string(copy);
+            if (next != CHAR_UNDERSCORE) {
+                last = next;
             }
+            end += 1;
+        }
+        if (exponent != -1 && exponent_digits == 0) {
+            advance_to(lexer, end - 1);
+            fail_with_error(lexer, ERROR_UNEXPECTED_E_IN_FLOAT_LITERAL, exponent, lexer->i);
+            return true;
+        }
+        is_float = has_dot || exponent != -1;
+    }
+    advance_to(lexer, end - 1);
 
-            int idx = index_in_value_of(CHAR_ACCENT);
-            if (idx != -1) {
-                // @Todo: add idx to cursor to 'start' to calculate the position of the unexpected symbol
-                fail_with_error("unexpectedCharacter", start, start, __LINE__);
-            }
+    if (end < count && !is_character_class(code[end], CHARCLASS_NUMBER_END)) {
+        fail_with_error(lexer, ERROR_UNEXPECTED_CHARACTER_IN_NUMBER, end, end);
+        return true;
+    }
 
-            if (string_compare(value, "void")) {
-                Token *token = make_token(VOIDLITERAL);
-                token_append(token, start, cursor); // @Todo: looks wrong
-            } else if (string_compare(value, "null\0")) {
-                Token *token = make_token(NULLLITERAL);
-                token_append(token, start, cursor);
-            } else if (string_compare(value, "true\0")) {
-                Token *token = make_token(BOOLLITERAL);
-                token->boolValue = true;
-                token_append(token, start, cursor);
-            } else if (string_compare(value, "false\0")) {
-                Token *token = make_token(BOOLLITERAL);
-                token->boolValue = false;
-                token_append(token, start, cursor);
-            } else if (is_directive) {
-                if (value == 0) {
-                    fail_with_error("emptyDirectiveName", start, cursor, __LINE__);
-                }
-                Token *token = make_token(DIRECTIVE);
-                token->stringValue = get_value();
-                token_append(token, start, cursor);
-            } else if (*value == CHAR_UNDERSCORE) {
-                fail_with_error("invalidIdentifierUnderscore", start, cursor, __LINE__);
-            } else {
-                Token *token = make_token(IDENTIFIER);
-                token->stringValue = get_value();
-                token_append(token, start, cursor);
-            }
+    if (is_float) {
+        double value;
+        if (!parse_float_literal(code + start, end - start, &value)) {
+            fail_with_error(lexer, ERROR_FLOAT_LITERAL_OVERFLOW, start, lexer->i);
+            return true;
+        }
+        make_token(lexer, FLOATLITERAL, start, token_arena_push_float(&lexer->output->tokens, value));
+    } else {
+        int64_t value;
+        if (!parse_integer_literal(code + start, end - start, &value)) {
+            fail_with_error(lexer, ERROR_INTEGER_LITERAL_OVERFLOW, start, lexer->i);
+            return true;
+        }
+        make_token(lexer, INTLITERAL, start, token_arena_push_int(&lexer->output->tokens, value));
+    }
+    return true;
+}
 
-        } else if (
-            is_in_range(character, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX)
-            || character == CHAR_DOT
-            || character == CHAR_DASH
-        ) {
-            // NUMBER LITERALS
-            Cursor *start = copy_cursor(cursor);
-
-            if (!is_in_range(character, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX)) {
-                char* next = peek_next();
-                if (next == NULL || !is_in_range(*next, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX)) {
-                    should_fallthrough = true;
-                }
-            }
+// PUNCTUATORS, OPERATORS
+void lex_punctuator_or_operator(Lexer *lexer) {
+    int start = lexer->i;
+    Operator match = match_operator(lexer->characters, lexer->i, lexer->characters_count);
+    if (match != OPERATOR_NONE) {
+        // 1 symbol is consumed at the end of the loop
+        next_char_count(lexer, operator_length(match) - 1);
+        make_token(lexer, match < OPERATOR_FIRST ? PUNCTUATOR : OPERATOR, start, match);
+    } else if (lexer->character == CHAR_SPACE || lexer->character == CHAR_NEWLINE) {
+        // no-op
+    } else if (lexer->character != 0) {
+        fail_with_error(lexer, ERROR_UNEXPECTED_CHARACTER, start, lexer->i);
+        return;
+    }
+}
 
-            if (!should_fallthrough) {
-                value_reset();
-                value_append(character);
-
-                while (true) {
-                    char* next = consume_next(number_comparator);
-                    if (next == NULL) {
-                        break;
-                    }
-                    if (value_length >= 1 && *next == CHAR_DASH && last_char_of(value) != CHAR_E) {
-                        fail_with_error("unexpectedMinusInNumberLiteral", start, cursor, __LINE__);
-                    }
-                    if (*next == CHAR_DOT && string_contains(value, CHAR_DOT)
-                        || *next == CHAR_E && string_contains(value, CHAR_E)) {
-                        if (*next == CHAR_DOT) {
-                            fail_with_error("unexpectedDotInFloatLiteral", start, cursor, __LINE__);
-                        } else {
-                            fail_with_error("unexpectedEInFloatLiteral", start, cursor, __LINE__);
-                        }
-                    }
-                    if (*next == CHAR_UNDERSCORE) {
-                        continue;
-                    }
-                    value_append(*next);
-                }
+// lexes the token at the current character, or skips whitespace and comments
+// returns false after the end of file, or when a speculative lexer has failed
+// any other lexer records the error and continues after the next separator
+bool lex_token(Lexer *lexer) {
+    char character = lexer->character;
+
+    if (character == CHAR_QUOTE) {
+        lex_string_literal(lexer);
+    } else if (is_character_class(character, CHARCLASS_SEPARATOR)) {
+        // SEPARATORS
+        make_token(lexer, SEPARATOR, lexer->i, 1);
+    } else if (is_character_class(character, CHARCLASS_WHITESPACE)) {
+        // skip
+        int end = scan.whitespace_end(lexer->characters, lexer->i, lexer->characters_count);
+        advance_to(lexer, end - 1);
+    } else if (character == CHAR_SLASH && peek_next(lexer) != NULL
+               && (*peek_next(lexer) == CHAR_SLASH || *peek_next(lexer) == CHAR_ASTERISK)) {
+        lex_comment(lexer);
+    } else if (is_character_class(character, CHARCLASS_IDENTIFIER_START)) {
+        lex_identifier(lexer);
+    } else if (is_character_class(character, CHARCLASS_NUMBER_START)) {
+        if (!lex_number(lexer)) {
+            lex_punctuator_or_operator(lexer);
+        }
+    } else {
+        lex_punctuator_or_operator(lexer);
+    }
 
-                char *next = peek_next();
-                if (next != NULL) {
-                    // @Todo: this probably doesn't work out because 
-                    // punctuators and operators are multidimentional arrays
-                    if (!( string_contains((char*) separators, *next)
-                        || string_contains((char*) punctuators, *next)
-                        || string_contains((char*) operators, *next))
-                    ) {
-                        fail_with_error("unexpectedCharacterInNumber", cursor, cursor, __LINE__);
-                    }
-                }
+    if (lexer->has_failed) {
+        if (lexer->is_speculative) {
+            return false;
+        }
+        recover_from_error(lexer);
+    }
+    if (lexer->character == 0 || !next_char(lexer)) {
+        make_token(lexer, ENDOFFILE, lexer->i, 0);
+        return false;
+    }
+    return true;
+}
 
-                if (string_compare(value, (char*) &CHAR_DASH) || only_contains_character(value, CHAR_DOT)) {
+Lexer* lexer_create() {
+    Lexer *lexer = new Lexer();
+    memset(lexer, 0, sizeof(*lexer));
+    lexer->value_capacity = 1000;
+    lexer->value = (char*) calloc(lexer->value_capacity, 1);
+    interner_init(&lexer->interner);
+    return lexer;
+}
 
-                } else if (string_contains(value, CHAR_E) || string_contains(value, CHAR_DOT)) {
-                    Token *token = make_token(FLOATLITERAL);
-                    token->doubleValue = atof(value);
-                    token_append(token, start, cursor);
-                } else {
-                    Token *token = make_token(INTLITERAL);
-                    token->intValue = atoi(value);
-                    token_append(token, start, cursor);
-                }
-            }   
-        }
+void lexer_free(Lexer *lexer) {
+    free(lexer->value);
+    interner_free(&lexer->interner);
+    delete lexer;
+}
 
-        if (should_fallthrough) {
-            // PUNCTUATORS, OPERATORS
-            Cursor *start = copy_cursor(cursor);
-
-            auto punctuator_value = consume_one_of((char*) punctuators[0]);
-            if (punctuator_value != NULL) {
-                Token *token = make_token(PUNCTUATOR);
-                token->stringValue = punctuator_value;
-                token_append(token, start, cursor);
-            } else {
-                auto operator_value = consume_one_of((char*) operators[0]);
-                if (operator_value != NULL) {
-                    Token *token = make_token(OPERATOR);
-                    token->stringValue = operator_value;
-                    token_append(token, start, cursor);
-                } else {
-                    if (character == CHAR_SPACE || CHAR_NEWLINE) {
-                        // no-op
-                    } else if (character != 0) {
-                        auto previous = copy_cursor(start);
-                        withdraw_character(previous);
-                        fail_with_error("unexpectedCharacter", previous, cursor, __LINE__);
-                    }
-                }
-            }
-        }
+// prepares the lexer to continue lexing the string from the index
+// speculative callers set is_speculative afterwards
+void lexer_start(Lexer *lexer, Output *output, char *string, int count, int index) {
+    output_make_writable(output);
+    lexer->output = output;
+    lexer->is_speculative = false;
+    lexer->characters = string;
+    lexer->characters_count = count;
+    lexer->i = index;
+    lexer->character = string[index];
+    lexer->has_failed = false;
+    lexer->error_offset = 0;
+    value_reset(lexer);
+}
+
+// the lexer can be reused for more files, symbols stay the same between them
+// the output is owned by the caller, and refers to the string and the lexer's interner
+// the string has to be followed by a few zeros, see SourceBuffer
+Output* lexer_analyze(Lexer *lexer, char* string, int count) {
+
+    // initialization
+    Output *output = output_create(string, count, &lexer->interner);
+    lexer_start(lexer, output, string, count, 0);
 
-        if (character == 0 || !next_char()) {
-            token_append(make_token(ENDOFFILE), cursor, cursor);
+    while (lexer->characters_count > lexer->i) {
+        if (!lex_token(lexer)) {
             break;
         }
     }
 
-    Output *output = new Output();
-    output->tokens = tokens;
-    output->tokens_count = tokens_count;
-    output->lines_processed = cursor->line_number;
+    output->tokens_count = output->tokens.count;
+    lexer->output = NULL;
     return output;
 }
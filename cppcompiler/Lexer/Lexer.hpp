@@ -8,16 +8,23 @@
 
 #pragma once
 #include "LexerConst.hpp"
+#include "LexerErrors.hpp"
+#include "LexerSimd.hpp"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <iostream>
+#include <functional>
+#include <limits>
+#include <algorithm>
+#include <sys/mman.h>
 
-using namespace std;
+#include "Interner.hpp"
 
-// @Todo: align bytes of these structs
+using namespace std;
 
 enum TokenType {
     IDENTIFIER, PUNCTUATOR, DIRECTIVE, OPERATOR, COMMENT, SEPARATOR,
@@ -37,35 +44,551 @@ struct Cursor {
 };
 typedef struct Cursor Cursor;
 
+// characters of a token's value, either in the source buffer,
+// or in Output::strings for string literals that had escape sequences
+struct Slice {
+    unsigned int offset;
+    unsigned int length : 31;
+    unsigned int is_materialized : 1;
+};
+typedef struct Slice Slice;
+
+// a decoded view of one token, see output_token_at
+// the cursors are resolved from the offsets only when needed, see output_cursor_at
 struct Token {
     TokenType type;
-    Cursor start;
-    Cursor end;
+    unsigned int offset; // of the first character
+    unsigned int end_offset; // of the character the lexer was at when it made the token
 
     union {
-        char *stringValue;
-        int intValue;
+        Slice stringValue;
+        Symbol symbol; // identifiers and directives
+        int64_t intValue;
         double doubleValue;
         bool boolValue;
         Keyword keyword;
     };
+    Operator operatorValue; // of punctuators and operators, their stringValue is the spelling
 };
 typedef struct Token Token;
 
+// TOKEN ARENA
+
+// Tokens are stored as parallel arrays, 13 bytes per token, so that scans over the kinds stay in cache.
+// The payload depends on the kind: the symbol, the keyword, the bool value,
+// the Operator of punctuators and operators, the length of separators (their value starts at the offset),
+// or an index into float_values or string_values for float and string literals.
+// Int literals below TOKEN_PAYLOAD_LARGE are stored as is, others in int_values.
+// The arrays are stored in chunks that double in size,
+// chunk n holds TOKEN_CHUNK_FIRST_CAPACITY << n tokens.
+// Tokens only move when lexer_relex splices them, and the whole arena is freed at once.
+const int TOKEN_CHUNK_FIRST_CAPACITY = 1024;
+const int TOKEN_CHUNK_MAX_COUNT = 22; // enough to index any int
+const int TOKEN_SIZE = 3 * sizeof(uint32_t) + sizeof(uint8_t);
+const uint32_t TOKEN_PAYLOAD_LARGE = 1u << 31;
+
+struct TokenChunk {
+    uint32_t *offsets; // the allocation of the whole chunk
+    uint32_t *end_offsets;
+    uint32_t *payloads;
+    uint8_t *kinds;
+};
+typedef struct TokenChunk TokenChunk;
+
+struct TokenArena {
+    TokenChunk chunks[TOKEN_CHUNK_MAX_COUNT];
+    int chunks_count;
+    int count;
+    int capacity;
+    int high_water_mark; // the largest count this arena has seen since its creation
+
+    double *float_values;
+    int float_values_count;
+    int float_values_capacity;
+
+    int64_t *int_values;
+    int int_values_count;
+    int int_values_capacity;
+
+    Slice *string_values;
+    int string_values_count;
+    int string_values_capacity;
+};
+typedef struct TokenArena TokenArena;
+
+int token_arena_chunk_of(int index, int *index_in_chunk) {
+    unsigned int q = (unsigned int) (index / TOKEN_CHUNK_FIRST_CAPACITY) + 1;
+    int chunk = 31 - __builtin_clz(q);
+    *index_in_chunk = index - TOKEN_CHUNK_FIRST_CAPACITY * ((1 << chunk) - 1);
+    return chunk;
+}
+
+TokenType token_arena_kind(TokenArena *arena, int index) {
+    int index_in_chunk;
+    int chunk = token_arena_chunk_of(index, &index_in_chunk);
+    return (TokenType) arena->chunks[chunk].kinds[index_in_chunk];
+}
+
+uint32_t token_arena_offset(TokenArena *arena, int index) {
+    int index_in_chunk;
+    int chunk = token_arena_chunk_of(index, &index_in_chunk);
+    return arena->chunks[chunk].offsets[index_in_chunk];
+}
+
+uint32_t token_arena_end_offset(TokenArena *arena, int index) {
+    int index_in_chunk;
+    int chunk = token_arena_chunk_of(index, &index_in_chunk);
+    return arena->chunks[chunk].end_offsets[index_in_chunk];
+}
+
+// returns the index of the token
+int token_arena_push(TokenArena *arena, TokenType kind, uint32_t offset, uint32_t end_offset, uint32_t payload) {
+    if (arena->count == arena->capacity) {
+        if (arena->chunks_count == TOKEN_CHUNK_MAX_COUNT) {
+            cout << "error occured: token arena is full" << endl;
+            exit(1);
+        }
+        int chunk_capacity = TOKEN_CHUNK_FIRST_CAPACITY << arena->chunks_count;
+        TokenChunk *chunk = &arena->chunks[arena->chunks_count];
+        chunk->offsets = (uint32_t*) malloc((size_t) chunk_capacity * TOKEN_SIZE);
+        chunk->end_offsets = chunk->offsets + chunk_capacity;
+        chunk->payloads = chunk->end_offsets + chunk_capacity;
+        chunk->kinds = (uint8_t*) (chunk->payloads + chunk_capacity);
+        arena->chunks_count += 1;
+        arena->capacity += chunk_capacity;
+    }
+
+    int index = arena->count;
+    int index_in_chunk;
+    TokenChunk *chunk = &arena->chunks[token_arena_chunk_of(index, &index_in_chunk)];
+    chunk->kinds[index_in_chunk] = (uint8_t) kind;
+    chunk->offsets[index_in_chunk] = offset;
+    chunk->end_offsets[index_in_chunk] = end_offset;
+    chunk->payloads[index_in_chunk] = payload;
+
+    arena->count += 1;
+    if (arena->count > arena->high_water_mark) {
+        arena->high_water_mark = arena->count;
+    }
+    return index;
+}
+
+// overwrites a token that is already in the arena
+void token_arena_set(TokenArena *arena, int index, TokenType kind, uint32_t offset, uint32_t end_offset, uint32_t payload) {
+    int index_in_chunk;
+    TokenChunk *chunk = &arena->chunks[token_arena_chunk_of(index, &index_in_chunk)];
+    chunk->kinds[index_in_chunk] = (uint8_t) kind;
+    chunk->offsets[index_in_chunk] = offset;
+    chunk->end_offsets[index_in_chunk] = end_offset;
+    chunk->payloads[index_in_chunk] = payload;
+}
+
+// moves the tokens in [from, from + count) to start at the index, the ranges can overlap
+// both have to be in the arena already, they are moved in runs that don't cross chunks
+void token_arena_move(TokenArena *arena, int from, int to, int count) {
+    bool is_backwards = to > from;
+    int moved = 0;
+    while (moved < count) {
+        // the first token of the run, from the end when moving backwards
+        int source = is_backwards ? from + count - moved - 1 : from + moved;
+        int destination = is_backwards ? to + count - moved - 1 : to + moved;
+        int source_index, destination_index;
+        TokenChunk *source_chunk = &arena->chunks[token_arena_chunk_of(source, &source_index)];
+        int destination_chunk_number = token_arena_chunk_of(destination, &destination_index);
+        TokenChunk *destination_chunk = &arena->chunks[destination_chunk_number];
+
+        int length = count - moved;
+        if (is_backwards) {
+            length = std::min(length, std::min(source_index, destination_index) + 1);
+            source_index -= length - 1;
+            destination_index -= length - 1;
+        } else {
+            int source_chunk_number = (int) (source_chunk - arena->chunks);
+            length = std::min(length, (TOKEN_CHUNK_FIRST_CAPACITY << source_chunk_number) - source_index);
+            length = std::min(length, (TOKEN_CHUNK_FIRST_CAPACITY << destination_chunk_number) - destination_index);
+        }
+        memmove(destination_chunk->offsets + destination_index, source_chunk->offsets + source_index,
+                length * sizeof(uint32_t));
+        memmove(destination_chunk->end_offsets + destination_index, source_chunk->end_offsets + source_index,
+                length * sizeof(uint32_t));
+        memmove(destination_chunk->payloads + destination_index, source_chunk->payloads + source_index,
+                length * sizeof(uint32_t));
+        memmove(destination_chunk->kinds + destination_index, source_chunk->kinds + source_index, length);
+        moved += length;
+    }
+}
+
+// returns the payload for a float literal
+uint32_t token_arena_push_float(TokenArena *arena, double value) {
+    if (arena->float_values_count == arena->float_values_capacity) {
+        arena->float_values_capacity = arena->float_values_capacity == 0 ? 256 : arena->float_values_capacity * 2;
+        arena->float_values = (double*) realloc(arena->float_values, arena->float_values_capacity * sizeof(double));
+    }
+    arena->float_values[arena->float_values_count] = value;
+    return arena->float_values_count++;
+}
+
+// returns the payload for an int literal
+uint32_t token_arena_push_int(TokenArena *arena, int64_t value) {
+    if (value >= 0 && value < TOKEN_PAYLOAD_LARGE) {
+        return (uint32_t) value;
+    }
+    if (arena->int_values_count == arena->int_values_capacity) {
+        arena->int_values_capacity = arena->int_values_capacity == 0 ? 256 : arena->int_values_capacity * 2;
+        arena->int_values = (int64_t*) realloc(arena->int_values, arena->int_values_capacity * sizeof(int64_t));
+    }
+    arena->int_values[arena->int_values_count] = value;
+    return TOKEN_PAYLOAD_LARGE | arena->int_values_count++;
+}
+
+int64_t token_arena_int_value(TokenArena *arena, uint32_t payload) {
+    if (payload & TOKEN_PAYLOAD_LARGE) {
+        return arena->int_values[payload & ~TOKEN_PAYLOAD_LARGE];
+    }
+    return payload;
+}
+
+// returns the payload for a string literal
+uint32_t token_arena_push_string(TokenArena *arena, Slice value) {
+    if (arena->string_values_count == arena->string_values_capacity) {
+        arena->string_values_capacity = arena->string_values_capacity == 0 ? 256 : arena->string_values_capacity * 2;
+        arena->string_values = (Slice*) realloc(arena->string_values, arena->string_values_capacity * sizeof(Slice));
+    }
+    arena->string_values[arena->string_values_count] = value;
+    return arena->string_values_count++;
+}
+
+// the counts of an arena, the tokens appended after it can be dropped with token_arena_rewind
+struct TokenArenaMark {
+    int count;
+    int float_values_count;
+    int int_values_count;
+    int string_values_count;
+};
+typedef struct TokenArenaMark TokenArenaMark;
+
+TokenArenaMark token_arena_mark(TokenArena *arena) {
+    TokenArenaMark mark;
+    mark.count = arena->count;
+    mark.float_values_count = arena->float_values_count;
+    mark.int_values_count = arena->int_values_count;
+    mark.string_values_count = arena->string_values_count;
+    return mark;
+}
+
+void token_arena_rewind(TokenArena *arena, TokenArenaMark mark) {
+    arena->count = mark.count;
+    arena->float_values_count = mark.float_values_count;
+    arena->int_values_count = mark.int_values_count;
+    arena->string_values_count = mark.string_values_count;
+}
+
+// keeps the chunks for reuse
+void token_arena_reset(TokenArena *arena) {
+    token_arena_rewind(arena, TokenArenaMark());
+}
+
+void token_arena_free(TokenArena *arena) {
+    for (int c = 0; c < arena->chunks_count; c++) {
+        free(arena->chunks[c].offsets);
+    }
+    free(arena->float_values);
+    free(arena->int_values);
+    free(arena->string_values);
+    memset(arena, 0, sizeof(*arena));
+}
+
+// STRING ARENA
+
+// holds string literal values that could not be sliced out of the source
+struct StringArena {
+    char *characters;
+    unsigned int length;
+    unsigned int capacity;
+};
+typedef struct StringArena StringArena;
+
+Slice string_arena_append(StringArena *arena, char *characters, unsigned int length) {
+    if (arena->length + length > arena->capacity) {
+        unsigned int capacity = arena->capacity == 0 ? 4096 : arena->capacity;
+        while (arena->length + length > capacity) {
+            capacity *= 2;
+        }
+        arena->characters = (char*) realloc(arena->characters, capacity);
+        arena->capacity = capacity;
+    }
+
+    memcpy(arena->characters + arena->length, characters, length);
+    Slice slice;
+    slice.offset = arena->length;
+    slice.length = length;
+    slice.is_materialized = true;
+    arena->length += length;
+    return slice;
+}
+
+void string_arena_free(StringArena *arena) {
+    free(arena->characters);
+    memset(arena, 0, sizeof(*arena));
+}
+
+// DIAGNOSTICS
+
+// an error and the characters it is about, the range is the same as a token's
+struct Diagnostic {
+    LexerError error;
+    uint32_t offset;
+    uint32_t end_offset;
+    int token; // the index of the next token, the lexer made the ones before it before the error
+};
+typedef struct Diagnostic Diagnostic;
+
+// every error of a file, in the order of the source
+struct Diagnostics {
+    Diagnostic *items;
+    int count;
+    int capacity;
+};
+typedef struct Diagnostics Diagnostics;
+
+void diagnostics_append(Diagnostics *diagnostics, Diagnostic diagnostic) {
+    if (diagnostics->count == diagnostics->capacity) {
+        diagnostics->capacity = diagnostics->capacity == 0 ? 16 : diagnostics->capacity * 2;
+        diagnostics->items = (Diagnostic*) realloc(diagnostics->items, diagnostics->capacity * sizeof(Diagnostic));
+    }
+    diagnostics->items[diagnostics->count] = diagnostic;
+    diagnostics->count += 1;
+}
+
+void diagnostics_free(Diagnostics *diagnostics) {
+    free(diagnostics->items);
+    memset(diagnostics, 0, sizeof(*diagnostics));
+}
+
+// offsets where the lines of the source start, built on the first output_cursor_at
+struct LineTable {
+    uint32_t *starts;
+    int count;
+    int capacity;
+    bool is_built;
+};
+typedef struct LineTable LineTable;
+
 struct Output {
-    int lines_processed;
     int tokens_count;
-    Token *tokens;
+    TokenArena tokens;
+    StringArena strings;
+    char *source; // managed by the caller
+    int source_length;
+    Cursor source_cursor; // of the first character, when the source is a part of the file
+    LineTable lines;
+    Diagnostics diagnostics;
+    Interner *interner; // managed by the lexer
+
+    void *mapping; // the cache file that the tokens and strings are in, see token_cache_load
+    long mapping_size;
 };
 typedef struct Output Output;
 
+Slice make_slice(unsigned int offset, unsigned int length) {
+    Slice slice;
+    slice.offset = offset;
+    slice.length = length;
+    slice.is_materialized = false;
+    return slice;
+}
+
+char* output_slice_characters(Output *output, Slice slice) {
+    if (slice.is_materialized) {
+        return output->strings.characters + slice.offset;
+    }
+    return output->source + slice.offset;
+}
+
+void print_slice(Output *output, Slice slice) {
+    cout.write(output_slice_characters(output, slice), slice.length);
+}
+
+void print_symbol(Output *output, Symbol symbol) {
+    cout.write(interner_characters(output->interner, symbol), interner_length(output->interner, symbol));
+}
+
+void line_table_reserve(LineTable *table, int count) {
+    if (table->count + count > table->capacity) {
+        int capacity = table->capacity == 0 ? 1024 : table->capacity;
+        while (table->count + count > capacity) {
+            capacity *= 2;
+        }
+        table->starts = (uint32_t*) realloc(table->starts, capacity * sizeof(uint32_t));
+        table->capacity = capacity;
+    }
+}
+
+// one pass over the source, in blocks, so that the table only grows between them
+const int LINE_TABLE_BLOCK_SIZE = 1 << 16;
+
+void line_table_build(LineTable *table, char *source, int length) {
+    table->count = 0;
+    line_table_reserve(table, 1);
+    table->starts[table->count++] = 0;
+
+    for (int from = 0; from < length; from += LINE_TABLE_BLOCK_SIZE) {
+        int to = length - from > LINE_TABLE_BLOCK_SIZE ? from + LINE_TABLE_BLOCK_SIZE : length;
+        line_table_reserve(table, to - from);
+        table->count += scan.line_starts(source, from, to, table->starts + table->count);
+    }
+    table->is_built = true;
+}
+
+// the line and the character of the offset in the source, found with a binary search
+Cursor output_cursor_at(Output *output, unsigned int offset) {
+    auto *table = &output->lines;
+    if (!table->is_built) {
+        line_table_build(table, output->source, output->source_length);
+    }
+
+    // the last line that starts at or before the offset
+    int low = 0;
+    int high = table->count - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (table->starts[middle] <= offset) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    Cursor cursor;
+    cursor.line_number = output->source_cursor.line_number + low;
+    cursor.character = offset - table->starts[low];
+    if (low == 0) {
+        cursor.character += output->source_cursor.character;
+    }
+    return cursor;
+}
+
+TokenType output_token_type(Output *output, int index) {
+    return token_arena_kind(&output->tokens, index);
+}
+
+Token output_token_at(Output *output, int index) {
+    auto *arena = &output->tokens;
+    int index_in_chunk;
+    TokenChunk *chunk = &arena->chunks[token_arena_chunk_of(index, &index_in_chunk)];
+    uint32_t payload = chunk->payloads[index_in_chunk];
+
+    Token token;
+    token.type = (TokenType) chunk->kinds[index_in_chunk];
+    token.offset = chunk->offsets[index_in_chunk];
+    token.end_offset = chunk->end_offsets[index_in_chunk];
+    switch (token.type) {
+        case IDENTIFIER: case DIRECTIVE: token.symbol = payload; break;
+        case KEYWORD: token.keyword = (Keyword) payload; break;
+        case BOOLLITERAL: token.boolValue = payload != 0; break;
+        case INTLITERAL: token.intValue = token_arena_int_value(arena, payload); break;
+        case FLOATLITERAL: token.doubleValue = arena->float_values[payload]; break;
+        case STRINGLITERAL: token.stringValue = arena->string_values[payload]; break;
+        case SEPARATOR: token.stringValue = make_slice(token.offset, payload); break;
+        case PUNCTUATOR: case OPERATOR: token.stringValue = make_slice(token.offset, operator_length((Operator) payload)); break;
+        default: token.intValue = 0;
+    }
+    token.operatorValue = token.type == PUNCTUATOR || token.type == OPERATOR ? (Operator) payload : OPERATOR_NONE;
+    return token;
+}
+
+Output* output_create(char *source, int length, Interner *interner) {
+    Output *output = new Output();
+    memset(output, 0, sizeof(*output));
+    output->source = source;
+    output->source_length = length;
+    output->source_cursor.line_number = 1;
+    output->interner = interner;
+    return output;
+}
+
+// for a source that is a part of a file, the lines are built again on demand
+void output_set_source(Output *output, char *source, int length, Cursor source_cursor) {
+    output->source = source;
+    output->source_length = length;
+    output->source_cursor = source_cursor;
+    output->lines.is_built = false;
+}
+
+// the tokens, the literal values and the strings of a loaded token cache are in its mapping, where they can't grow
+// copies them out of it, before the first change
+void output_make_writable(Output *output) {
+    if (output->mapping == NULL) {
+        return;
+    }
+    TokenArena *mapped = &output->tokens;
+    TokenArena arena;
+    memset(&arena, 0, sizeof(arena));
+    for (int t = 0; t < mapped->count; t++) {
+        int index_in_chunk;
+        TokenChunk *chunk = &mapped->chunks[token_arena_chunk_of(t, &index_in_chunk)];
+        token_arena_push(&arena, (TokenType) chunk->kinds[index_in_chunk], chunk->offsets[index_in_chunk],
+                         chunk->end_offsets[index_in_chunk], chunk->payloads[index_in_chunk]);
+    }
+    arena.float_values_count = arena.float_values_capacity = mapped->float_values_count;
+    arena.float_values = (double*) malloc(arena.float_values_capacity * sizeof(double));
+    memcpy(arena.float_values, mapped->float_values, arena.float_values_count * sizeof(double));
+    arena.int_values_count = arena.int_values_capacity = mapped->int_values_count;
+    arena.int_values = (int64_t*) malloc(arena.int_values_capacity * sizeof(int64_t));
+    memcpy(arena.int_values, mapped->int_values, arena.int_values_count * sizeof(int64_t));
+    arena.string_values_count = arena.string_values_capacity = mapped->string_values_count;
+    arena.string_values = (Slice*) malloc(arena.string_values_capacity * sizeof(Slice));
+    memcpy(arena.string_values, mapped->string_values, arena.string_values_count * sizeof(Slice));
+
+    StringArena strings;
+    memset(&strings, 0, sizeof(strings));
+    if (output->strings.length > 0) {
+        string_arena_append(&strings, output->strings.characters, output->strings.length);
+    }
+
+    munmap(output->mapping, output->mapping_size);
+    output->mapping = NULL;
+    output->mapping_size = 0;
+    output->tokens = arena;
+    output->strings = strings;
+}
+
+void output_free(Output *output) {
+    if (output->mapping != NULL) {
+        munmap(output->mapping, output->mapping_size);
+    } else {
+        token_arena_free(&output->tokens);
+        string_arena_free(&output->strings);
+    }
+    free(output->lines.starts);
+    diagnostics_free(&output->diagnostics);
+    delete output;
+}
+
+// All of the lexing state, so that files can be lexed at the same time by different lexers.
+// Create with lexer_create(), the same lexer can lex any number of files one after another.
 struct Lexer {
     char *fileName; // managed by the caller
     char *characters; // managed by the caller
+    int characters_count;
 
-    Output *output;
-    Cursor cursor;
+    Output *output; // the output of the file being lexed
     int i;
+    char character;
+
+    // the value of the current token when it's not a slice of the characters
+    char *value;
+    int value_length;
+    int value_capacity;
+
+    Interner interner; // symbols stay the same for every file lexed with this lexer
+
+    // errors stop a speculative lexer, otherwise they are added to the output's diagnostics
+    // and the lexer skips to the next separator or new line
+    bool is_speculative;
+    bool has_failed;
+    LexerError error; // the last error
+    int error_offset; // where the last error starts, see output_cursor_at
 };
 typedef struct Lexer Lexer;
 
@@ -80,29 +603,6 @@ bool only_contains_character(char* string, char character) {
     return true;
 }
 
-bool is_in_range(char character, char min, char max) {
-    return character >= min && character <= max;
-}
-
-char last_char_of(char *string) {
-    int length = strlen(string);
-    return string[length-1];
-}
-
-bool string_contains(char* string, char character) {
-    int i = 0;
-    while(true) {
-        if (string[i] == character) {
-            return true;
-        }
-        if (string[i] == 0) {
-            break;
-        }
-        i += 1;
-    }
-    return false;
-}
-
 bool string_compare(char* first, char* second) {
     int i = 0;
     while(first[i] == second[i]) {
@@ -114,101 +614,24 @@ bool string_compare(char* first, char* second) {
     return false;
 }
 
-Cursor* copy_cursor(Cursor *cursor) {
-    Cursor *copy = new Cursor();
-    copy->line_number = cursor->line_number;
-    copy->character = cursor->character;
-    return copy;
-}
-
-void withdraw_character(Cursor *cursor) {
-    cursor->character -= 1;  // @Todo: what if it's 0?
-}
-
-void advance_cursor_line(Cursor *cursor) {
-    cursor->character = 0;
-    cursor->line_number += 1;
-}
-
-void advance_cursor_characters(Cursor *cursor, int count) {
-    cursor->character += count;
-}
-
 bool token_equals(Token *lhs, Token *rhs) {
     return false;
 }
 
-char* cursor_string(Cursor cursor) {
-    char *output = (char*) malloc(10);
-    sprintf(output, "%d:%d", cursor.line_number, cursor.character);
-    return output;
+void print_diagnostic(Output *output, Diagnostic diagnostic) {
+    Cursor start = output_cursor_at(output, diagnostic.offset);
+    Cursor end = output_cursor_at(output, diagnostic.end_offset);
+    cout << "error occured: " << lexer_error_names[diagnostic.error]
+         << " at " << start.line_number << ":" << start.character << " - " << end.line_number << ":" << end.character
+         << " (" << lexer_error_messages[diagnostic.error] << ")" << endl;
 }
 
-void print_token(Token token) {
-
-    // @Todo: check runtime arguments
-    // return;
-
-    switch (token.type) {
-        case STRINGLITERAL: {
-            cout << "[String Literal \"" << token.stringValue << "\"";
-            break;
-        }
-        case SEPARATOR: {
-            cout << "[Separator " << token.stringValue;
-            break;
-        }
-        case IDENTIFIER: {
-            cout << "[Identifier " << token.stringValue;
-            break;
-        } 
-        case DIRECTIVE: {
-            cout << "[Directive " << token.stringValue;
-            break;
-        }
-        case VOIDLITERAL: {
-            cout << "[Void";
-            break;
-        }
-        case BOOLLITERAL: {
-            cout << "[Bool ";
-            if (token.boolValue) { cout << "true"; } 
-            else { cout << "false"; }
-            break;
-        }
-        case ENDOFFILE: {
-            cout << "[Token EOF";
-            break;
-        }
-        case INTLITERAL: {
-            cout << "[Literal " << token.intValue;
-            break;
-        }
-        case FLOATLITERAL: {
-            typedef std::numeric_limits< double > dbl;
-            cout.precision(dbl::max_digits10);
-            cout << "[Literal " << token.doubleValue;
-            break;
-        }
-        case OPERATOR: {
-            cout << "[Operator " << token.stringValue;
-            break;
-        }
-        case PUNCTUATOR: {
-            cout << "[Punctuator " << token.stringValue;
-            break;
-        }
-
-        // PUNCTUATOR, OPERATOR, COMMENT,
-        // NULLLITERAL, VOIDLITERAL, INTLITERAL, FLOATLITERAL, BOOLLITERAL, STRINGLITERAL, 
-        // KEYWORD, ENDOFFILE
-
-        // IDENTIFIER, PUNCTUATOR, DIRECTIVE, OPERATOR, COMMENT, SEPARATOR, NULLLITERAL, VOIDLITERAL, INTLITERAL, FLOATLITERAL, , KEYWORD, ENDOFFILE
-        default:
-            cout << "[Not implemented: Type: " << token.type;
-        break;
+void print_diagnostics(Output *output) {
+    for (int d = 0; d < output->diagnostics.count; d++) {
+        print_diagnostic(output, output->diagnostics.items[d]);
     }
-    cout << " " << cursor_string(token.start) << " - " << cursor_string(token.end) << "]" << endl;
 }
 
-Output* lexer_analyze(char* string);
\ No newline at end of file
+Lexer* lexer_create();
+void lexer_free(Lexer *lexer);
+Output* lexer_analyze(Lexer *lexer, char* string, int count);
\ No newline at end of file
@@ -0,0 +1,462 @@
+//
+//  LexerCache.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Lexer.hpp"
+
+// Saves the tokens of a file, so an unchanged file is not lexed again.
+// A cache file is the header followed by sections, every one 8 byte aligned:
+// the parallel token arrays, the literal values, the materialized strings, the diagnostics,
+// and the file's own symbol table. Symbols are renumbered in the order they are first met,
+// the same numbers a new lexer would give them.
+// Loading maps the file and points the output's arrays into it, nothing is copied
+// until the output is about to change, see output_make_writable.
+// Only the symbol payloads are renumbered in place, when the lexer already has other symbols,
+// which only copies the pages it touches.
+// Offsets and string slices refer to the source, so it is still needed, and its hash is the key.
+// Bump TOKEN_CACHE_VERSION whenever the lexer produces different tokens or the layout changes.
+
+const char TOKEN_CACHE_MAGIC[4] = { 'Y', 'W', 'T', 'C' };
+const uint32_t TOKEN_CACHE_VERSION = 2;
+
+enum TokenCacheSection {
+    SECTION_OFFSETS, SECTION_END_OFFSETS, SECTION_PAYLOADS, SECTION_KINDS,
+    SECTION_FLOAT_VALUES, SECTION_INT_VALUES, SECTION_STRING_VALUES, SECTION_STRINGS,
+    SECTION_DIAGNOSTICS, SECTION_SYMBOLS, SECTION_SYMBOL_CHARACTERS,
+    TOKEN_CACHE_SECTION_COUNT
+};
+typedef enum TokenCacheSection TokenCacheSection;
+
+struct TokenCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t source_hash;
+    uint64_t source_length;
+
+    uint32_t tokens_count;
+    uint32_t float_values_count;
+    uint32_t int_values_count;
+    uint32_t string_values_count;
+    uint32_t strings_length;
+    uint32_t diagnostics_count;
+    uint32_t symbols_count; // after the preseeded ones
+    uint32_t symbol_characters_length;
+
+    uint64_t sections[TOKEN_CACHE_SECTION_COUNT]; // offsets from the start of the file
+    uint64_t file_length;
+};
+typedef struct TokenCacheHeader TokenCacheHeader;
+
+// a symbol's characters in SECTION_SYMBOL_CHARACTERS
+struct TokenCacheSymbol {
+    uint32_t offset;
+    uint32_t length;
+};
+typedef struct TokenCacheSymbol TokenCacheSymbol;
+
+// HASHING
+
+const uint64_t XXH_PRIME_1 = 11400714785074694791ULL;
+const uint64_t XXH_PRIME_2 = 14029467366897019727ULL;
+const uint64_t XXH_PRIME_3 = 1609587929392839161ULL;
+const uint64_t XXH_PRIME_4 = 9650029242287828579ULL;
+const uint64_t XXH_PRIME_5 = 2870177450012600261ULL;
+
+inline uint64_t rotate_left(uint64_t value, int count) {
+    return (value << count) | (value >> (64 - count));
+}
+
+inline uint64_t read_u64(const char *characters) {
+    uint64_t value;
+    memcpy(&value, characters, sizeof(value));
+    return value;
+}
+
+inline uint64_t xxh64_round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * XXH_PRIME_2;
+    return rotate_left(accumulator, 31) * XXH_PRIME_1;
+}
+
+inline uint64_t xxh64_merge(uint64_t accumulator, uint64_t value) {
+    accumulator ^= xxh64_round(0, value);
+    return accumulator * XXH_PRIME_1 + XXH_PRIME_4;
+}
+
+// XXH64 with the seed 0, 32 bytes per step in four independent lanes
+uint64_t source_hash(const char *characters, long length) {
+    const char *end = characters + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        uint64_t lanes[4] = { XXH_PRIME_1 + XXH_PRIME_2, XXH_PRIME_2, 0, 0 - XXH_PRIME_1 };
+        const char *limit = end - 32;
+        do {
+            for (int l = 0; l < 4; l++) {
+                lanes[l] = xxh64_round(lanes[l], read_u64(characters + 8 * l));
+            }
+            characters += 32;
+        } while (characters <= limit);
+
+        hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7)
+            + rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+        for (int l = 0; l < 4; l++) {
+            hash = xxh64_merge(hash, lanes[l]);
+        }
+    } else {
+        hash = XXH_PRIME_5;
+    }
+    hash += (uint64_t) length;
+
+    for (; characters + 8 <= end; characters += 8) {
+        hash ^= xxh64_round(0, read_u64(characters));
+        hash = rotate_left(hash, 27) * XXH_PRIME_1 + XXH_PRIME_4;
+    }
+    if (characters + 4 <= end) {
+        uint32_t value;
+        memcpy(&value, characters, sizeof(value));
+        hash ^= (uint64_t) value * XXH_PRIME_1;
+        hash = rotate_left(hash, 23) * XXH_PRIME_2 + XXH_PRIME_3;
+        characters += 4;
+    }
+    for (; characters < end; characters++) {
+        hash ^= (uint64_t) (unsigned char) *characters * XXH_PRIME_5;
+        hash = rotate_left(hash, 11) * XXH_PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// where the cache of a source with the hash is kept in the directory
+void token_cache_path(char *path, int capacity, const char *directory, uint64_t hash) {
+    snprintf(path, capacity, "%s/%016llx.ywtc", directory, (unsigned long long) hash);
+}
+
+// WRITING
+
+// sections in the order of TokenCacheSection, each padded to 8 bytes
+struct TokenCacheWriter {
+    FILE *file;
+    uint64_t length;
+    bool has_failed;
+};
+typedef struct TokenCacheWriter TokenCacheWriter;
+
+void token_cache_write_bytes(TokenCacheWriter *writer, const void *bytes, uint64_t count) {
+    if (count > 0 && fwrite(bytes, 1, count, writer->file) != count) {
+        writer->has_failed = true;
+    }
+    writer->length += count;
+}
+
+// returns the offset of the section
+uint64_t token_cache_begin_section(TokenCacheWriter *writer) {
+    const char zeros[8] = {};
+    token_cache_write_bytes(writer, zeros, (8 - writer->length % 8) % 8);
+    return writer->length;
+}
+
+// writes the token arrays chunk by chunk, so they are contiguous in the file
+void token_cache_write_tokens(TokenCacheWriter *writer, TokenArena *arena, TokenCacheSection section,
+                              uint32_t *payloads) {
+    for (int start = 0, c = 0; start < arena->count; c++) {
+        int count = TOKEN_CHUNK_FIRST_CAPACITY << c;
+        if (start + count > arena->count) {
+            count = arena->count - start;
+        }
+        TokenChunk *chunk = &arena->chunks[c];
+        switch (section) {
+            case SECTION_OFFSETS: token_cache_write_bytes(writer, chunk->offsets, count * sizeof(uint32_t)); break;
+            case SECTION_END_OFFSETS: token_cache_write_bytes(writer, chunk->end_offsets, count * sizeof(uint32_t)); break;
+            case SECTION_PAYLOADS: token_cache_write_bytes(writer, payloads + start, count * sizeof(uint32_t)); break;
+            case SECTION_KINDS: token_cache_write_bytes(writer, chunk->kinds, count); break;
+            default: break;
+        }
+        start += count;
+    }
+}
+
+// writes to a temporary file that is renamed, so a reader never sees a partial cache
+// returns false if the file could not be written
+bool token_cache_write(Output *output, const char *path, uint64_t hash) {
+    auto *arena = &output->tokens;
+    auto *interner = output->interner;
+
+    // the payloads, with the file's own symbol numbers
+    const Symbol SYMBOL_UNMAPPED = std::numeric_limits<Symbol>::max();
+    Symbol *symbols = (Symbol*) malloc(interner->strings_count * sizeof(Symbol));
+    for (Symbol s = 0; s < interner->strings_count; s++) {
+        symbols[s] = s < SYMBOL_PRESEEDED_COUNT ? s : SYMBOL_UNMAPPED;
+    }
+    Symbol *used = (Symbol*) malloc(interner->strings_count * sizeof(Symbol)); // in the cache's order
+    uint32_t used_count = 0;
+    uint32_t symbol_characters_length = 0;
+
+    uint32_t *payloads = (uint32_t*) malloc((arena->count > 0 ? arena->count : 1) * sizeof(uint32_t));
+    for (int t = 0; t < arena->count; t++) {
+        int index_in_chunk;
+        TokenChunk *chunk = &arena->chunks[token_arena_chunk_of(t, &index_in_chunk)];
+        uint32_t payload = chunk->payloads[index_in_chunk];
+        auto type = (TokenType) chunk->kinds[index_in_chunk];
+        if (type == IDENTIFIER || type == DIRECTIVE) {
+            if (symbols[payload] == SYMBOL_UNMAPPED) {
+                symbols[payload] = SYMBOL_PRESEEDED_COUNT + used_count;
+                used[used_count++] = payload;
+                symbol_characters_length += interner_length(interner, payload);
+            }
+            payload = symbols[payload];
+        }
+        payloads[t] = payload;
+    }
+
+    // a unique name, files with the same content have the same path and can be written by two workers at once
+    char temporary_path[4096];
+    snprintf(temporary_path, sizeof(temporary_path), "%s.XXXXXX", path);
+    TokenCacheWriter writer;
+    memset(&writer, 0, sizeof(writer));
+    int descriptor = mkstemp(temporary_path);
+    if (descriptor >= 0) {
+        fchmod(descriptor, 0644); // mkstemp makes it private
+        writer.file = fdopen(descriptor, "wb");
+        if (writer.file == NULL) {
+            close(descriptor);
+            remove(temporary_path);
+        }
+    }
+
+    if (writer.file != NULL) {
+        TokenCacheHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TOKEN_CACHE_MAGIC, sizeof(header.magic));
+        header.version = TOKEN_CACHE_VERSION;
+        header.source_hash = hash;
+        header.source_length = output->source_length;
+        header.tokens_count = arena->count;
+        header.float_values_count = arena->float_values_count;
+        header.int_values_count = arena->int_values_count;
+        header.string_values_count = arena->string_values_count;
+        header.strings_length = output->strings.length;
+        header.diagnostics_count = output->diagnostics.count;
+        header.symbols_count = used_count;
+        header.symbol_characters_length = symbol_characters_length;
+        token_cache_write_bytes(&writer, &header, sizeof(header));
+
+        for (int s = SECTION_OFFSETS; s <= SECTION_KINDS; s++) {
+            header.sections[s] = token_cache_begin_section(&writer);
+            token_cache_write_tokens(&writer, arena, (TokenCacheSection) s, payloads);
+        }
+        header.sections[SECTION_FLOAT_VALUES] = token_cache_begin_section(&writer);
+        token_cache_write_bytes(&writer, arena->float_values, arena->float_values_count * sizeof(double));
+        header.sections[SECTION_INT_VALUES] = token_cache_begin_section(&writer);
+        token_cache_write_bytes(&writer, arena->int_values, arena->int_values_count * sizeof(int64_t));
+        header.sections[SECTION_STRING_VALUES] = token_cache_begin_section(&writer);
+        token_cache_write_bytes(&writer, arena->string_values, arena->string_values_count * sizeof(Slice));
+        header.sections[SECTION_STRINGS] = token_cache_begin_section(&writer);
+        token_cache_write_bytes(&writer, output->strings.characters, output->strings.length);
+        header.sections[SECTION_DIAGNOSTICS] = token_cache_begin_section(&writer);
+        token_cache_write_bytes(&writer, output->diagnostics.items, output->diagnostics.count * sizeof(Diagnostic));
+
+        header.sections[SECTION_SYMBOLS] = token_cache_begin_section(&writer);
+        uint32_t offset = 0;
+        for (uint32_t s = 0; s < used_count; s++) {
+            TokenCacheSymbol symbol;
+            symbol.offset = offset;
+            symbol.length = interner_length(interner, used[s]);
+            token_cache_write_bytes(&writer, &symbol, sizeof(symbol));
+            offset += symbol.length;
+        }
+        header.sections[SECTION_SYMBOL_CHARACTERS] = token_cache_begin_section(&writer);
+        for (uint32_t s = 0; s < used_count; s++) {
+            token_cache_write_bytes(&writer, interner_characters(interner, used[s]), interner_length(interner, used[s]));
+        }
+        header.file_length = writer.length;
+
+        // the offsets are only known now
+        if (fseek(writer.file, 0, SEEK_SET) != 0) {
+            writer.has_failed = true;
+        }
+        token_cache_write_bytes(&writer, &header, sizeof(header));
+        writer.has_failed |= fclose(writer.file) != 0;
+        writer.has_failed |= rename(temporary_path, path) != 0;
+        if (writer.has_failed) {
+            remove(temporary_path);
+        }
+    }
+
+    free(payloads);
+    free(used);
+    free(symbols);
+    return writer.file != NULL && !writer.has_failed;
+}
+
+// LOADING
+
+// the section's data, if it holds the count of items and is in the file
+void* token_cache_section(char *mapping, TokenCacheHeader *header, TokenCacheSection section,
+                          uint64_t count, uint64_t item_size) {
+    uint64_t offset = header->sections[section];
+    if (offset % 8 != 0 || offset < sizeof(TokenCacheHeader) || offset > header->file_length
+        || count * item_size > header->file_length - offset) {
+        return NULL;
+    }
+    return mapping + offset;
+}
+
+// returns NULL if there is no cache for the source, or it is from a different version
+// the output's tokens are in the mapping, lexer_start and lexer_relex copy them out before they change them
+Output* token_cache_load(Lexer *lexer, const char *path, char *source, long length, uint64_t hash) {
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < (off_t) sizeof(TokenCacheHeader)) {
+        close(descriptor);
+        return NULL;
+    }
+    long mapping_size = info.st_size;
+    // private and writable, so symbols can be renumbered without changing the file
+    void *region = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (region == MAP_FAILED) {
+        return NULL;
+    }
+
+    char *mapping = (char*) region;
+    auto *header = (TokenCacheHeader*) mapping;
+    bool is_valid = memcmp(header->magic, TOKEN_CACHE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == TOKEN_CACHE_VERSION
+        && header->source_hash == hash
+        && header->source_length == (uint64_t) length
+        && header->file_length == (uint64_t) mapping_size;
+
+    uint32_t count = header->tokens_count;
+    void *sections[TOKEN_CACHE_SECTION_COUNT] = {};
+    if (is_valid) {
+        const uint64_t counts[TOKEN_CACHE_SECTION_COUNT] = {
+            count, count, count, count,
+            header->float_values_count, header->int_values_count, header->string_values_count,
+            header->strings_length, header->diagnostics_count,
+            header->symbols_count, header->symbol_characters_length
+        };
+        const uint64_t item_sizes[TOKEN_CACHE_SECTION_COUNT] = {
+            sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint8_t),
+            sizeof(double), sizeof(int64_t), sizeof(Slice), sizeof(char), sizeof(Diagnostic),
+            sizeof(TokenCacheSymbol), sizeof(char)
+        };
+        for (int s = 0; s < TOKEN_CACHE_SECTION_COUNT && is_valid; s++) {
+            sections[s] = token_cache_section(mapping, header, (TokenCacheSection) s, counts[s], item_sizes[s]);
+            is_valid = sections[s] != NULL;
+        }
+    }
+    if (!is_valid) {
+        munmap(region, mapping_size);
+        return NULL;
+    }
+
+    // the header can be right while the rest is damaged, so everything that is used as an index is checked
+    // before any symbol is interned, a rejected cache must not leave its names in the lexer
+    auto *cache_symbols = (TokenCacheSymbol*) sections[SECTION_SYMBOLS];
+    auto *symbol_characters = (char*) sections[SECTION_SYMBOL_CHARACTERS];
+    for (uint32_t s = 0; s < header->symbols_count && is_valid; s++) {
+        is_valid = cache_symbols[s].offset <= header->symbol_characters_length
+            && cache_symbols[s].length <= header->symbol_characters_length - cache_symbols[s].offset;
+    }
+    auto *offsets = (uint32_t*) sections[SECTION_OFFSETS];
+    auto *end_offsets = (uint32_t*) sections[SECTION_END_OFFSETS];
+    auto *kinds = (uint8_t*) sections[SECTION_KINDS];
+    auto *payloads = (uint32_t*) sections[SECTION_PAYLOADS];
+    // the end of file token can be one after the last character, when the lexer stepped over the end looking for a new line
+    long last_offset = length + 1;
+    for (uint32_t t = 0; t < count && is_valid; t++) {
+        uint32_t payload = payloads[t];
+        is_valid = offsets[t] <= last_offset && end_offsets[t] <= last_offset;
+        switch (kinds[t]) {
+            case IDENTIFIER: case DIRECTIVE: is_valid &= payload < SYMBOL_PRESEEDED_COUNT + header->symbols_count; break;
+            case PUNCTUATOR: case OPERATOR: is_valid &= payload < OPERATOR_COUNT; break;
+            case KEYWORD: is_valid &= payload < KEYWORD_COUNT; break;
+            case SEPARATOR: is_valid &= payload <= length - offsets[t]; break;
+            case FLOATLITERAL: is_valid &= payload < header->float_values_count; break;
+            case STRINGLITERAL: is_valid &= payload < header->string_values_count; break;
+            case INTLITERAL:
+                is_valid &= !(payload & TOKEN_PAYLOAD_LARGE)
+                    || (payload & ~TOKEN_PAYLOAD_LARGE) < header->int_values_count;
+                break;
+            default: is_valid &= kinds[t] <= ENDOFFILE;
+        }
+    }
+    auto *string_values = (Slice*) sections[SECTION_STRING_VALUES];
+    for (uint32_t s = 0; s < header->string_values_count && is_valid; s++) {
+        uint64_t characters_length = string_values[s].is_materialized ? header->strings_length : length;
+        is_valid = (uint64_t) string_values[s].offset + string_values[s].length <= characters_length;
+    }
+    auto *diagnostics = (Diagnostic*) sections[SECTION_DIAGNOSTICS];
+    for (uint32_t d = 0; d < header->diagnostics_count; d++) {
+        is_valid &= diagnostics[d].error >= 0 && diagnostics[d].error < LEXER_ERROR_COUNT
+            && diagnostics[d].token >= 0 && diagnostics[d].token <= (int) count
+            && diagnostics[d].offset <= last_offset && diagnostics[d].end_offset <= last_offset;
+    }
+    if (!is_valid) {
+        munmap(region, mapping_size);
+        return NULL;
+    }
+
+    // the file's symbols in the lexer's interner, usually the same numbers for the first file
+    Symbol *symbols = (Symbol*) malloc((header->symbols_count + 1) * sizeof(Symbol));
+    bool is_renumbered = false;
+    for (uint32_t s = 0; s < header->symbols_count; s++) {
+        symbols[s] = interner_intern(&lexer->interner, symbol_characters + cache_symbols[s].offset,
+                                     cache_symbols[s].length);
+        is_renumbered |= symbols[s] != SYMBOL_PRESEEDED_COUNT + s;
+    }
+    for (uint32_t t = 0; t < count && is_renumbered; t++) {
+        if ((kinds[t] == IDENTIFIER || kinds[t] == DIRECTIVE) && payloads[t] >= SYMBOL_PRESEEDED_COUNT) {
+            payloads[t] = symbols[payloads[t] - SYMBOL_PRESEEDED_COUNT];
+        }
+    }
+    free(symbols);
+
+    Output *output = output_create(source, (int) length, &lexer->interner);
+    output->mapping = region;
+    output->mapping_size = mapping_size;
+
+    // the chunks point into the arrays, at the first token they would hold
+    auto *arena = &output->tokens;
+    for (int start = 0; start < (int) count; start += TOKEN_CHUNK_FIRST_CAPACITY << arena->chunks_count++) {
+        TokenChunk *chunk = &arena->chunks[arena->chunks_count];
+        chunk->offsets = (uint32_t*) sections[SECTION_OFFSETS] + start;
+        chunk->end_offsets = (uint32_t*) sections[SECTION_END_OFFSETS] + start;
+        chunk->payloads = payloads + start;
+        chunk->kinds = kinds + start;
+    }
+    arena->count = count;
+    arena->capacity = count;
+    arena->high_water_mark = count;
+    arena->float_values = (double*) sections[SECTION_FLOAT_VALUES];
+    arena->float_values_count = arena->float_values_capacity = header->float_values_count;
+    arena->int_values = (int64_t*) sections[SECTION_INT_VALUES];
+    arena->int_values_count = arena->int_values_capacity = header->int_values_count;
+    arena->string_values = (Slice*) sections[SECTION_STRING_VALUES];
+    arena->string_values_count = arena->string_values_capacity = header->string_values_count;
+    output->strings.characters = (char*) sections[SECTION_STRINGS];
+    output->strings.length = output->strings.capacity = header->strings_length;
+    output->tokens_count = count;
+
+    for (uint32_t d = 0; d < header->diagnostics_count; d++) {
+        diagnostics_append(&output->diagnostics, diagnostics[d]);
+    }
+    return output;
+}
@@ -6,6 +6,8 @@
 //  Copyright © 2020 Yaroslav Erokhin. All rights reserved.
 //
 
+#pragma once
+
 const char CHAR_NEWLINE = 10; // \n
 const char CHAR_RETURN = 13; // \r
 const char CHAR_TAB = 9; // \t
@@ -21,12 +23,14 @@ const char CHAR_POUND = 35; // #
 const char CHAR_UNDERSCORE = 95; // _
 const char CHAR_DASH = 45; // -
 const char CHAR_ACCENT = 96; // `
-const char CHAR_ASTERISK = 42; // `
-const char CHAR_ZERO = 42; // 0
+const char CHAR_ASTERISK = 42; // *
+const char CHAR_ZERO = 48; // 0
+const char CHAR_B = 98; // b
 const char CHAR_E = 101; // e
 const char CHAR_N = 110; // n
 const char CHAR_R = 114; // r
 const char CHAR_T = 116; // t
+const char CHAR_X = 120; // x
 const char CHAR_SLASH_ASTERISK[2] = {CHAR_SLASH, CHAR_ASTERISK};
 const char CHAR_ASTERISK_SLASH[2] = {CHAR_ASTERISK, CHAR_SLASH};
 const char CHAR_VOID[4] = {118, 111, 105, 100};
@@ -34,41 +38,172 @@ const char CHAR_NULL[4] = {110, 117, 108, 108};
 const char CHAR_TRUE[4] = {116, 114, 117, 101};
 const char CHAR_FALSE[5] = {102, 97, 108, 115, 101};
 
-const char punctuators[11][3] = {
-    {CHAR_DOT, CHAR_DOT, CHAR_DOT},
-    {CHAR_DOT, 0, 0},
-    {CHAR_COLON, 0, 0},
-    // "(", ")", "{", "}", "[", "]", "->"
-    {40, 0, 0},
-    {41, 0, 0},
-    {123, 0, 0},
-    {125, 0, 0},
-    {91, 0, 0},
-    {93, 0, 0},
-    {45, 62, 0},
-    {0, 0, 0}
+// PUNCTUATORS, OPERATORS
+
+// punctuators come first, then operators
+enum Operator {
+    OPERATOR_NONE,
+    PUNCTUATOR_ELLIPSIS, PUNCTUATOR_DOT, PUNCTUATOR_COLON, PUNCTUATOR_PAREN_OPEN, PUNCTUATOR_PAREN_CLOSE,
+    PUNCTUATOR_BRACE_OPEN, PUNCTUATOR_BRACE_CLOSE, PUNCTUATOR_BRACKET_OPEN, PUNCTUATOR_BRACKET_CLOSE, PUNCTUATOR_ARROW,
+    OPERATOR_COLON_EQUAL, OPERATOR_EQUAL_EQUAL, OPERATOR_NOT_EQUAL, OPERATOR_LESS_EQUAL, OPERATOR_GREATER_EQUAL,
+    OPERATOR_AND, OPERATOR_OR, OPERATOR_GREATER, OPERATOR_LESS,
+    OPERATOR_PLUS_EQUAL, OPERATOR_MINUS_EQUAL, OPERATOR_ASTERISK_EQUAL, OPERATOR_SLASH_EQUAL, OPERATOR_PERCENT_EQUAL,
+    OPERATOR_CARET_EQUAL, OPERATOR_SHIFT_RIGHT, OPERATOR_SHIFT_LEFT, OPERATOR_SHIFT_RIGHT_EQUAL, OPERATOR_SHIFT_LEFT_EQUAL,
+    OPERATOR_MINUS, OPERATOR_PLUS, OPERATOR_SLASH, OPERATOR_AMPERSAND, OPERATOR_ASTERISK, OPERATOR_PERCENT,
+    OPERATOR_RANGE, OPERATOR_EQUAL,
+    OPERATOR_COUNT
 };
+typedef enum Operator Operator;
+
+const Operator OPERATOR_FIRST = OPERATOR_COLON_EQUAL;
 
-const char operators[28][3] = {
-    //    ":=", "==", "!=", "<=", ">=", "&&", "||", ">", "<",
-    //    "+=", "-=", "*=", "/=", "%=","^=", ">>", "<<", ">>=", "<<=",
-    //    "-", "+", "/", "&", "*", "%", "..", "="
-    {58, 61, 0}, {61, 61, 0}, {33, 61, 0}, {60, 61, 0}, {62, 61, 0}, {38, 38, 0}, {124, 124, 0}, {62, 0, 0}, {60, 0, 0},
-    {43, 61, 0}, {45, 61, 0}, {42, 61, 0}, {47, 61, 0}, {37, 61, 0}, {94, 61, 0}, {62, 62, 0}, {60, 60, 0},
-    {62, 62, 61}, {60, 60, 61}, {45, 0, 0}, {43, 0, 0}, {47, 0, 0}, {38, 0, 0}, {42, 0, 0},
-    {37, 0, 0}, {46, 46, 0}, {61, 0, 0},
-    {0, 0, 0}
+constexpr char operator_spellings[OPERATOR_COUNT][4] = {
+    "",
+    "...", ".", ":", "(", ")", "{", "}", "[", "]", "->",
+    ":=", "==", "!=", "<=", ">=", "&&", "||", ">", "<",
+    "+=", "-=", "*=", "/=", "%=", "^=", ">>", "<<", ">>=", "<<=",
+    "-", "+", "/", "&", "*", "%", "..", "="
 };
 
-const char separators[5] = {
+constexpr int operator_length(Operator op) {
+    return op == OPERATOR_NONE ? 0 : operator_spellings[op][1] == 0 ? 1 : operator_spellings[op][2] == 0 ? 2 : 3;
+}
+
+constexpr char separators[5] = {
     CHAR_NEWLINE, CHAR_SPACE, CHAR_SEMICOLON, CHAR_COMMA
 };
 
-const char TOKENRANGE_LOWERCASE_MIN = 97;
-const char TOKENRANGE_LOWERCASE_MAX = 122;
+constexpr char TOKENRANGE_LOWERCASE_MIN = 97;
+constexpr char TOKENRANGE_LOWERCASE_MAX = 122;
+
+constexpr char TOKENRANGE_UPPERCASE_MIN = 65;
+constexpr char TOKENRANGE_UPPERCASE_MAX = 90;
+
+constexpr char TOKENRANGE_NUMBER_MIN = 48;
+constexpr char TOKENRANGE_NUMBER_MAX = 57;
+
+// CHARACTER CLASSES
+
+const unsigned short CHARCLASS_LOWERCASE = 1 << 0;
+const unsigned short CHARCLASS_UPPERCASE = 1 << 1;
+const unsigned short CHARCLASS_NUMBER = 1 << 2;
+const unsigned short CHARCLASS_IDENTIFIER_START = 1 << 3; // letters, _, # and `
+const unsigned short CHARCLASS_IDENTIFIER_BODY = 1 << 4; // letters, numbers, _ and `, trailing * are handled separately
+const unsigned short CHARCLASS_NUMBER_START = 1 << 5; // numbers, . and -
+const unsigned short CHARCLASS_NUMBER_BODY = 1 << 6; // numbers, _, ., e and -
+const unsigned short CHARCLASS_WHITESPACE = 1 << 7;
+const unsigned short CHARCLASS_SEPARATOR = 1 << 8; // ; and ,
+const unsigned short CHARCLASS_NUMBER_END = 1 << 9; // single character separators, punctuators and operators
+
+struct CharacterClasses {
+    unsigned short classes[256];
+};
+
+constexpr CharacterClasses make_character_classes() {
+    CharacterClasses table = {};
+
+    for (int c = TOKENRANGE_LOWERCASE_MIN; c <= TOKENRANGE_LOWERCASE_MAX; c++) {
+        table.classes[c] |= CHARCLASS_LOWERCASE | CHARCLASS_IDENTIFIER_START | CHARCLASS_IDENTIFIER_BODY;
+    }
+    for (int c = TOKENRANGE_UPPERCASE_MIN; c <= TOKENRANGE_UPPERCASE_MAX; c++) {
+        table.classes[c] |= CHARCLASS_UPPERCASE | CHARCLASS_IDENTIFIER_START | CHARCLASS_IDENTIFIER_BODY;
+    }
+    for (int c = TOKENRANGE_NUMBER_MIN; c <= TOKENRANGE_NUMBER_MAX; c++) {
+        table.classes[c] |= CHARCLASS_NUMBER | CHARCLASS_IDENTIFIER_BODY | CHARCLASS_NUMBER_START | CHARCLASS_NUMBER_BODY;
+    }
+
+    table.classes[(unsigned char) CHAR_UNDERSCORE] |= CHARCLASS_IDENTIFIER_START | CHARCLASS_IDENTIFIER_BODY
+        | CHARCLASS_NUMBER_BODY;
+    table.classes[(unsigned char) CHAR_ACCENT] |= CHARCLASS_IDENTIFIER_START | CHARCLASS_IDENTIFIER_BODY;
+    table.classes[(unsigned char) CHAR_POUND] |= CHARCLASS_IDENTIFIER_START;
+    table.classes[(unsigned char) CHAR_DOT] |= CHARCLASS_NUMBER_START | CHARCLASS_NUMBER_BODY;
+    table.classes[(unsigned char) CHAR_DASH] |= CHARCLASS_NUMBER_START | CHARCLASS_NUMBER_BODY;
+    table.classes[(unsigned char) CHAR_E] |= CHARCLASS_NUMBER_BODY;
+
+    table.classes[(unsigned char) CHAR_SPACE] |= CHARCLASS_WHITESPACE;
+    table.classes[(unsigned char) CHAR_NEWLINE] |= CHARCLASS_WHITESPACE;
+    table.classes[(unsigned char) CHAR_SEMICOLON] |= CHARCLASS_SEPARATOR;
+    table.classes[(unsigned char) CHAR_COMMA] |= CHARCLASS_SEPARATOR;
+
+    // a number literal can only be followed by a single character token
+    for (int s = 0; s < 5; s++) {
+        table.classes[(unsigned char) separators[s]] |= CHARCLASS_NUMBER_END;
+    }
+    for (int o = OPERATOR_NONE + 1; o < OPERATOR_COUNT; o++) {
+        if (operator_length((Operator) o) == 1) {
+            table.classes[(unsigned char) operator_spellings[o][0]] |= CHARCLASS_NUMBER_END;
+        }
+    }
+    return table;
+}
+
+constexpr CharacterClasses character_classes = make_character_classes();
+
+inline unsigned short character_class(char character) {
+    return character_classes.classes[(unsigned char) character];
+}
+
+inline bool is_character_class(char character, unsigned short character_class_mask) {
+    return (character_classes.classes[(unsigned char) character] & character_class_mask) != 0;
+}
+
+// OPERATOR DFA
+
+// A trie of the operator spellings, which is the DFA for matching them.
+// Characters are first mapped to columns, so that a state only has a column for every operator character.
+// The longest match wins, so ".." is never two dots, and ">>=" is never ">" and ">=".
+const int OPERATOR_DFA_STATES = 64;
+const int OPERATOR_DFA_COLUMNS = 32;
+const unsigned char OPERATOR_DFA_DEAD = 0;
+const unsigned char OPERATOR_DFA_START = 1;
+
+struct OperatorDfa {
+    unsigned char columns[256]; // 0 for characters that are not in any operator
+    unsigned char transitions[OPERATOR_DFA_STATES][OPERATOR_DFA_COLUMNS];
+    unsigned char accepts[OPERATOR_DFA_STATES]; // the operator that ends in the state
+    int states_count;
+    int columns_count;
+};
+
+constexpr OperatorDfa make_operator_dfa() {
+    OperatorDfa dfa = {};
+    dfa.states_count = 2;
+    dfa.columns_count = 1;
+
+    for (int o = OPERATOR_NONE + 1; o < OPERATOR_COUNT; o++) {
+        unsigned char state = OPERATOR_DFA_START;
+        for (int c = 0; operator_spellings[o][c] != 0; c++) {
+            auto character = (unsigned char) operator_spellings[o][c];
+            if (dfa.columns[character] == 0) {
+                dfa.columns[character] = dfa.columns_count++;
+            }
+            unsigned char &next = dfa.transitions[state][dfa.columns[character]];
+            if (next == OPERATOR_DFA_DEAD) {
+                next = dfa.states_count++;
+            }
+            state = next;
+        }
+        dfa.accepts[state] = o;
+    }
+    return dfa;
+}
 
-const char TOKENRANGE_UPPERCASE_MIN = 65;
-const char TOKENRANGE_UPPERCASE_MAX = 90;
+constexpr OperatorDfa operator_dfa = make_operator_dfa();
+static_assert(operator_dfa.states_count <= OPERATOR_DFA_STATES, "operator dfa needs more states");
+static_assert(operator_dfa.columns_count <= OPERATOR_DFA_COLUMNS, "operator dfa needs more columns");
 
-const char TOKENRANGE_NUMBER_MIN = 48;
-const char TOKENRANGE_NUMBER_MAX = 57;
\ No newline at end of file
+// the longest punctuator or operator that starts at the index, or OPERATOR_NONE
+inline Operator match_operator(const char *code, int index, int count) {
+    Operator match = OPERATOR_NONE;
+    unsigned char state = OPERATOR_DFA_START;
+    for (; index < count; index++) {
+        state = operator_dfa.transitions[state][operator_dfa.columns[(unsigned char) code[index]]];
+        if (state == OPERATOR_DFA_DEAD) {
+            break;
+        }
+        if (operator_dfa.accepts[state] != OPERATOR_NONE) {
+            match = (Operator) operator_dfa.accepts[state];
+        }
+    }
+    return match;
+}
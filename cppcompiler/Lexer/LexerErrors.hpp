@@ -0,0 +1,70 @@
+//
+//  LexerErrors.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+// the same cases as LexerError.Message in the Swift lexer, and the ones only the C++ lexer has
+enum LexerError {
+    ERROR_UNEXPECTED_MINUS_IN_NUMBER_LITERAL,
+    ERROR_UNEXPECTED_DOT_IN_FLOAT_LITERAL,
+    ERROR_UNEXPECTED_E_IN_FLOAT_LITERAL,
+    ERROR_NEW_LINE_IN_STRING_LITERAL,
+    ERROR_UNEXPECTED_END_OF_FILE,
+    ERROR_UNEXPECTED_CHARACTER_TO_ESCAPE,
+    ERROR_NEWLINE_EXPECTED_BEFORE_MULTILINE_STRING_LITERAL,
+    ERROR_NEWLINE_EXPECTED_AFTER_MULTILINE_STRING_LITERAL,
+    ERROR_EMPTY_DIRECTIVE_NAME,
+    ERROR_UNEXPECTED_DIRECTIVE_NAME,
+    ERROR_UNEXPECTED_CHARACTER_IN_NUMBER,
+    ERROR_UNEXPECTED_CHARACTER,
+    ERROR_NON_ASCII_CHARACTER,
+    ERROR_INVALID_IDENTIFIER_UNDERSCORE,
+    ERROR_INTEGER_LITERAL_OVERFLOW,
+    ERROR_FLOAT_LITERAL_OVERFLOW,
+    LEXER_ERROR_COUNT
+};
+typedef enum LexerError LexerError;
+
+// the names of the Swift cases, which the tests use
+const char* const lexer_error_names[LEXER_ERROR_COUNT] = {
+    "unexpectedMinusInNumberLiteral",
+    "unexpectedDotInFloatLiteral",
+    "unexpectedEInFloatLiteral",
+    "newLineInStringLiteral",
+    "unexpectedEndOfFile",
+    "unexpectedCharacterToEscape",
+    "newlineExpectedBeforeMultilineStringLiteral",
+    "newlineExpectedAfterMultilineStringLiteral",
+    "emptyDirectiveName",
+    "unexpectedDirectiveName",
+    "unexpectedCharacterInNumber",
+    "unexpectedCharacter",
+    "nonASCIICharacter",
+    "invalidIdentifierUnderscore",
+    "integerLiteralOverflow",
+    "floatLiteralOverflow"
+};
+
+const char* const lexer_error_messages[LEXER_ERROR_COUNT] = {
+    "Unexpected '-' in the middle of a number literal.",
+    "Only a single '.' is expected in a float literal.",
+    "Only a single 'e' is expected in a float literal.",
+    "String literal is not terminated before a new line.",
+    "Unexpected end of file.",
+    "Unexpected character to escape in a string literal.",
+    "Multiline string literal is expected to start from a new line.",
+    "Multiline string literal is expected to end after a new line.",
+    "Directive identifier is expected after #.",
+    "Unexpected characters in a directive identifier after #.",
+    "Unexpected character in a number literal.",
+    "Unexpected character.",
+    "Non-ASCII character.",
+    "'_' is not a valid identifier.",
+    "Integer literal does not fit in 64 bits.",
+    "Float literal is too large for a double."
+};
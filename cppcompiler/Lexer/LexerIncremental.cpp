@@ -0,0 +1,181 @@
+//
+//  LexerIncremental.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include "Lexer.hpp"
+#include "SourceBuffer.hpp"
+
+// Applies a text edit to the tokens of a file, for editors that can't lex the whole file on every key press.
+// The lexer has no state between two tokens, so it can start again right after any of them.
+// It starts after the last token that the edit can not have changed, and lexes the new source
+// until it is about to lex a token where one of the old tokens started, past the edit.
+// The rest of the source is the same as before, so are its tokens, they are only moved by the edit's length.
+// A """ literal or a comment that the edit opens or closes just makes the lexer go further before that happens.
+// Only the characters from the restart to that token are lexed, the kept tokens are moved in place.
+
+const int LEXER_RELEX_LOOKAHEAD = 4; // the lexer never looks further past a token than this
+
+struct TextEdit {
+    int offset; // in the old source
+    int removed_length;
+    const char *inserted;
+    int inserted_length;
+};
+typedef struct TextEdit TextEdit;
+
+// the tokens that were replaced
+struct RelexResult {
+    int first_token;
+    int removed_count; // old tokens
+    int inserted_count; // new tokens in their place
+};
+typedef struct RelexResult RelexResult;
+
+// the source with the edit applied, followed by zeros like a SourceBuffer, freed by the caller
+char* text_edit_apply(const char *source, int count, TextEdit edit, int *new_count) {
+    *new_count = count - edit.removed_length + edit.inserted_length;
+    char *result = (char*) malloc(*new_count + SOURCE_BUFFER_PADDING);
+    int kept_from = edit.offset + edit.removed_length;
+    memcpy(result, source, edit.offset);
+    memcpy(result + edit.offset, edit.inserted, edit.inserted_length);
+    memcpy(result + edit.offset + edit.inserted_length, source + kept_from, count - kept_from);
+    memset(result + *new_count, 0, SOURCE_BUFFER_PADDING);
+    return result;
+}
+
+// the output has to come from lexer_analyze or token_cache_load with the same lexer
+// the source already has the edit applied, it replaces the output's source
+// literal values of the replaced tokens stay in the output's arenas until it is freed
+RelexResult lexer_relex(Lexer *lexer, Output *output, char *source, int count, TextEdit edit) {
+    output_make_writable(output);
+    auto *tokens = &output->tokens;
+    int delta = edit.inserted_length - edit.removed_length;
+    int edit_end = edit.offset + edit.inserted_length; // in the new source
+
+    // the first token that the edit can change, or that can look at the edit
+    int low = 0;
+    int high = tokens->count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if ((long) token_arena_end_offset(tokens, middle) + LEXER_RELEX_LOOKAHEAD < edit.offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    int first = low;
+    int restart = first == 0 ? 0 : (int) token_arena_end_offset(tokens, first - 1) + 1;
+
+    // lex until the next token starts where an old one did, past the edit
+    Output *relexed = output_create(source, count, output->interner);
+    lexer_start(lexer, relexed, source, count, restart);
+    int old_token = first;
+    int last = tokens->count; // the first old token that is kept
+    while (lexer->i < count) {
+        if (lexer->i >= edit_end) {
+            uint32_t old_offset = lexer->i - delta;
+            while (old_token < tokens->count && token_arena_offset(tokens, old_token) < old_offset) {
+                old_token += 1;
+            }
+            if (old_token < tokens->count && token_arena_offset(tokens, old_token) == old_offset) {
+                last = old_token;
+                break;
+            }
+        }
+        if (!lex_token(lexer)) {
+            break;
+        }
+    }
+    lexer->output = NULL;
+
+    RelexResult result;
+    result.first_token = first;
+    result.removed_count = last - first;
+    result.inserted_count = relexed->tokens.count;
+
+    // the diagnostics from before the restart and after the replaced tokens stay,
+    // the ones in between are the re-lexed ones
+    Diagnostics diagnostics;
+    memset(&diagnostics, 0, sizeof(diagnostics));
+    for (int d = 0; d < output->diagnostics.count && output->diagnostics.items[d].token < first; d++) {
+        diagnostics_append(&diagnostics, output->diagnostics.items[d]);
+    }
+    for (int d = 0; d < relexed->diagnostics.count; d++) {
+        Diagnostic diagnostic = relexed->diagnostics.items[d];
+        diagnostic.token += first;
+        diagnostics_append(&diagnostics, diagnostic);
+    }
+    for (int d = 0; d < output->diagnostics.count; d++) {
+        Diagnostic diagnostic = output->diagnostics.items[d];
+        if (diagnostic.token > last) {
+            diagnostic.offset += delta;
+            diagnostic.end_offset += delta;
+            diagnostic.token += result.inserted_count - result.removed_count;
+            diagnostics_append(&diagnostics, diagnostic);
+        }
+    }
+    diagnostics_free(&output->diagnostics);
+    output->diagnostics = diagnostics;
+
+    // splice: the kept tokens are moved right after the new ones, their literal values stay where they are
+    int old_count = tokens->count;
+    int kept_count = old_count - last;
+    int new_first_kept = first + result.inserted_count;
+    while (tokens->count < new_first_kept + kept_count) {
+        token_arena_push(tokens, ENDOFFILE, 0, 0, 0);
+    }
+    token_arena_move(tokens, last, new_first_kept, kept_count);
+    tokens->count = new_first_kept + kept_count;
+
+    // the new tokens' literal values are appended, the replaced ones' are left unused
+    unsigned int strings_offset = output->strings.length;
+    if (relexed->strings.length > 0) {
+        string_arena_append(&output->strings, relexed->strings.characters, relexed->strings.length);
+    }
+    for (int t = 0; t < relexed->tokens.count; t++) {
+        int index_in_chunk;
+        TokenChunk *chunk = &relexed->tokens.chunks[token_arena_chunk_of(t, &index_in_chunk)];
+        auto type = (TokenType) chunk->kinds[index_in_chunk];
+        uint32_t payload = chunk->payloads[index_in_chunk];
+        if (type == INTLITERAL) {
+            payload = token_arena_push_int(tokens, token_arena_int_value(&relexed->tokens, payload));
+        } else if (type == FLOATLITERAL) {
+            payload = token_arena_push_float(tokens, relexed->tokens.float_values[payload]);
+        } else if (type == STRINGLITERAL) {
+            Slice value = relexed->tokens.string_values[payload];
+            if (value.is_materialized) {
+                value.offset += strings_offset;
+            }
+            payload = token_arena_push_string(tokens, value);
+        }
+        token_arena_set(tokens, first + t, type, chunk->offsets[index_in_chunk],
+                        chunk->end_offsets[index_in_chunk], payload);
+    }
+    output_free(relexed);
+
+    // the kept tokens are only moved by the edit's length
+    if (delta != 0) {
+        for (int t = new_first_kept; t < tokens->count; t++) {
+            int index_in_chunk;
+            TokenChunk *chunk = &tokens->chunks[token_arena_chunk_of(t, &index_in_chunk)];
+            chunk->offsets[index_in_chunk] += delta;
+            chunk->end_offsets[index_in_chunk] += delta;
+            if (chunk->kinds[index_in_chunk] == STRINGLITERAL) {
+                Slice *value = &tokens->string_values[chunk->payloads[index_in_chunk]];
+                if (!value->is_materialized) {
+                    value->offset += delta;
+                }
+            }
+        }
+    }
+
+    output->tokens_count = tokens->count;
+    output->source = source;
+    output->source_length = count;
+    output->lines.is_built = false;
+    return result;
+}
@@ -0,0 +1,275 @@
+//
+//  LexerNumbers.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <math.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+#include "LexerPowersOfFive.hpp"
+
+// Converts number literals that the lexer has already checked, straight from the source.
+// Underscores are skipped, a literal can start with a minus.
+// Nothing here depends on the locale, and overflows are reported instead of wrapping.
+
+// DIGITS
+
+// the value of a digit in the base, or -1
+int digit_value(char character, int base) {
+    int value;
+    if (character >= '0' && character <= '9') {
+        value = character - '0';
+    } else if (character >= 'a' && character <= 'f') {
+        value = character - 'a' + 10;
+    } else if (character >= 'A' && character <= 'F') {
+        value = character - 'A' + 10;
+    } else {
+        return -1;
+    }
+    return value < base ? value : -1;
+}
+
+// INTEGERS
+
+// [-]digits in base 10, or [-]0x / 0b followed by digits
+// hexadecimal and binary literals can use all 64 bits, 0xFFFFFFFFFFFFFFFF is -1
+// returns false if the value does not fit
+bool parse_integer_literal(const char *characters, int length, int64_t *value) {
+    int index = 0;
+    bool is_negative = characters[0] == '-';
+    if (is_negative) {
+        index += 1;
+    }
+
+    int base = 10;
+    if (length - index > 2 && characters[index] == '0') {
+        char prefix = characters[index + 1];
+        if (prefix == 'x') {
+            base = 16;
+            index += 2;
+        } else if (prefix == 'b') {
+            base = 2;
+            index += 2;
+        }
+    }
+
+    uint64_t magnitude = 0;
+    for (; index < length; index++) {
+        if (characters[index] == '_') {
+            continue;
+        }
+        uint64_t digit = digit_value(characters[index], base);
+        if (__builtin_mul_overflow(magnitude, (uint64_t) base, &magnitude)
+            || __builtin_add_overflow(magnitude, digit, &magnitude)) {
+            return false;
+        }
+    }
+
+    const uint64_t limit = (uint64_t) 1 << 63;
+    if (is_negative) {
+        if (magnitude > limit) {
+            return false;
+        }
+        *value = (int64_t) (0 - magnitude);
+    } else {
+        if (base == 10 && magnitude >= limit) {
+            return false;
+        }
+        *value = (int64_t) magnitude;
+    }
+    return true;
+}
+
+// FLOATS
+
+const int FLOAT_SIGNIFICAND_DIGITS_MAX = 19; // always fit in 64 bits
+const int FLOAT_FAST_PATH_EXPONENT_MAX = 22; // 10^22 is the largest power of ten that is exact in a double
+const uint64_t FLOAT_FAST_PATH_SIGNIFICAND_MAX = (uint64_t) 1 << 53;
+
+const double exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double double_from_bits(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Eisel-Lemire: the significand times an approximation of 5^exponent in 128 bits, correctly rounded.
+// Needs a non-zero significand, see "Number Parsing at a Gigabyte per Second" (Lemire, 2021)
+// and "Fast Number Parsing Without Fallback" (Mushtak, Lemire, 2023) for why 128 bits are always enough.
+double eisel_lemire(uint64_t significand, int64_t exponent) {
+    if (exponent < POWER_OF_FIVE_MIN) {
+        return 0;
+    }
+    if (exponent > POWER_OF_FIVE_MAX) {
+        return HUGE_VAL;
+    }
+
+    int leading_zeros = __builtin_clzll(significand);
+    significand <<= leading_zeros;
+
+    int index = 2 * (int) (exponent - POWER_OF_FIVE_MIN);
+    unsigned __int128 product = (unsigned __int128) significand * powers_of_five[index];
+    uint64_t high = (uint64_t) (product >> 64);
+    uint64_t low = (uint64_t) product;
+
+    // the lower half of 5^exponent only matters when the bits below the mantissa are all ones
+    const uint64_t precision_mask = ~(uint64_t) 0 >> 55;
+    if ((high & precision_mask) == precision_mask) {
+        unsigned __int128 second = (unsigned __int128) significand * powers_of_five[index + 1];
+        uint64_t second_high = (uint64_t) (second >> 64);
+        low += second_high;
+        if (second_high > low) {
+            high += 1;
+        }
+    }
+
+    int upper_bit = (int) (high >> 63);
+    int shift = upper_bit + 64 - 52 - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(log2(10^exponent)) + 63, and the bias of 1023
+    int power2 = (int) ((((152170 + 65536) * exponent) >> 16) + 63) + upper_bit - leading_zeros + 1023;
+
+    if (power2 <= 0) {
+        // subnormal, or zero
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        // rounding up can make it normal again
+        power2 = mantissa < ((uint64_t) 1 << 52) ? 0 : 1;
+        return double_from_bits(mantissa | ((uint64_t) power2 << 52));
+    }
+
+    // exactly halfway between two doubles rounds to the even one,
+    // this can only happen when 5^exponent fits in 64 bits
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (mantissa & 3) == 1
+        && (mantissa << shift) == high) {
+        mantissa &= ~(uint64_t) 1;
+    }
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= ((uint64_t) 2 << 52)) {
+        mantissa = (uint64_t) 1 << 52;
+        power2 += 1;
+    }
+    mantissa &= ~((uint64_t) 1 << 52);
+    if (power2 >= 0x7FF) {
+        return HUGE_VAL;
+    }
+    return double_from_bits(mantissa | ((uint64_t) power2 << 52));
+}
+
+// only for more than 19 significant digits that Eisel-Lemire can't decide on
+double parse_float_fallback(const char *characters, int length) {
+    static locale_t c_locale = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
+
+    char *string = (char*) malloc(length + 1);
+    int string_length = 0;
+    for (int index = 0; index < length; index++) {
+        if (characters[index] != '_') {
+            string[string_length++] = characters[index];
+        }
+    }
+    string[string_length] = 0;
+    double value = strtod_l(string, NULL, c_locale);
+    free(string);
+    return value;
+}
+
+// [-]digits[.digits][e[-]digits], any of the digits can be missing but not all of them
+// returns false if the value is too large for a double
+bool parse_float_literal(const char *characters, int length, double *value) {
+    int index = 0;
+    bool is_negative = characters[0] == '-';
+    if (is_negative) {
+        index += 1;
+    }
+
+    uint64_t significand = 0;
+    int significant_digits = 0;
+    int64_t exponent = 0;
+    bool is_fraction = false;
+    bool is_truncated = false; // non-zero digits were dropped
+
+    for (; index < length; index++) {
+        char character = characters[index];
+        if (character == '_') {
+            continue;
+        } else if (character == '.') {
+            is_fraction = true;
+            continue;
+        } else if (character == 'e') {
+            break;
+        }
+
+        int digit = character - '0';
+        if (significant_digits == 0 && digit == 0) {
+            exponent -= is_fraction;
+        } else if (significant_digits < FLOAT_SIGNIFICAND_DIGITS_MAX) {
+            significand = significand * 10 + digit;
+            significant_digits += 1;
+            exponent -= is_fraction;
+        } else {
+            is_truncated |= digit != 0;
+            exponent += !is_fraction;
+        }
+    }
+
+    if (index < length) {
+        index += 1;
+        bool is_exponent_negative = index < length && characters[index] == '-';
+        if (is_exponent_negative) {
+            index += 1;
+        }
+        int64_t literal_exponent = 0;
+        for (; index < length; index++) {
+            // anything past this is 0 or infinity anyway
+            if (characters[index] != '_' && literal_exponent < 100000) {
+                literal_exponent = literal_exponent * 10 + characters[index] - '0';
+            }
+        }
+        exponent += is_exponent_negative ? -literal_exponent : literal_exponent;
+    }
+
+    double result;
+    if (significand == 0) {
+        result = 0;
+    } else if (is_truncated) {
+        // the dropped digits can only matter if the significand and the next one round differently
+        result = eisel_lemire(significand, exponent);
+        if (result != eisel_lemire(significand + 1, exponent)) {
+            result = fabs(parse_float_fallback(characters, length));
+        }
+    } else if (exponent >= -FLOAT_FAST_PATH_EXPONENT_MAX && exponent <= FLOAT_FAST_PATH_EXPONENT_MAX
+               && significand <= FLOAT_FAST_PATH_SIGNIFICAND_MAX) {
+        // both are exact, so is one operation on them
+        result = (double) significand;
+        if (exponent < 0) {
+            result /= exact_powers_of_ten[-exponent];
+        } else {
+            result *= exact_powers_of_ten[exponent];
+        }
+    } else {
+        result = eisel_lemire(significand, exponent);
+    }
+
+    *value = is_negative ? -result : result;
+    return result != HUGE_VAL;
+}
@@ -0,0 +1,244 @@
+//
+//  LexerParallel.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include "Lexer.hpp"
+#include "ThreadPool.hpp"
+
+// Lexes one big file on many threads.
+// The file is cut into chunks at new lines, and every chunk is lexed speculatively from its first character.
+// That guess is wrong when the previous chunk ends inside a string literal or a comment,
+// so when the chunks are stitched together, the real lexer continues from where the previous chunk stopped,
+// until it reaches a position where the chunk had also started a token. From there on both agree.
+
+// what the compiler passes as the smallest chunk, the tests pass tiny ones to make many boundaries
+const int LEXER_PARALLEL_MIN_CHUNK_SIZE = 1 << 18;
+
+// a position where a speculative lexer started a token
+struct ChunkBoundary {
+    int offset;
+    int first_token;
+};
+typedef struct ChunkBoundary ChunkBoundary;
+
+struct LexChunk {
+    int begin;
+    int end; // the lexer stops at the first token that starts at or after the end
+
+    Lexer *lexer; // speculative
+    Output *output;
+
+    ChunkBoundary *boundaries;
+    int boundaries_count;
+    int boundaries_capacity;
+
+    int resume; // where the next token starts after this chunk
+    bool has_failed; // the lexer failed at the resume position
+    bool reached_end_of_file;
+};
+typedef struct LexChunk LexChunk;
+
+struct LexChunks {
+    char *string;
+    int count;
+    LexChunk *chunks;
+};
+typedef struct LexChunks LexChunks;
+
+void lex_chunk_add_boundary(LexChunk *chunk, int offset, int first_token) {
+    if (chunk->boundaries_count == chunk->boundaries_capacity) {
+        chunk->boundaries_capacity = chunk->boundaries_capacity == 0 ? 1024 : chunk->boundaries_capacity * 2;
+        chunk->boundaries = (ChunkBoundary*) realloc(chunk->boundaries,
+                                                     chunk->boundaries_capacity * sizeof(ChunkBoundary));
+    }
+    chunk->boundaries[chunk->boundaries_count].offset = offset;
+    chunk->boundaries[chunk->boundaries_count].first_token = first_token;
+    chunk->boundaries_count += 1;
+}
+
+void lex_chunk_job(int job, int worker, void *context) {
+    (void) worker;
+    auto *jobs = (LexChunks*) context;
+    auto *chunk = &jobs->chunks[job];
+
+    auto *lexer = lexer_create();
+    chunk->lexer = lexer;
+    chunk->output = output_create(jobs->string, jobs->count, &lexer->interner);
+
+    lexer_start(lexer, chunk->output, jobs->string, jobs->count, chunk->begin);
+    lexer->is_speculative = true;
+
+    while (lexer->i < chunk->end) {
+        int offset = lexer->i;
+        int first_token = chunk->output->tokens.count;
+
+        bool has_more = lex_token(lexer);
+        if (lexer->has_failed) {
+            chunk->has_failed = true;
+            lexer->i = offset;
+            break;
+        }
+        if (chunk->output->tokens.count > first_token) {
+            lex_chunk_add_boundary(chunk, offset, first_token);
+        }
+        if (!has_more) {
+            chunk->reached_end_of_file = true;
+            break;
+        }
+    }
+    chunk->resume = lexer->i;
+}
+
+// copies the chunk's tokens, starting from the token, into the output
+// offsets are in the whole string already, only symbols and literal values are moved
+void lex_chunk_append_tokens(Output *output, LexChunk *chunk, int first_token) {
+    auto *tokens = &chunk->output->tokens;
+    auto *interner = &chunk->lexer->interner;
+    unsigned int strings_offset = output->strings.length;
+    if (chunk->output->strings.length > 0) {
+        string_arena_append(&output->strings, chunk->output->strings.characters, chunk->output->strings.length);
+    }
+
+    // symbols of the chunk's own interner, interned again in the order they are met,
+    // so they get the same numbers as on the sequential path
+    const Symbol SYMBOL_UNMAPPED = std::numeric_limits<Symbol>::max();
+    Symbol *symbols = (Symbol*) malloc(interner->strings_count * sizeof(Symbol));
+    for (Symbol s = 0; s < interner->strings_count; s++) {
+        symbols[s] = s < SYMBOL_PRESEEDED_COUNT ? s : SYMBOL_UNMAPPED;
+    }
+
+    for (int t = first_token; t < tokens->count; t++) {
+        int index_in_chunk;
+        TokenChunk *from = &tokens->chunks[token_arena_chunk_of(t, &index_in_chunk)];
+        auto type = (TokenType) from->kinds[index_in_chunk];
+        uint32_t payload = from->payloads[index_in_chunk];
+
+        if (type == IDENTIFIER || type == DIRECTIVE) {
+            Symbol symbol = payload;
+            if (symbols[symbol] == SYMBOL_UNMAPPED) {
+                symbols[symbol] = interner_intern(output->interner, interner_characters(interner, symbol),
+                                                  interner_length(interner, symbol));
+            }
+            payload = symbols[symbol];
+        } else if (type == INTLITERAL) {
+            payload = token_arena_push_int(&output->tokens, token_arena_int_value(tokens, payload));
+        } else if (type == FLOATLITERAL) {
+            payload = token_arena_push_float(&output->tokens, tokens->float_values[payload]);
+        } else if (type == STRINGLITERAL) {
+            Slice value = tokens->string_values[payload];
+            if (value.is_materialized) {
+                value.offset += strings_offset;
+            }
+            payload = token_arena_push_string(&output->tokens, value);
+        }
+        token_arena_push(&output->tokens, type, from->offsets[index_in_chunk],
+                         from->end_offsets[index_in_chunk], payload);
+    }
+    free(symbols);
+}
+
+void lex_chunk_free(LexChunk *chunk) {
+    output_free(chunk->output);
+    lexer_free(chunk->lexer);
+    free(chunk->boundaries);
+}
+
+// the same as lexer_analyze, files smaller than a few chunks are lexed on the calling thread
+// a chunk is at least min_chunk_size characters long, and continues up to the next new line
+Output* lexer_analyze_parallel(Lexer *lexer, char* string, int count, int workers_count, int min_chunk_size) {
+    int chunk_size = count / (workers_count > 0 ? workers_count : 1) + 1;
+    if (chunk_size < min_chunk_size) {
+        chunk_size = min_chunk_size;
+    }
+    if (workers_count <= 1 || count < chunk_size * 2) {
+        return lexer_analyze(lexer, string, count);
+    }
+
+    // cut right after new lines
+    LexChunks jobs;
+    jobs.string = string;
+    jobs.count = count;
+    jobs.chunks = (LexChunk*) calloc(count / chunk_size + 1, sizeof(LexChunk));
+    int chunks_count = 0;
+    int begin = 0;
+    while (begin < count) {
+        int end = begin + chunk_size;
+        if (end >= count) {
+            end = count;
+        } else {
+            auto newline = (char*) memchr(string + end, CHAR_NEWLINE, count - end);
+            end = newline != NULL ? (int) (newline - string) + 1 : count;
+        }
+        jobs.chunks[chunks_count].begin = begin;
+        jobs.chunks[chunks_count].end = end;
+        chunks_count += 1;
+        begin = end;
+    }
+
+    auto stats = thread_pool_run(workers_count, chunks_count, lex_chunk_job, &jobs);
+    thread_pool_stats_free(&stats);
+
+    // stitch
+    Output *output = output_create(string, count, &lexer->interner);
+    int position = 0;
+    bool is_done = false;
+
+    for (int c = 0; c < chunks_count && !is_done; c++) {
+        auto *chunk = &jobs.chunks[c];
+        // continue with the real lexer until it is in step with the chunk
+        int boundary = 0;
+        if (position != chunk->begin) {
+            lexer_start(lexer, output, string, count, position);
+            while (true) {
+                while (boundary < chunk->boundaries_count && chunk->boundaries[boundary].offset < lexer->i) {
+                    boundary += 1;
+                }
+                if (boundary < chunk->boundaries_count && chunk->boundaries[boundary].offset == lexer->i) {
+                    break;
+                }
+                if (lexer->i >= chunk->end) {
+                    break;
+                }
+                if (!lex_token(lexer)) {
+                    is_done = true;
+                    break;
+                }
+            }
+            position = lexer->i;
+            if (is_done || boundary == chunk->boundaries_count) {
+                continue;
+            }
+        }
+
+        lex_chunk_append_tokens(output, chunk, chunk->boundaries_count > 0 ? chunk->boundaries[boundary].first_token : 0);
+        position = chunk->resume;
+        is_done = chunk->reached_end_of_file;
+
+        if (chunk->has_failed) {
+            // the same error happens on the real path, the real lexer records it and recovers,
+            // then the next chunk is joined like any other
+            lexer_start(lexer, output, string, count, position);
+            is_done = !lex_token(lexer);
+            position = lexer->i;
+        }
+    }
+
+    // the file ended with whitespace or a comment
+    if (!is_done && position < count) {
+        lexer_start(lexer, output, string, count, position);
+        while (lexer->characters_count > lexer->i && lex_token(lexer)) {}
+    }
+
+    output->tokens_count = output->tokens.count;
+    lexer->output = NULL;
+
+    for (int c = 0; c < chunks_count; c++) {
+        lex_chunk_free(&jobs.chunks[c]);
+    }
+    free(jobs.chunks);
+    return output;
+}
@@ -0,0 +1,254 @@
+//
+//  LexerSimd.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+#include "LexerConst.hpp"
+#include <stdint.h>
+
+// Scanning kernels for long runs of characters.
+// Every kernel looks at [from, to) and returns the index of the first character
+// that ends the run, or `to` if the run reaches it. Nothing is read past `to`.
+// line_starts instead writes the index after every new line and returns how many it wrote.
+// The SSE2 and AVX2 versions are picked at runtime, others fall back to scalar code.
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LEXER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+struct ScanKernels {
+    int (*whitespace_end)(const char *code, int from, int to);
+    int (*identifier_end)(const char *code, int from, int to);
+    int (*find_any_of3)(const char *code, int from, int to, char a, char b, char c);
+    int (*line_starts)(const char *code, int from, int to, uint32_t *starts);
+    const char *name;
+};
+typedef struct ScanKernels ScanKernels;
+
+// SCALAR
+
+int scalar_whitespace_end(const char *code, int from, int to) {
+    while (from < to && (code[from] == CHAR_SPACE || code[from] == CHAR_NEWLINE)) {
+        from += 1;
+    }
+    return from;
+}
+
+int scalar_identifier_end(const char *code, int from, int to) {
+    while (from < to && is_character_class(code[from], CHARCLASS_IDENTIFIER_BODY)) {
+        from += 1;
+    }
+    return from;
+}
+
+int scalar_find_any_of3(const char *code, int from, int to, char a, char b, char c) {
+    while (from < to && code[from] != a && code[from] != b && code[from] != c) {
+        from += 1;
+    }
+    return from;
+}
+
+int scalar_line_starts(const char *code, int from, int to, uint32_t *starts) {
+    int count = 0;
+    for (int index = from; index < to; index++) {
+        if (code[index] == CHAR_NEWLINE) {
+            starts[count++] = index + 1;
+        }
+    }
+    return count;
+}
+
+#ifdef LEXER_SIMD_X86
+
+// SSE2
+
+// 0xFF in every byte that is within [min, max]
+inline __m128i sse2_in_range(__m128i bytes, char min, char max) {
+    __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8(min));
+    __m128i limit = _mm_set1_epi8((char) (max - min));
+    return _mm_cmpeq_epi8(_mm_max_epu8(shifted, limit), limit);
+}
+
+int sse2_whitespace_end(const char *code, int from, int to) {
+    __m128i space = _mm_set1_epi8(CHAR_SPACE);
+    __m128i newline = _mm_set1_epi8(CHAR_NEWLINE);
+    while (from + 16 <= to) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (code + from));
+        __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, newline));
+        unsigned int mask = ~_mm_movemask_epi8(matches) & 0xFFFF;
+        if (mask != 0) {
+            return from + __builtin_ctz(mask);
+        }
+        from += 16;
+    }
+    return scalar_whitespace_end(code, from, to);
+}
+
+int sse2_identifier_end(const char *code, int from, int to) {
+    __m128i underscore = _mm_set1_epi8(CHAR_UNDERSCORE);
+    __m128i accent = _mm_set1_epi8(CHAR_ACCENT);
+    while (from + 16 <= to) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (code + from));
+        __m128i matches = _mm_or_si128(
+            _mm_or_si128(sse2_in_range(bytes, TOKENRANGE_LOWERCASE_MIN, TOKENRANGE_LOWERCASE_MAX),
+                         sse2_in_range(bytes, TOKENRANGE_UPPERCASE_MIN, TOKENRANGE_UPPERCASE_MAX)),
+            _mm_or_si128(sse2_in_range(bytes, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX),
+                         _mm_or_si128(_mm_cmpeq_epi8(bytes, underscore), _mm_cmpeq_epi8(bytes, accent))));
+        unsigned int mask = ~_mm_movemask_epi8(matches) & 0xFFFF;
+        if (mask != 0) {
+            return from + __builtin_ctz(mask);
+        }
+        from += 16;
+    }
+    return scalar_identifier_end(code, from, to);
+}
+
+int sse2_find_any_of3(const char *code, int from, int to, char a, char b, char c) {
+    __m128i va = _mm_set1_epi8(a);
+    __m128i vb = _mm_set1_epi8(b);
+    __m128i vc = _mm_set1_epi8(c);
+    while (from + 16 <= to) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (code + from));
+        __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(bytes, va),
+                                       _mm_or_si128(_mm_cmpeq_epi8(bytes, vb), _mm_cmpeq_epi8(bytes, vc)));
+        unsigned int mask = _mm_movemask_epi8(matches);
+        if (mask != 0) {
+            return from + __builtin_ctz(mask);
+        }
+        from += 16;
+    }
+    return scalar_find_any_of3(code, from, to, a, b, c);
+}
+
+int sse2_line_starts(const char *code, int from, int to, uint32_t *starts) {
+    __m128i newline = _mm_set1_epi8(CHAR_NEWLINE);
+    int count = 0;
+    while (from + 16 <= to) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (code + from));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline));
+        while (mask != 0) {
+            starts[count++] = from + __builtin_ctz(mask) + 1;
+            mask &= mask - 1;
+        }
+        from += 16;
+    }
+    return count + scalar_line_starts(code, from, to, starts + count);
+}
+
+// AVX2
+
+__attribute__((target("avx2")))
+inline __m256i avx2_in_range(__m256i bytes, char min, char max) {
+    __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8(min));
+    __m256i limit = _mm256_set1_epi8((char) (max - min));
+    return _mm256_cmpeq_epi8(_mm256_max_epu8(shifted, limit), limit);
+}
+
+__attribute__((target("avx2")))
+int avx2_whitespace_end(const char *code, int from, int to) {
+    __m256i space = _mm256_set1_epi8(CHAR_SPACE);
+    __m256i newline = _mm256_set1_epi8(CHAR_NEWLINE);
+    while (from + 32 <= to) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) (code + from));
+        __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, space), _mm256_cmpeq_epi8(bytes, newline));
+        unsigned int mask = ~(unsigned int) _mm256_movemask_epi8(matches);
+        if (mask != 0) {
+            return from + __builtin_ctz(mask);
+        }
+        from += 32;
+    }
+    return sse2_whitespace_end(code, from, to);
+}
+
+__attribute__((target("avx2")))
+int avx2_identifier_end(const char *code, int from, int to) {
+    __m256i underscore = _mm256_set1_epi8(CHAR_UNDERSCORE);
+    __m256i accent = _mm256_set1_epi8(CHAR_ACCENT);
+    while (from + 32 <= to) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) (code + from));
+        __m256i matches = _mm256_or_si256(
+            _mm256_or_si256(avx2_in_range(bytes, TOKENRANGE_LOWERCASE_MIN, TOKENRANGE_LOWERCASE_MAX),
+                            avx2_in_range(bytes, TOKENRANGE_UPPERCASE_MIN, TOKENRANGE_UPPERCASE_MAX)),
+            _mm256_or_si256(avx2_in_range(bytes, TOKENRANGE_NUMBER_MIN, TOKENRANGE_NUMBER_MAX),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, underscore),
+                                            _mm256_cmpeq_epi8(bytes, accent))));
+        unsigned int mask = ~(unsigned int) _mm256_movemask_epi8(matches);
+        if (mask != 0) {
+            return from + __builtin_ctz(mask);
+        }
+        from += 32;
+    }
+    return sse2_identifier_end(code, from, to);
+}
+
+__attribute__((target("avx2")))
+int avx2_find_any_of3(const char *code, int from, int to, char a, char b, char c) {
+    __m256i va = _mm256_set1_epi8(a);
+    __m256i vb = _mm256_set1_epi8(b);
+    __m256i vc = _mm256_set1_epi8(c);
+    while (from + 32 <= to) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) (code + from));
+        __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, va),
+                                          _mm256_or_si256(_mm256_cmpeq_epi8(bytes, vb),
+                                                          _mm256_cmpeq_epi8(bytes, vc)));
+        unsigned int mask = _mm256_movemask_epi8(matches);
+        if (mask != 0) {
+            return from + __builtin_ctz(mask);
+        }
+        from += 32;
+    }
+    return sse2_find_any_of3(code, from, to, a, b, c);
+}
+
+__attribute__((target("avx2")))
+int avx2_line_starts(const char *code, int from, int to, uint32_t *starts) {
+    __m256i newline = _mm256_set1_epi8(CHAR_NEWLINE);
+    int count = 0;
+    while (from + 32 <= to) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) (code + from));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline));
+        while (mask != 0) {
+            starts[count++] = from + __builtin_ctz(mask) + 1;
+            mask &= mask - 1;
+        }
+        from += 32;
+    }
+    return count + sse2_line_starts(code, from, to, starts + count);
+}
+
+#endif
+
+ScanKernels select_scan_kernels() {
+    ScanKernels kernels;
+#ifdef LEXER_SIMD_X86
+    if (getenv("LEXER_NO_SIMD") == NULL) {
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.whitespace_end = avx2_whitespace_end;
+            kernels.identifier_end = avx2_identifier_end;
+            kernels.find_any_of3 = avx2_find_any_of3;
+            kernels.line_starts = avx2_line_starts;
+            kernels.name = "avx2";
+        } else {
+            kernels.whitespace_end = sse2_whitespace_end;
+            kernels.identifier_end = sse2_identifier_end;
+            kernels.find_any_of3 = sse2_find_any_of3;
+            kernels.line_starts = sse2_line_starts;
+            kernels.name = "sse2";
+        }
+        return kernels;
+    }
+#endif
+    kernels.whitespace_end = scalar_whitespace_end;
+    kernels.identifier_end = scalar_identifier_end;
+    kernels.find_any_of3 = scalar_find_any_of3;
+    kernels.line_starts = scalar_line_starts;
+    kernels.name = "scalar";
+    return kernels;
+}
+
+ScanKernels scan = select_scan_kernels();
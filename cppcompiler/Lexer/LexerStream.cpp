@@ -0,0 +1,143 @@
+//
+//  LexerStream.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include <unistd.h>
+#include "Lexer.hpp"
+
+// Lexes input that is read one window at a time, so only the window and its tokens are in memory.
+// While there is more input, the lexer is speculative: a token that reaches the end of the window
+// may be cut, so it is dropped and lexed again after the window is moved to start with it.
+// A window that holds only a part of one token (a long string literal) is made bigger.
+// The tokens and the diagnostics of every window are given to the callback, their offsets and string slices
+// refer to the window and are only valid during the call.
+
+typedef void (*LexerStreamCallback)(Output *output, void *context);
+
+const int LEXER_STREAM_LOOKAHEAD = 4; // the lexer never looks further ahead than this
+const int LEXER_STREAM_PADDING = 64;
+
+struct LexerStream {
+    int descriptor;
+    char *window; // followed by zeros
+    int window_length;
+    int window_capacity;
+    bool is_end_of_input;
+};
+typedef struct LexerStream LexerStream;
+
+// reads until the window is full or the input ended
+bool lexer_stream_fill(LexerStream *stream) {
+    while (!stream->is_end_of_input && stream->window_length < stream->window_capacity) {
+        ssize_t count = read(stream->descriptor, stream->window + stream->window_length,
+                             stream->window_capacity - stream->window_length);
+        if (count < 0) {
+            return false;
+        } else if (count == 0) {
+            stream->is_end_of_input = true;
+        }
+        stream->window_length += count;
+    }
+    memset(stream->window + stream->window_length, 0, LEXER_STREAM_PADDING);
+    return true;
+}
+
+// the window starts at the index afterwards
+void lexer_stream_move(LexerStream *stream, int index) {
+    if (index == 0) {
+        stream->window_capacity *= 2;
+        stream->window = (char*) realloc(stream->window, stream->window_capacity + LEXER_STREAM_PADDING);
+    } else {
+        memmove(stream->window, stream->window + index, stream->window_length - index);
+        stream->window_length -= index;
+    }
+}
+
+// returns false if the input could not be read, lexing errors are in the diagnostics as in lexer_analyze
+bool lexer_analyze_stream(Lexer *lexer, int descriptor, int window_size,
+                          LexerStreamCallback callback, void *context) {
+    LexerStream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.descriptor = descriptor;
+    stream.window_capacity = window_size;
+    stream.window = (char*) malloc(window_size + LEXER_STREAM_PADDING);
+
+    Output output;
+    memset(&output, 0, sizeof(output));
+    output.interner = &lexer->interner;
+
+    Cursor cursor;
+    cursor.line_number = 1;
+    cursor.character = 0;
+    int position = 0;
+    bool is_done = false;
+    bool is_read = true;
+
+    while (!is_done) {
+        if (!lexer_stream_fill(&stream)) {
+            is_read = false;
+            break;
+        }
+        output_set_source(&output, stream.window, stream.window_length, cursor);
+        lexer_start(lexer, &output, stream.window, stream.window_length, position);
+        lexer->is_speculative = !stream.is_end_of_input;
+        is_done = stream.is_end_of_input;
+
+        while (lexer->i < stream.window_length) {
+            int offset = lexer->i;
+            TokenArenaMark mark = token_arena_mark(&output.tokens);
+            unsigned int strings_length = output.strings.length;
+            int diagnostics_count = output.diagnostics.count;
+
+            bool has_more = lex_token(lexer);
+            if (lexer->has_failed) {
+                // lexed again to record the error and recover, it is dropped below if the token was cut
+                lexer_start(lexer, &output, stream.window, stream.window_length, offset);
+                has_more = lex_token(lexer);
+                lexer->is_speculative = !stream.is_end_of_input;
+            }
+            if (!stream.is_end_of_input && lexer->i + LEXER_STREAM_LOOKAHEAD >= stream.window_length) {
+                // might have been cut by the end of the window
+                token_arena_rewind(&output.tokens, mark);
+                output.strings.length = strings_length;
+                output.diagnostics.count = diagnostics_count;
+                lexer->i = offset;
+                break;
+            }
+            if (!has_more) {
+                is_done = true;
+                break;
+            }
+        }
+        position = lexer->i;
+
+        output.tokens_count = output.tokens.count;
+        if (output.tokens_count > 0 || output.diagnostics.count > 0) {
+            callback(&output, context);
+        }
+        token_arena_reset(&output.tokens);
+        output.strings.length = 0;
+        output.diagnostics.count = 0;
+
+        if (!is_done) {
+            // the only lines counted are the ones of the windows
+            cursor = output_cursor_at(&output, position);
+            lexer_stream_move(&stream, position);
+            position = 0;
+        }
+    }
+
+    // also when the input could not be read, the lexer can be used for the next file
+    lexer->is_speculative = false;
+    lexer->output = NULL;
+    token_arena_free(&output.tokens);
+    string_arena_free(&output.strings);
+    free(output.lines.starts);
+    diagnostics_free(&output.diagnostics);
+    free(stream.window);
+    return is_read;
+}
@@ -0,0 +1,114 @@
+//
+//  SourceBuffer.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// The characters of a source file, always followed by zeros,
+// so the lexer can look a few characters ahead without checking for the end.
+// Regular files are mapped into memory, pipes and stdin ("-") are read into the heap.
+
+const long SOURCE_BUFFER_PADDING = 64; // zeros after the characters, at least
+
+struct SourceBuffer {
+    char *characters;
+    long length;
+
+    void *mapping; // NULL when the characters are on the heap
+    long mapping_size;
+};
+typedef struct SourceBuffer SourceBuffer;
+
+bool source_buffer_read(SourceBuffer *buffer, int descriptor) {
+    long capacity = 1 << 16;
+    char *characters = (char*) malloc(capacity + SOURCE_BUFFER_PADDING);
+    long length = 0;
+
+    while (true) {
+        if (length == capacity) {
+            capacity *= 2;
+            characters = (char*) realloc(characters, capacity + SOURCE_BUFFER_PADDING);
+        }
+        ssize_t count = read(descriptor, characters + length, capacity - length);
+        if (count < 0) {
+            free(characters);
+            return false;
+        } else if (count == 0) {
+            break;
+        }
+        length += count;
+    }
+
+    memset(characters + length, 0, SOURCE_BUFFER_PADDING);
+    buffer->characters = characters;
+    buffer->length = length;
+    return true;
+}
+
+// the file is mapped over a reserved region that is one page longer,
+// the rest of the last page of the file and the extra page read as zeros
+bool source_buffer_map(SourceBuffer *buffer, int descriptor, long length) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    long size = (length + page_size - 1) / page_size * page_size + page_size;
+
+    void *region = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        return false;
+    }
+    if (mmap(region, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, descriptor, 0) == MAP_FAILED) {
+        munmap(region, size);
+        return false;
+    }
+    madvise(region, length, MADV_SEQUENTIAL);
+
+    buffer->characters = (char*) region;
+    buffer->length = length;
+    buffer->mapping = region;
+    buffer->mapping_size = size;
+    return true;
+}
+
+// returns false if the file can not be read
+bool source_buffer_open(SourceBuffer *buffer, const char *path) {
+    memset(buffer, 0, sizeof(*buffer));
+
+    if (strcmp(path, "-") == 0) {
+        return source_buffer_read(buffer, STDIN_FILENO);
+    }
+
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    struct stat info;
+    bool is_loaded;
+    if (fstat(descriptor, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        is_loaded = source_buffer_map(buffer, descriptor, info.st_size)
+            || source_buffer_read(buffer, descriptor);
+    } else {
+        is_loaded = source_buffer_read(buffer, descriptor);
+    }
+    close(descriptor);
+    return is_loaded;
+}
+
+void source_buffer_free(SourceBuffer *buffer) {
+    if (buffer->mapping != NULL) {
+        munmap(buffer->mapping, buffer->mapping_size);
+    } else {
+        free(buffer->characters);
+    }
+    memset(buffer, 0, sizeof(*buffer));
+}
@@ -0,0 +1,1051 @@
+//
+//  LexerTest.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+// Checks lexer_analyze against the cases shared with the Swift lexer, and that every case's tokens
+// are the same after going through the token cache, when lexed in tiny chunks by lexer_analyze_parallel
+// and when streamed through small windows by lexer_analyze_stream,
+// and that edits re-lexed with lexer_relex give the same tokens as lexing the edited source again,
+// and that the token writer's formats are as documented,
+// or compares it with a frozen reference build of compiler.app on random inputs.
+//
+// lexertest.app [cases.txt] [-seed 1]
+// lexertest.app -fuzz 1000 -reference reference.app [-seed 1]
+//
+// To freeze a reference, build compiler.app at a trusted commit and copy it somewhere outside the tree.
+
+#include "../Lexer.cpp"
+#include "../LexerParallel.cpp"
+#include "../LexerStream.cpp"
+#include "../LexerCache.cpp"
+#include "../LexerIncremental.cpp"
+#include "../TokenWriter.hpp"
+#include "../SourceBuffer.hpp"
+#include <sstream>
+#include <fstream>
+
+using namespace std;
+
+const char* const LEXER_TEST_DEFAULT_CASES = "cppcompiler/Lexer/Test/LexerTestCases.txt";
+
+// TOKEN FORMATTING
+
+void append_escaped(std::string *string, const char *characters, int length) {
+    string->push_back('"');
+    for (int c = 0; c < length; c++) {
+        switch (characters[c]) {
+            case '\n': string->append("\\n"); break;
+            case '\r': string->append("\\r"); break;
+            case '\t': string->append("\\t"); break;
+            case '\0': string->append("\\0"); break;
+            case '\\': string->append("\\\\"); break;
+            case '"': string->append("\\\""); break;
+            default: string->push_back(characters[c]);
+        }
+    }
+    string->push_back('"');
+}
+
+// "Kind value", as in the cases file
+std::string format_token(Output *output, Token *token) {
+    std::string string;
+    char number[64];
+    switch (token->type) {
+        case IDENTIFIER: string = "Identifier "; break;
+        case DIRECTIVE: string = "Directive "; break;
+        case KEYWORD: string = "Keyword "; break;
+        case PUNCTUATOR: string = "Punctuator "; break;
+        case OPERATOR: string = "Operator "; break;
+        case SEPARATOR: string = "Separator "; break;
+        case STRINGLITERAL: string = "String "; break;
+        case INTLITERAL: string = "Int "; break;
+        case FLOATLITERAL: string = "Float "; break;
+        case BOOLLITERAL: string = "Bool "; break;
+        case NULLLITERAL: return "Null";
+        case VOIDLITERAL: return "Void";
+        case ENDOFFILE: return "EOF";
+        default: return "Unknown";
+    }
+
+    switch (token->type) {
+        case IDENTIFIER: case DIRECTIVE:
+            string.append(interner_characters(output->interner, token->symbol),
+                          interner_length(output->interner, token->symbol));
+            break;
+        case KEYWORD:
+            string.append(keyword_names[token->keyword]);
+            break;
+        case PUNCTUATOR: case OPERATOR: case SEPARATOR:
+            string.append(output_slice_characters(output, token->stringValue), token->stringValue.length);
+            break;
+        case STRINGLITERAL:
+            append_escaped(&string, output_slice_characters(output, token->stringValue), token->stringValue.length);
+            break;
+        case INTLITERAL:
+            snprintf(number, sizeof(number), "%lld", (long long) token->intValue);
+            string.append(number);
+            break;
+        case FLOATLITERAL:
+            snprintf(number, sizeof(number), "%.17g", token->doubleValue);
+            string.append(number);
+            break;
+        default:
+            string.append(token->boolValue ? "true" : "false");
+    }
+    return string;
+}
+
+std::string format_cursors(Output *output, uint32_t offset, uint32_t end_offset) {
+    Cursor start = output_cursor_at(output, offset);
+    Cursor end = output_cursor_at(output, end_offset);
+    char string[64];
+    snprintf(string, sizeof(string), "@%d:%d-%d:%d ", start.line_number, start.character,
+             end.line_number, end.character);
+    return string;
+}
+
+// floats are compared by value, everything else as text
+bool token_matches(std::string expected, std::string actual) {
+    if (expected.compare(0, 6, "Float ") == 0 && actual.compare(0, 6, "Float ") == 0) {
+        return strtod(expected.c_str() + 6, NULL) == strtod(actual.c_str() + 6, NULL);
+    }
+    return expected == actual;
+}
+
+// CASES
+
+struct LexerTestCase {
+    std::string name;
+    std::string code;
+    std::vector<std::string> tokens;
+    std::vector<std::string> errors;
+    bool is_disabled;
+};
+typedef struct LexerTestCase LexerTestCase;
+
+// "--- code" keeps every line, other sections skip empty lines
+std::vector<LexerTestCase> parse_test_cases(const char *characters, long length) {
+    std::vector<LexerTestCase> cases;
+    std::string section;
+    bool is_first_code_line = false;
+
+    std::istringstream stream(std::string(characters, length));
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.compare(0, 4, "=== ") == 0) {
+            cases.push_back(LexerTestCase());
+            cases.back().name = line.substr(4);
+            section = "";
+        } else if (line.compare(0, 4, "--- ") == 0) {
+            section = line.substr(4);
+            if (section == "disabled" && !cases.empty()) {
+                cases.back().is_disabled = true;
+            }
+            is_first_code_line = true;
+        } else if (cases.empty() || (section != "code" && (line.empty() || line[0] == '#'))) {
+            continue;
+        } else if (section == "code") {
+            if (!is_first_code_line) {
+                cases.back().code.push_back('\n');
+            }
+            cases.back().code.append(line);
+            is_first_code_line = false;
+        } else if (section == "tokens") {
+            cases.back().tokens.push_back(line);
+        } else if (section == "error") {
+            cases.back().errors.push_back(line);
+        }
+    }
+
+    return cases;
+}
+
+// errors are collected in the output's diagnostics
+Output* lex_code(Lexer *lexer, const std::string &code, char **buffer) {
+    *buffer = (char*) calloc(code.size() + SOURCE_BUFFER_PADDING, 1);
+    memcpy(*buffer, code.data(), code.size());
+    return lexer_analyze(lexer, *buffer, (int) code.size());
+}
+
+// compares the lines one by one, expected lines that start with @ are compared with the cursors too
+bool lines_match(const char *kind, std::vector<std::string> &expected, std::vector<std::string> &actual,
+                 std::vector<std::string> &cursors, std::ostringstream &report) {
+    bool is_passing = expected.size() == actual.size();
+    if (!is_passing) {
+        report << kind << " counts don't match: " << actual.size() << " Expected: " << expected.size() << "\n";
+        for (auto &line : actual) { report << line << "\n"; }
+    }
+    for (size_t t = 0; t < actual.size() && t < expected.size(); t++) {
+        std::string line = expected[t][0] == '@' ? cursors[t] + actual[t] : actual[t];
+        if (!token_matches(expected[t], line)) {
+            is_passing = false;
+            report << "Mismatch in " << t << ":\n" << line << "\nExpected:\n" << expected[t] << "\n";
+        }
+    }
+    return is_passing;
+}
+
+// CACHE
+
+const char* const LEXER_TEST_CACHE_PATH = "lexertest-cache.ywtc";
+
+// every token with its cursors
+std::string format_tokens(Output *output) {
+    std::string text;
+    for (int t = 0; t < output->tokens_count; t++) {
+        Token token = output_token_at(output, t);
+        text += format_cursors(output, token.offset, token.end_offset) + format_token(output, &token) + "\n";
+    }
+    return text;
+}
+
+std::string format_diagnostics(Output *output) {
+    std::string text;
+    for (int d = 0; d < output->diagnostics.count; d++) {
+        Diagnostic diagnostic = output->diagnostics.items[d];
+        text += format_cursors(output, diagnostic.offset, diagnostic.end_offset) + lexer_error_names[diagnostic.error] + "\n";
+    }
+    return text;
+}
+
+std::string format_output(Output *output) {
+    return format_tokens(output) + format_diagnostics(output);
+}
+
+// loads the output from the cache with a lexer that has other symbols, so they are renumbered
+bool check_cache_round_trip(Output *output, std::ostringstream &report) {
+    uint64_t hash = source_hash(output->source, output->source_length);
+    if (!token_cache_write(output, LEXER_TEST_CACHE_PATH, hash)) {
+        report << "Could not write the token cache\n";
+        return false;
+    }
+    Lexer *lexer = lexer_create();
+    interner_intern(&lexer->interner, "other", 5);
+    Output *cached = token_cache_load(lexer, LEXER_TEST_CACHE_PATH, output->source, output->source_length, hash);
+    bool is_passing = cached != NULL && format_output(cached) == format_output(output);
+    if (!is_passing) {
+        report << "Token cache mismatch:\n" << (cached != NULL ? format_output(cached) : "not loaded\n");
+    }
+    if (cached != NULL) {
+        output_free(cached);
+    }
+    lexer_free(lexer);
+    remove(LEXER_TEST_CACHE_PATH);
+    return is_passing;
+}
+
+// a literal of every kind that has a side table, and a string slice of each kind
+const char* const CACHE_CHECK_CODE = "a := 1.5 \"x\\ty\" \"plain\" 9223372036854775807\nb";
+
+// the copy of the cache file with one uint32_t of the section changed has to be rejected
+bool check_cache_damage(Output *output, const std::string &file, TokenCacheSection section, int index,
+                        uint32_t value, const char *name) {
+    auto *header = (const TokenCacheHeader*) file.data();
+    std::string damaged = file;
+    memcpy(&damaged[header->sections[section] + index * sizeof(uint32_t)], &value, sizeof(value));
+    FILE *cache_file = fopen(LEXER_TEST_CACHE_PATH, "wb");
+    fwrite(damaged.data(), 1, damaged.size(), cache_file);
+    fclose(cache_file);
+
+    // a rejected cache leaves no symbols behind, they would shift the numbers of the next file's symbols
+    Lexer *lexer = lexer_create();
+    auto symbols_count = lexer->interner.strings_count;
+    Output *cached = token_cache_load(lexer, LEXER_TEST_CACHE_PATH, output->source, output->source_length,
+                                      header->source_hash);
+    bool is_passing = cached == NULL && lexer->interner.strings_count == symbols_count;
+    if (cached != NULL) {
+        cout << "A token cache with " << name << " was loaded" << endl;
+        output_free(cached);
+    } else if (!is_passing) {
+        cout << "A token cache with " << name << " was rejected, but its symbols were interned" << endl;
+    }
+    lexer_free(lexer);
+    return is_passing;
+}
+
+// a loaded output has to be copied out of its mapping before it is re-lexed
+bool check_cache_relex(Output *output, uint64_t hash) {
+    Lexer *lexer = lexer_create();
+    token_cache_write(output, LEXER_TEST_CACHE_PATH, hash);
+    Output *cached = token_cache_load(lexer, LEXER_TEST_CACHE_PATH, output->source, output->source_length, hash);
+    if (cached == NULL) {
+        cout << "Could not load the token cache to re-lex it" << endl;
+        lexer_free(lexer);
+        return false;
+    }
+
+    // more tokens and literal values than the mapping has room for
+    std::string inserted;
+    for (int n = 0; n < 1000; n++) {
+        inserted += " x2 2.5 \"s\\n\" 4294967296";
+    }
+    TextEdit edit;
+    edit.offset = 2;
+    edit.removed_length = 0;
+    edit.inserted = inserted.data();
+    edit.inserted_length = (int) inserted.size();
+    int edited_count;
+    char *edited = text_edit_apply(output->source, output->source_length, edit, &edited_count);
+    lexer_relex(lexer, cached, edited, edited_count, edit);
+
+    Lexer *full_lexer = lexer_create();
+    Output *full = lexer_analyze(full_lexer, edited, edited_count);
+    bool is_passing = format_output(cached) == format_output(full);
+    if (!is_passing) {
+        cout << "Re-lexing an output loaded from the token cache differs from lexing again" << endl;
+    }
+    output_free(full);
+    lexer_free(full_lexer);
+    output_free(cached);
+    lexer_free(lexer);
+    free(edited);
+    return is_passing;
+}
+
+int run_cache_checks() {
+    Lexer *lexer = lexer_create();
+    char *buffer;
+    Output *output = lex_code(lexer, CACHE_CHECK_CODE, &buffer);
+    uint64_t hash = source_hash(output->source, output->source_length);
+    token_cache_write(output, LEXER_TEST_CACHE_PATH, hash);
+    std::ifstream cache_file(LEXER_TEST_CACHE_PATH, std::ios::binary);
+    std::string file((std::istreambuf_iterator<char>(cache_file)), std::istreambuf_iterator<char>());
+    auto *header = (const TokenCacheHeader*) file.data();
+
+    int failed = 0;
+    uint32_t length = output->source_length;
+    for (int t = 0; t < output->tokens_count; t++) {
+        failed += !check_cache_damage(output, file, SECTION_OFFSETS, t, length + 2, "an offset after the source");
+        failed += !check_cache_damage(output, file, SECTION_END_OFFSETS, t, length + 2, "an end offset after the source");
+        switch (output_token_type(output, t)) {
+            case FLOATLITERAL:
+                failed += !check_cache_damage(output, file, SECTION_PAYLOADS, t, header->float_values_count,
+                                              "a float payload after the float values");
+                break;
+            case STRINGLITERAL:
+                failed += !check_cache_damage(output, file, SECTION_PAYLOADS, t, header->string_values_count,
+                                              "a string payload after the string values");
+                break;
+            case INTLITERAL:
+                failed += !check_cache_damage(output, file, SECTION_PAYLOADS, t,
+                                              TOKEN_PAYLOAD_LARGE | header->int_values_count,
+                                              "a large int payload after the int values");
+                break;
+            default:
+                break;
+        }
+    }
+    // the offset of the slice is its first uint32_t
+    for (int s = 0; s < output->tokens.string_values_count; s++) {
+        Slice value = output->tokens.string_values[s];
+        uint32_t after = value.is_materialized ? header->strings_length : length;
+        failed += !check_cache_damage(output, file, SECTION_STRING_VALUES, s * 2, after,
+                                      "a string slice after its characters");
+    }
+    failed += !check_cache_relex(output, hash);
+    remove(LEXER_TEST_CACHE_PATH);
+
+    output_free(output);
+    lexer_free(lexer);
+    free(buffer);
+    if (failed != 0) {
+        cout << failed << " token cache checks have failed!" << endl;
+    } else {
+        cout << "All damaged token caches were rejected, and a loaded one was re-lexed." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+bool run_test_case(LexerTestCase *test_case) {
+    Lexer *lexer = lexer_create();
+    char *buffer;
+    Output *output = lex_code(lexer, test_case->code, &buffer);
+
+    std::vector<std::string> tokens;
+    std::vector<std::string> token_cursors;
+    for (int t = 0; t < output->tokens_count; t++) {
+        Token token = output_token_at(output, t);
+        tokens.push_back(format_token(output, &token));
+        token_cursors.push_back(format_cursors(output, token.offset, token.end_offset));
+    }
+    std::vector<std::string> errors;
+    std::vector<std::string> error_cursors;
+    for (int d = 0; d < output->diagnostics.count; d++) {
+        Diagnostic diagnostic = output->diagnostics.items[d];
+        errors.push_back(lexer_error_names[diagnostic.error]);
+        error_cursors.push_back(format_cursors(output, diagnostic.offset, diagnostic.end_offset));
+    }
+
+    // the tokens lexed around errors are only checked when they are listed
+    std::ostringstream report;
+    bool is_passing = lines_match("Error", test_case->errors, errors, error_cursors, report);
+    if (test_case->errors.empty() || !test_case->tokens.empty()) {
+        is_passing &= lines_match("Token", test_case->tokens, tokens, token_cursors, report);
+    }
+    is_passing &= check_cache_round_trip(output, report);
+
+    if (!is_passing) {
+        cout << test_case->name << "\n" << test_case->code << "\n\n" << report.str() << "\n";
+    }
+    output_free(output);
+    lexer_free(lexer);
+    free(buffer);
+    return is_passing;
+}
+
+bool load_test_cases(const char *path, std::vector<LexerTestCase> *cases) {
+    SourceBuffer source;
+    if (!source_buffer_open(&source, path)) {
+        cout << "Could not load file: " << path << endl;
+        return false;
+    }
+    *cases = parse_test_cases(source.characters, source.length);
+    source_buffer_free(&source);
+    return true;
+}
+
+int run_test_cases(std::vector<LexerTestCase> &cases) {
+    int failed = 0;
+    int disabled = 0;
+    for (auto &test_case : cases) {
+        if (test_case.is_disabled) {
+            disabled += 1;
+        } else if (!run_test_case(&test_case)) {
+            failed += 1;
+        }
+    }
+
+    if (failed != 0) {
+        cout << failed << " lexer test" << (failed == 1 ? "" : "s") << " have failed!" << endl;
+    } else {
+        cout << "All lexer tests have passed (" << cases.size() - disabled << " run, "
+             << disabled << " disabled)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// NUMBERS
+
+unsigned int fuzz_random(unsigned int *state);
+
+// parse_float_literal has to give the same double as strtod, bit for bit
+bool check_float_literal(const char *literal, int *failed) {
+    std::string digits;
+    for (const char *c = literal; *c != 0; c++) {
+        if (*c != '_') {
+            digits.push_back(*c);
+        }
+    }
+    double expected = strtod(digits.c_str(), NULL);
+    double actual;
+    bool is_finite = parse_float_literal(literal, (int) strlen(literal), &actual);
+    if (is_finite != !std::isinf(expected) || (is_finite && memcmp(&expected, &actual, sizeof(double)) != 0)) {
+        if (*failed < 10) {
+            cout << "Float literal " << literal << ": " << actual << " Expected: " << expected << endl;
+        }
+        *failed += 1;
+        return false;
+    }
+    return true;
+}
+
+// drops the + of the exponent, it is not a part of the literal syntax
+void append_float_literal(std::string *string, double value, int precision) {
+    char printed[64];
+    snprintf(printed, sizeof(printed), "%.*g", precision, value);
+    for (char *c = printed; *c != 0; c++) {
+        if (*c != '+') {
+            string->push_back(*c);
+        }
+    }
+}
+
+int run_number_checks(unsigned int seed) {
+    const char* const hard_cases[] = {
+        "9007199254740993", "9007199254740993.0", "1e23", "8.98846567431158e307", "1.7976931348623157e308",
+        "1.7976931348623158e308", "1.7976931348623159e308", "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062328e-324", "2.4703282292062327e-324", "1e-400", "1e400",
+        "7.2057594037927933e16", "0.1", "0.30000000000000004", "123456789012345678901234567890e-10",
+        "2.225073858507201136057409796709131975934819546351645648023426109724822222021076945516529523908135087914149158913039621106870086438694594645527657207407820621743379988141063267329253552286881372149012981122451451889849057222307285255133155755015914397476397983411801999323962548289017107081850690630666655994938275772572015763062690663332647565300009245888316433037779791869612049497390377829704905051080609940730262937128958950003583799967207254304360284078895771796150945516748243471030702609144621572289880258182545180325707018860872113128079512233426288368622321503775666622503982534335974568884423900265498198385487948292206894721689831099698365846814022854243330660339850886445804001034933970427567186443383770486037861622771738545623065874679014086723327636718751234567890123456789012345678901e-308",
+        "-0.0", "0.000000000000000000000000000001", "1_000.000_1e1_0",
+    };
+    int failed = 0;
+    int checked = 0;
+    for (const char *literal : hard_cases) {
+        check_float_literal(literal, &failed);
+        checked += 1;
+    }
+
+    // random doubles printed with any precision, and long random digit strings
+    unsigned int state = seed != 0 ? seed : 1;
+    for (int n = 0; n < 200000; n++) {
+        uint64_t bits = ((uint64_t) fuzz_random(&state) << 32) | fuzz_random(&state);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (std::isnan(value) || std::isinf(value)) {
+            continue;
+        }
+        std::string literal;
+        append_float_literal(&literal, value, 1 + fuzz_random(&state) % 17);
+        check_float_literal(literal.c_str(), &failed);
+
+        std::string digits;
+        int count = 1 + fuzz_random(&state) % 40;
+        for (int d = 0; d < count; d++) {
+            digits.push_back('0' + fuzz_random(&state) % 10);
+        }
+        digits.insert(fuzz_random(&state) % (digits.size() + 1), ".");
+        digits += "e" + std::to_string((int) (fuzz_random(&state) % 700) - 350);
+        check_float_literal(digits.c_str(), &failed);
+        checked += 2;
+    }
+
+    // integers
+    const char* const overflowing[] = {
+        "9223372036854775808", "-9223372036854775809", "18446744073709551616", "0x1_0000_0000_0000_0000", "-0x8000000000000001",
+    };
+    for (const char *literal : overflowing) {
+        int64_t value;
+        if (parse_integer_literal(literal, (int) strlen(literal), &value)) {
+            cout << "Int literal " << literal << " has not overflowed: " << value << endl;
+            failed += 1;
+        }
+        checked += 1;
+    }
+    for (int n = 0; n < 100000; n++) {
+        int64_t expected = (int64_t) (((uint64_t) fuzz_random(&state) << 32) | fuzz_random(&state));
+        expected >>= fuzz_random(&state) % 64;
+        char literal[64];
+        if (n % 2 == 0) {
+            snprintf(literal, sizeof(literal), "%lld", (long long) expected);
+        } else {
+            snprintf(literal, sizeof(literal), "0x%llx", (unsigned long long) expected);
+        }
+        int64_t actual;
+        if (!parse_integer_literal(literal, (int) strlen(literal), &actual) || actual != expected) {
+            if (failed < 10) {
+                cout << "Int literal " << literal << ": " << actual << " Expected: " << expected << endl;
+            }
+            failed += 1;
+        }
+        checked += 1;
+    }
+
+    if (failed != 0) {
+        cout << failed << " of " << checked << " number literals were parsed wrong!" << endl;
+    } else {
+        cout << "All number literals were parsed exactly (" << checked << " checked)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// FUZZING
+
+const char* const fuzz_pieces[] = {
+    "hello", "x1", "_d", "_", "Node*", "say**", "`func`", "`", "func", "while", "struct", "true", "null", "void",
+    "#foreign", "#", "0", "123", "-7", "1.5", "17.e2", "1e-23", "1_000", "1.1.1", "12a", ".5",
+    "0x1F", "-0b1_01", "0x", "1e", "1e5.5", "9223372036854775808", "1e400", "0.1234567890123456789012",
+    "\"str\"", "\"esc\\n\\t\"", "\"", "\\", "\"\"\"\nmulti\n\"\"\"\n", "\"\"\"",
+    "// comment\n", "/* block */", "/* /* nested */ */", "/*", "*/",
+    ":=", "::", "->", "...", "..", ".", "==", "!=", "<=", ">>=", "<<", "&&", "||", "+", "-", "*", "/", "%", "=",
+    "(", ")", "{", "}", "[", "]", ";", ",", ":", " ", " ", " ", "\n", "\n", "@", "$", "?", "'",
+};
+const int FUZZ_PIECES_COUNT = sizeof(fuzz_pieces) / sizeof(fuzz_pieces[0]);
+
+unsigned int fuzz_random(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+std::string fuzz_input(unsigned int *state) {
+    std::string input;
+    int count = 1 + fuzz_random(state) % 40;
+    for (int p = 0; p < count; p++) {
+        if (fuzz_random(state) % 16 == 0) {
+            input.push_back((char) (32 + fuzz_random(state) % 95)); // any printable character
+        } else {
+            input.append(fuzz_pieces[fuzz_random(state) % FUZZ_PIECES_COUNT]);
+        }
+    }
+    return input;
+}
+
+// the lines that don't depend on timing or on where in the C++ source an error was raised
+std::string stable_lines(const std::string &text) {
+    const char* const unstable[] = { "Everything took", "Lexed ", "Thread ", "Token arena", "(context: " };
+    std::string result;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        bool is_stable = true;
+        for (const char *prefix : unstable) {
+            is_stable = is_stable && line.compare(0, strlen(prefix), prefix) != 0;
+        }
+        if (is_stable) {
+            result.append(line);
+            result.push_back('\n');
+        }
+    }
+    return result;
+}
+
+std::string run_reference(const char *reference, const char *path) {
+    std::string command = std::string(reference) + " -tokens -file " + path + " 2>&1";
+    std::string text;
+    FILE *pipe = popen(command.c_str(), "r");
+    if (pipe == NULL) {
+        return text;
+    }
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        text.append(buffer, count);
+    }
+    pclose(pipe);
+    return text;
+}
+
+// what compiler.app prints for the input
+std::string run_candidate(const std::string &input) {
+    std::ostringstream text;
+    auto *console = cout.rdbuf(text.rdbuf());
+
+    Lexer *lexer = lexer_create();
+    char *buffer;
+    Output *output = lex_code(lexer, input, &buffer);
+    cout << "Token count: " << output->tokens_count << "\n";
+    for (int t = 0; t < output->tokens_count; t++) {
+        print_token(output, output_token_at(output, t));
+    }
+    print_diagnostics(output);
+    output_free(output);
+    lexer_free(lexer);
+    free(buffer);
+
+    cout.rdbuf(console);
+    return text.str();
+}
+
+int run_fuzz(int iterations, const char *reference, unsigned int seed) {
+    const char *path = "lexertest-fuzz.yw";
+    unsigned int state = seed != 0 ? seed : 1;
+    int failed = 0;
+
+    for (int n = 0; n < iterations; n++) {
+        std::string input = fuzz_input(&state);
+        FILE *file = fopen(path, "wb");
+        fwrite(input.data(), 1, input.size(), file);
+        fclose(file);
+
+        std::string expected = stable_lines(run_reference(reference, path));
+        std::string actual = stable_lines(run_candidate(input));
+        if (expected != actual) {
+            failed += 1;
+            char failure_path[64];
+            snprintf(failure_path, sizeof(failure_path), "lexertest-failure-%d.yw", failed);
+            rename(path, failure_path);
+            cout << "Mismatch on input " << n << ", saved to " << failure_path << "\n"
+                 << "Reference:\n" << expected << "Lexer:\n" << actual << endl;
+        }
+    }
+    remove(path);
+
+    if (failed != 0) {
+        cout << failed << " of " << iterations << " fuzz inputs differ from the reference!" << endl;
+    } else {
+        cout << "All " << iterations << " fuzz inputs match the reference." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// INCREMENTAL
+
+const int RELEX_CHECKS_COUNT = 20000;
+
+// random edits on random inputs, each one is compared with lexing the edited source from the start
+int run_relex_checks(unsigned int seed) {
+    unsigned int state = seed * 7919 + 13;
+    int failed = 0;
+    int edits_count = 0;
+
+    for (int n = 0; n < RELEX_CHECKS_COUNT / 4 && failed < 10; n++) {
+        std::string input = fuzz_input(&state);
+        if (n % 100 == 0) {
+            // long enough for the kept tokens to be moved across chunks
+            std::string piece = input + "\n";
+            while (input.size() < 40000) {
+                input += piece;
+            }
+        }
+        int count = (int) input.size();
+        char *source = (char*) calloc(count + SOURCE_BUFFER_PADDING, 1);
+        memcpy(source, input.data(), count);
+
+        Lexer *lexer = lexer_create();
+        Output *output = lexer_analyze(lexer, source, count);
+        for (int e = 0; e < 4 && failed < 10; e++) {
+            std::string inserted = fuzz_random(&state) % 4 == 0 ? "" : fuzz_pieces[fuzz_random(&state) % FUZZ_PIECES_COUNT];
+            TextEdit edit;
+            edit.offset = fuzz_random(&state) % (count + 1);
+            edit.removed_length = fuzz_random(&state) % 3 == 0 ? fuzz_random(&state) % (count - edit.offset + 1) : 0;
+            edit.inserted = inserted.data();
+            edit.inserted_length = (int) inserted.size();
+
+            int edited_count;
+            char *edited = text_edit_apply(source, count, edit, &edited_count);
+            lexer_relex(lexer, output, edited, edited_count, edit);
+
+            Lexer *full_lexer = lexer_create();
+            Output *full = lexer_analyze(full_lexer, edited, edited_count);
+            std::string expected = format_output(full);
+            std::string actual = format_output(output);
+            if (expected != actual) {
+                failed += 1;
+                cout << "Re-lexing mismatch after replacing " << edit.removed_length << " characters at " << edit.offset
+                     << " with \"" << inserted << "\" in:\n" << std::string(source, count) << "\n\nExpected:\n"
+                     << expected << "Re-lexed:\n" << actual << endl;
+            }
+            output_free(full);
+            lexer_free(full_lexer);
+
+            free(source);
+            source = edited;
+            count = edited_count;
+            edits_count += 1;
+        }
+        output_free(output);
+        lexer_free(lexer);
+        free(source);
+    }
+
+    if (failed != 0) {
+        cout << failed << " re-lexed edits differ from lexing again!" << endl;
+    } else {
+        cout << "All re-lexed edits match lexing again (" << edits_count << " checked)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// PARALLEL
+
+const int PARALLEL_CHECK_MAX_CHUNK_SIZE = 64;
+const int PARALLEL_CHECK_FUZZ_COUNT = 2000;
+
+// asks for more workers than there are characters, so the chunk size is the minimum
+// the thread pool never starts more threads than there are chunks
+const int PARALLEL_CHECK_WORKERS_COUNT = std::numeric_limits<int>::max();
+
+// lexes the input with every chunk size from first to last, and compares each with lexer_analyze
+bool check_parallel(const std::string &input, int first_chunk_size, int last_chunk_size, const std::string &name) {
+    Lexer *lexer = lexer_create();
+    char *buffer;
+    Output *output = lex_code(lexer, input, &buffer);
+    std::string expected_tokens = format_tokens(output);
+    std::string expected_diagnostics = format_diagnostics(output);
+    output_free(output);
+    lexer_free(lexer);
+
+    bool is_passing = true;
+    for (int size = first_chunk_size; size <= last_chunk_size && is_passing; size++) {
+        Lexer *parallel_lexer = lexer_create();
+        Output *parallel = lexer_analyze_parallel(parallel_lexer, buffer, (int) input.size(),
+                                                  PARALLEL_CHECK_WORKERS_COUNT, size);
+        std::string tokens = format_tokens(parallel);
+        std::string diagnostics = format_diagnostics(parallel);
+        if (tokens != expected_tokens || diagnostics != expected_diagnostics) {
+            is_passing = false;
+            cout << "Parallel lexing mismatch in " << name << " with chunks of " << size << ":\n" << input
+                 << "\n\nExpected:\n" << expected_tokens << expected_diagnostics
+                 << "Lexed in chunks:\n" << tokens << diagnostics << endl;
+        }
+        output_free(parallel);
+        lexer_free(parallel_lexer);
+    }
+    free(buffer);
+    return is_passing;
+}
+
+// every case with every chunk size, then random inputs with one chunk size each
+int run_parallel_checks(std::vector<LexerTestCase> &cases, unsigned int seed) {
+    int failed = 0;
+    for (auto &test_case : cases) {
+        if (!check_parallel(test_case.code, 1, PARALLEL_CHECK_MAX_CHUNK_SIZE, test_case.name)) {
+            failed += 1;
+        }
+    }
+
+    unsigned int state = seed * 6007 + 29;
+    for (int n = 0; n < PARALLEL_CHECK_FUZZ_COUNT && failed < 10; n++) {
+        std::string input = fuzz_input(&state);
+        int size = 1 + n % PARALLEL_CHECK_MAX_CHUNK_SIZE;
+        if (!check_parallel(input, size, size, "fuzz input " + std::to_string(n))) {
+            failed += 1;
+        }
+    }
+
+    if (failed != 0) {
+        cout << failed << " inputs lexed in chunks differ from lexing them at once!" << endl;
+    } else {
+        cout << "All inputs lexed in chunks match lexing them at once (" << cases.size() << " cases, "
+             << PARALLEL_CHECK_FUZZ_COUNT << " fuzz inputs)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// STREAMING
+
+const int STREAM_CHECK_MIN_WINDOW_SIZE = 16;
+const int STREAM_CHECK_MAX_WINDOW_SIZE = 64;
+const int STREAM_CHECK_FUZZ_COUNT = 2000;
+
+struct StreamedOutput {
+    std::string tokens;
+    std::string diagnostics;
+    int batches_count;
+};
+typedef struct StreamedOutput StreamedOutput;
+
+// the cursors are in the whole input, the window's output starts at the window's cursor
+void append_stream_batch(Output *output, void *context) {
+    auto *streamed = (StreamedOutput*) context;
+    streamed->tokens += format_tokens(output);
+    streamed->diagnostics += format_diagnostics(output);
+    streamed->batches_count += 1;
+}
+
+// the input is written into a pipe on another thread, so a read never gets more than is there
+bool stream_through_pipe(const std::string &input, int window_size, StreamedOutput *streamed) {
+    int descriptors[2];
+    if (pipe(descriptors) != 0) {
+        return false;
+    }
+    std::thread writer([&input, &descriptors] {
+        size_t written = 0;
+        while (written < input.size()) {
+            ssize_t count = write(descriptors[1], input.data() + written, input.size() - written);
+            if (count <= 0) {
+                break;
+            }
+            written += count;
+        }
+        close(descriptors[1]);
+    });
+
+    Lexer *lexer = lexer_create();
+    bool is_read = lexer_analyze_stream(lexer, descriptors[0], window_size, append_stream_batch, streamed);
+    lexer_free(lexer);
+    writer.join();
+    close(descriptors[0]);
+    return is_read;
+}
+
+// streams the input with every window size from first to last, the batches joined have to be what lexer_analyze gives
+bool check_stream(const std::string &input, int first_window_size, int last_window_size, const std::string &name) {
+    Lexer *lexer = lexer_create();
+    char *buffer;
+    Output *output = lex_code(lexer, input, &buffer);
+    std::string expected_tokens = format_tokens(output);
+    std::string expected_diagnostics = format_diagnostics(output);
+    output_free(output);
+    lexer_free(lexer);
+    free(buffer);
+
+    bool is_passing = true;
+    for (int size = first_window_size; size <= last_window_size && is_passing; size++) {
+        StreamedOutput streamed;
+        streamed.batches_count = 0;
+        if (!stream_through_pipe(input, size, &streamed)) {
+            is_passing = false;
+            cout << "Could not stream " << name << " through a pipe" << endl;
+        } else if (streamed.tokens != expected_tokens) {
+            is_passing = false;
+            cout << "Streamed tokens mismatch in " << name << " with windows of " << size << ":\n" << input
+                 << "\n\nExpected:\n" << expected_tokens << "Streamed in " << streamed.batches_count
+                 << " batches:\n" << streamed.tokens << endl;
+        } else if (streamed.diagnostics != expected_diagnostics) {
+            is_passing = false;
+            cout << "Streamed diagnostics mismatch in " << name << " with windows of " << size << ":\n" << input
+                 << "\n\nExpected:\n" << expected_diagnostics << "Streamed in " << streamed.batches_count
+                 << " batches:\n" << streamed.diagnostics << endl;
+        }
+    }
+    return is_passing;
+}
+
+// every case with every window size, then random inputs with one window size each
+int run_stream_checks(std::vector<LexerTestCase> &cases, unsigned int seed) {
+    int failed = 0;
+    for (auto &test_case : cases) {
+        if (!check_stream(test_case.code, STREAM_CHECK_MIN_WINDOW_SIZE, STREAM_CHECK_MAX_WINDOW_SIZE, test_case.name)) {
+            failed += 1;
+        }
+    }
+
+    unsigned int state = seed * 4001 + 17;
+    int sizes_count = STREAM_CHECK_MAX_WINDOW_SIZE - STREAM_CHECK_MIN_WINDOW_SIZE + 1;
+    for (int n = 0; n < STREAM_CHECK_FUZZ_COUNT && failed < 10; n++) {
+        std::string input = fuzz_input(&state);
+        int size = STREAM_CHECK_MIN_WINDOW_SIZE + n % sizes_count;
+        if (!check_stream(input, size, size, "fuzz input " + std::to_string(n))) {
+            failed += 1;
+        }
+    }
+
+    // a stream that stops at a read error leaves the lexer in the middle of a window, the next file still gets its errors
+    Lexer *lexer = lexer_create();
+    lexer->is_speculative = true;
+    char *buffer;
+    Output *output = lex_code(lexer, "a := \"unterminated", &buffer);
+    if (output->diagnostics.count == 0) {
+        failed += 1;
+        cout << "A lexer that was speculative has dropped the errors of the next file" << endl;
+    }
+    output_free(output);
+    lexer_free(lexer);
+    free(buffer);
+
+    if (failed != 0) {
+        cout << failed << " streamed inputs differ from lexing them at once!" << endl;
+    } else {
+        cout << "All streamed inputs match lexing them at once (" << cases.size() << " cases, "
+             << STREAM_CHECK_FUZZ_COUNT << " fuzz inputs)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// FORMATS
+
+const char* const FORMAT_CHECK_CODE = "a := \"x\\ty\" 12 1.5 true\nif null";
+const char* const FORMAT_CHECK_JSON =
+    "{\"kind\":\"Identifier\",\"value\":\"a\",\"start\":[1,0],\"end\":[1,0]}\n"
+    "{\"kind\":\"Operator\",\"value\":\":=\",\"start\":[1,2],\"end\":[1,3]}\n"
+    "{\"kind\":\"String\",\"value\":\"x\\ty\",\"start\":[1,5],\"end\":[1,10]}\n"
+    "{\"kind\":\"Int\",\"value\":12,\"start\":[1,12],\"end\":[1,13]}\n"
+    "{\"kind\":\"Float\",\"value\":1.5,\"start\":[1,15],\"end\":[1,17]}\n"
+    "{\"kind\":\"Bool\",\"value\":true,\"start\":[1,19],\"end\":[1,22]}\n"
+    "{\"kind\":\"Keyword\",\"value\":\"if\",\"start\":[2,0],\"end\":[2,1]}\n"
+    "{\"kind\":\"Null\",\"start\":[2,3],\"end\":[2,6]}\n"
+    "{\"kind\":\"EOF\",\"start\":[2,7],\"end\":[2,7]}\n";
+
+std::string write_tokens(Output *output, TokenFormat format) {
+    std::ostringstream text;
+    TokenWriter writer;
+    token_writer_init(&writer, &text, format);
+    token_writer_header(&writer);
+    token_writer_output(&writer, output);
+    token_writer_free(&writer);
+    return text.str();
+}
+
+// json against the expected lines, text against print_token,
+// and binary read back into the kinds and offsets
+int run_format_checks() {
+    Lexer *lexer = lexer_create();
+    char *buffer;
+    Output *output = lex_code(lexer, FORMAT_CHECK_CODE, &buffer);
+    int failed = 0;
+
+    std::string json = write_tokens(output, TOKEN_FORMAT_JSON);
+    if (json != FORMAT_CHECK_JSON) {
+        failed += 1;
+        cout << "JSON tokens don't match:\n" << json << "Expected:\n" << FORMAT_CHECK_JSON;
+    }
+
+    std::ostringstream printed;
+    auto *console = cout.rdbuf(printed.rdbuf());
+    for (int t = 0; t < output->tokens_count; t++) {
+        print_token(output, output_token_at(output, t));
+    }
+    cout.rdbuf(console);
+    if (write_tokens(output, TOKEN_FORMAT_TEXT) != printed.str()) {
+        failed += 1;
+        cout << "Text tokens don't match print_token:\n" << printed.str();
+    }
+
+    std::string binary = write_tokens(output, TOKEN_FORMAT_BINARY);
+    const char *cursor = binary.data() + 8;
+    const char *end = binary.data() + binary.size();
+    int count = 0;
+    bool is_matching = binary.compare(0, 4, "YWTK") == 0;
+    while (is_matching && cursor < end) {
+        Token token = output_token_at(output, count++);
+        uint32_t offsets[2];
+        memcpy(offsets, cursor + 1, sizeof(offsets));
+        is_matching = (uint8_t) cursor[0] == token.type && offsets[0] == token.offset && offsets[1] == token.end_offset;
+        cursor += 1 + sizeof(offsets);
+
+        int text_length;
+        if (token.type == INTLITERAL || token.type == FLOATLITERAL) {
+            cursor += 8;
+        } else if (token.type == BOOLLITERAL || token.type == KEYWORD) {
+            cursor += 1;
+        } else if (token_text(output, &token, &text_length) != NULL) {
+            uint32_t length;
+            memcpy(&length, cursor, sizeof(length));
+            is_matching = is_matching && (int) length == text_length;
+            cursor += sizeof(length) + length;
+        }
+    }
+    if (!is_matching || cursor != end || count != output->tokens_count) {
+        failed += 1;
+        cout << "Binary tokens don't match after " << count << " tokens" << endl;
+    }
+
+    output_free(output);
+    lexer_free(lexer);
+    free(buffer);
+
+    if (failed != 0) {
+        cout << failed << " token formats are wrong!" << endl;
+    } else {
+        cout << "All token formats are as documented." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *cases_path = LEXER_TEST_DEFAULT_CASES;
+    const char *reference = NULL;
+    int fuzz_iterations = 0;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "-fuzz") == 0 && has_value) {
+            fuzz_iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-reference") == 0 && has_value) {
+            reference = argv[++i];
+        } else if (strcmp(argv[i], "-seed") == 0 && has_value) {
+            seed = (unsigned int) strtoul(argv[++i], NULL, 10);
+        } else {
+            cases_path = argv[i];
+        }
+    }
+
+    if (fuzz_iterations > 0) {
+        if (reference == NULL) {
+            cout << "Fuzzing needs a -reference build" << endl;
+            return 1;
+        }
+        return run_fuzz(fuzz_iterations, reference, seed);
+    }
+    std::vector<LexerTestCase> cases;
+    if (!load_test_cases(cases_path, &cases)) {
+        return 1;
+    }
+    int result = run_test_cases(cases);
+    result |= run_cache_checks();
+    result |= run_parallel_checks(cases, seed);
+    result |= run_stream_checks(cases, seed);
+    result |= run_number_checks(seed);
+    result |= run_format_checks();
+    return run_relex_checks(seed) | result;
+}
@@ -0,0 +1,131 @@
+//
+//  ThreadPool.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <chrono>
+
+// Runs a known number of jobs on a pool of workers.
+// Jobs are dealt out to the workers' own queues up front,
+// a worker takes from the back of its own queue, and steals from the front of the others' when it runs out.
+
+typedef void (*ThreadPoolJob)(int job, int worker, void *context);
+
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<int> jobs;
+};
+typedef struct WorkerQueue WorkerQueue;
+
+struct ThreadPoolStats {
+    int workers_count;
+    double wall_seconds;
+    double *busy_seconds; // per worker
+    int *jobs_done; // per worker
+    int *jobs_stolen; // per worker
+};
+typedef struct ThreadPoolStats ThreadPoolStats;
+
+int thread_pool_default_workers_count() {
+    int count = (int) std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+bool worker_queue_pop(WorkerQueue *queue, int *job) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->jobs.empty()) {
+        return false;
+    }
+    *job = queue->jobs.back();
+    queue->jobs.pop_back();
+    return true;
+}
+
+bool worker_queue_steal(WorkerQueue *queue, int *job) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->jobs.empty()) {
+        return false;
+    }
+    *job = queue->jobs.front();
+    queue->jobs.pop_front();
+    return true;
+}
+
+void thread_pool_worker(WorkerQueue *queues, int worker, ThreadPoolJob function, void *context,
+                        ThreadPoolStats *stats) {
+    int count = stats->workers_count;
+
+    while (true) {
+        int job;
+        bool found = worker_queue_pop(&queues[worker], &job);
+
+        // no jobs are added while running, so if all queues are empty, we're done
+        for (int w = 1; !found && w < count; w++) {
+            found = worker_queue_steal(&queues[(worker + w) % count], &job);
+            if (found) {
+                stats->jobs_stolen[worker] += 1;
+            }
+        }
+        if (!found) {
+            return;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        function(job, worker, context);
+        auto stop = std::chrono::high_resolution_clock::now();
+
+        stats->busy_seconds[worker] += std::chrono::duration<double>(stop - start).count();
+        stats->jobs_done[worker] += 1;
+    }
+}
+
+// blocks until all jobs are done, the caller frees the stats with thread_pool_stats_free
+ThreadPoolStats thread_pool_run(int workers_count, int jobs_count, ThreadPoolJob function, void *context) {
+    if (workers_count > jobs_count) {
+        workers_count = jobs_count > 0 ? jobs_count : 1;
+    }
+
+    ThreadPoolStats stats;
+    stats.workers_count = workers_count;
+    stats.busy_seconds = (double*) calloc(workers_count, sizeof(double));
+    stats.jobs_done = (int*) calloc(workers_count, sizeof(int));
+    stats.jobs_stolen = (int*) calloc(workers_count, sizeof(int));
+
+    WorkerQueue *queues = new WorkerQueue[workers_count];
+    for (int job = 0; job < jobs_count; job++) {
+        queues[job % workers_count].jobs.push_back(job);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // the calling thread is the first worker
+    std::thread *threads = new std::thread[workers_count];
+    for (int w = 1; w < workers_count; w++) {
+        threads[w] = std::thread(thread_pool_worker, queues, w, function, context, &stats);
+    }
+    thread_pool_worker(queues, 0, function, context, &stats);
+    for (int w = 1; w < workers_count; w++) {
+        threads[w].join();
+    }
+
+    auto stop = std::chrono::high_resolution_clock::now();
+    stats.wall_seconds = std::chrono::duration<double>(stop - start).count();
+
+    delete[] threads;
+    delete[] queues;
+    return stats;
+}
+
+void thread_pool_stats_free(ThreadPoolStats *stats) {
+    free(stats->busy_seconds);
+    free(stats->jobs_done);
+    free(stats->jobs_stolen);
+}
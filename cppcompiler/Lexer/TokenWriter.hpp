@@ -0,0 +1,334 @@
+//
+//  TokenWriter.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "Lexer.hpp"
+#include <ostream>
+
+// Writes tokens into a large buffer that goes to the stream only when it's full or flushed,
+// instead of one stream write per value and a flush per token.
+//
+// TOKEN_FORMAT_TEXT    what print_token always printed: [Identifier hello 1:0 - 1:4]
+// TOKEN_FORMAT_JSON    one object per line:
+//                      {"kind":"Identifier","value":"hello","start":[1,0],"end":[1,4]}
+//                      the value is a string, a number, a bool, or missing for Null, Void and EOF
+// TOKEN_FORMAT_BINARY  "YWTK" and a uint32_t version for each file, then for each token
+//                      a uint8_t kind, a uint32_t offset and end offset, and the value:
+//                      int64_t for ints, double for floats, uint8_t for bools and keywords,
+//                      a uint32_t length and the characters for everything with a text value, nothing otherwise
+//                      all little-endian and unaligned, offsets are in bytes from the start of the source
+
+const int TOKEN_WRITER_CAPACITY = 1 << 20;
+const uint32_t TOKEN_BINARY_VERSION = 1;
+
+enum TokenFormat {
+    TOKEN_FORMAT_TEXT, TOKEN_FORMAT_JSON, TOKEN_FORMAT_BINARY
+};
+typedef enum TokenFormat TokenFormat;
+
+const char* const token_kind_names[] = {
+    "Identifier", "Punctuator", "Directive", "Operator", "Comment", "Separator",
+    "Null", "Void", "Int", "Float", "Bool", "String", "Keyword", "EOF"
+};
+
+struct TokenWriter {
+    std::ostream *stream;
+    TokenFormat format;
+    char *buffer;
+    int length;
+    int capacity;
+
+    // the line of the last cursor, tokens come in order so lines are found walking forward
+    int line;
+};
+typedef struct TokenWriter TokenWriter;
+
+void token_writer_init(TokenWriter *writer, std::ostream *stream, TokenFormat format) {
+    writer->stream = stream;
+    writer->format = format;
+    writer->buffer = (char*) malloc(TOKEN_WRITER_CAPACITY);
+    writer->length = 0;
+    writer->capacity = TOKEN_WRITER_CAPACITY;
+    writer->line = 0;
+}
+
+void token_writer_flush(TokenWriter *writer) {
+    writer->stream->write(writer->buffer, writer->length);
+    writer->length = 0;
+}
+
+void token_writer_free(TokenWriter *writer) {
+    token_writer_flush(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+}
+
+// WRITING VALUES
+
+// makes room for this many more characters
+inline char* token_writer_reserve(TokenWriter *writer, int count) {
+    if (writer->length + count > writer->capacity) {
+        token_writer_flush(writer);
+    }
+    return writer->buffer + writer->length;
+}
+
+inline void token_writer_bytes(TokenWriter *writer, const void *bytes, int count) {
+    if (count > writer->capacity / 2) {
+        token_writer_flush(writer);
+        writer->stream->write((const char*) bytes, count);
+        return;
+    }
+    memcpy(token_writer_reserve(writer, count), bytes, count);
+    writer->length += count;
+}
+
+inline void token_writer_string(TokenWriter *writer, const char *string) {
+    token_writer_bytes(writer, string, strlen(string));
+}
+
+inline void token_writer_character(TokenWriter *writer, char character) {
+    *token_writer_reserve(writer, 1) = character;
+    writer->length += 1;
+}
+
+inline void token_writer_int(TokenWriter *writer, int64_t value) {
+    char digits[20];
+    int count = 0;
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    char *characters = token_writer_reserve(writer, count + 1);
+    if (value < 0) {
+        *characters++ = '-';
+        writer->length += 1;
+    }
+    for (int d = 0; d < count; d++) {
+        characters[d] = digits[count - 1 - d];
+    }
+    writer->length += count;
+}
+
+// 17 significant digits, so it reads back exactly, like cout with max_digits10
+void token_writer_double(TokenWriter *writer, double value) {
+    char *characters = token_writer_reserve(writer, 32);
+    writer->length += snprintf(characters, 32, "%.17g", value);
+}
+
+// with the quotes, control characters are escaped as \u00XX
+void token_writer_json_string(TokenWriter *writer, const char *characters, int length) {
+    token_writer_character(writer, '"');
+    int run = 0; // characters that don't need escaping
+    for (int c = 0; c < length; c++) {
+        unsigned char character = characters[c];
+        if (character >= 0x20 && character != '"' && character != '\\') {
+            continue;
+        }
+        token_writer_bytes(writer, characters + run, c - run);
+        run = c + 1;
+        switch (character) {
+            case '"': token_writer_string(writer, "\\\""); break;
+            case '\\': token_writer_string(writer, "\\\\"); break;
+            case '\n': token_writer_string(writer, "\\n"); break;
+            case '\r': token_writer_string(writer, "\\r"); break;
+            case '\t': token_writer_string(writer, "\\t"); break;
+            default: {
+                const char *hex = "0123456789abcdef";
+                char escaped[6] = { '\\', 'u', '0', '0', hex[character >> 4], hex[character & 15] };
+                token_writer_bytes(writer, escaped, 6);
+            }
+        }
+    }
+    token_writer_bytes(writer, characters + run, length - run);
+    token_writer_character(writer, '"');
+}
+
+// the cursor of an offset that is at or after the last one, see output_cursor_at
+Cursor token_writer_cursor(TokenWriter *writer, Output *output, unsigned int offset) {
+    auto *table = &output->lines;
+    if (!table->is_built || writer->line >= table->count || table->starts[writer->line] > offset) {
+        Cursor cursor = output_cursor_at(output, offset);
+        writer->line = cursor.line_number - output->source_cursor.line_number;
+        return cursor;
+    }
+    while (writer->line + 1 < table->count && table->starts[writer->line + 1] <= offset) {
+        writer->line += 1;
+    }
+
+    Cursor cursor;
+    cursor.line_number = output->source_cursor.line_number + writer->line;
+    cursor.character = offset - table->starts[writer->line];
+    if (writer->line == 0) {
+        cursor.character += output->source_cursor.character;
+    }
+    return cursor;
+}
+
+// the characters of a token with a text value, NULL for the others
+const char* token_text(Output *output, Token *token, int *length) {
+    switch (token->type) {
+        case IDENTIFIER: case DIRECTIVE:
+            *length = interner_length(output->interner, token->symbol);
+            return interner_characters(output->interner, token->symbol);
+        case KEYWORD:
+            *length = strlen(keyword_names[token->keyword]);
+            return keyword_names[token->keyword];
+        case PUNCTUATOR: case OPERATOR: case SEPARATOR: case STRINGLITERAL: case COMMENT:
+            *length = token->stringValue.length;
+            return output_slice_characters(output, token->stringValue);
+        default:
+            *length = 0;
+            return NULL;
+    }
+}
+
+// FORMATS
+
+void token_writer_text(TokenWriter *writer, Output *output, Token *token) {
+    int length;
+    const char *text = token_text(output, token, &length);
+    switch (token->type) {
+        case STRINGLITERAL:
+            token_writer_string(writer, "[String Literal \"");
+            token_writer_bytes(writer, text, length);
+            token_writer_character(writer, '"');
+            break;
+        case SEPARATOR: case IDENTIFIER: case DIRECTIVE: case KEYWORD: case OPERATOR: case PUNCTUATOR:
+            token_writer_character(writer, '[');
+            token_writer_string(writer, token_kind_names[token->type]);
+            token_writer_character(writer, ' ');
+            token_writer_bytes(writer, text, length);
+            break;
+        case NULLLITERAL: token_writer_string(writer, "[Null"); break;
+        case VOIDLITERAL: token_writer_string(writer, "[Void"); break;
+        case BOOLLITERAL: token_writer_string(writer, token->boolValue ? "[Bool true" : "[Bool false"); break;
+        case ENDOFFILE: token_writer_string(writer, "[Token EOF"); break;
+        case INTLITERAL:
+            token_writer_string(writer, "[Literal ");
+            token_writer_int(writer, token->intValue);
+            break;
+        case FLOATLITERAL:
+            token_writer_string(writer, "[Literal ");
+            token_writer_double(writer, token->doubleValue);
+            break;
+        default:
+            token_writer_string(writer, "[Not implemented: Type: ");
+            token_writer_int(writer, token->type);
+    }
+
+    Cursor start = token_writer_cursor(writer, output, token->offset);
+    Cursor end = token_writer_cursor(writer, output, token->end_offset);
+    token_writer_character(writer, ' ');
+    token_writer_int(writer, start.line_number);
+    token_writer_character(writer, ':');
+    token_writer_int(writer, start.character);
+    token_writer_string(writer, " - ");
+    token_writer_int(writer, end.line_number);
+    token_writer_character(writer, ':');
+    token_writer_int(writer, end.character);
+    token_writer_string(writer, "]\n");
+}
+
+void token_writer_json(TokenWriter *writer, Output *output, Token *token) {
+    token_writer_string(writer, "{\"kind\":\"");
+    token_writer_string(writer, token_kind_names[token->type]);
+    token_writer_character(writer, '"');
+
+    int length;
+    const char *text = token_text(output, token, &length);
+    if (text != NULL) {
+        token_writer_string(writer, ",\"value\":");
+        token_writer_json_string(writer, text, length);
+    } else if (token->type == INTLITERAL) {
+        token_writer_string(writer, ",\"value\":");
+        token_writer_int(writer, token->intValue);
+    } else if (token->type == FLOATLITERAL) {
+        token_writer_string(writer, ",\"value\":");
+        token_writer_double(writer, token->doubleValue);
+    } else if (token->type == BOOLLITERAL) {
+        token_writer_string(writer, token->boolValue ? ",\"value\":true" : ",\"value\":false");
+    }
+
+    Cursor start = token_writer_cursor(writer, output, token->offset);
+    Cursor end = token_writer_cursor(writer, output, token->end_offset);
+    token_writer_string(writer, ",\"start\":[");
+    token_writer_int(writer, start.line_number);
+    token_writer_character(writer, ',');
+    token_writer_int(writer, start.character);
+    token_writer_string(writer, "],\"end\":[");
+    token_writer_int(writer, end.line_number);
+    token_writer_character(writer, ',');
+    token_writer_int(writer, end.character);
+    token_writer_string(writer, "]}\n");
+}
+
+void token_writer_binary(TokenWriter *writer, Output *output, Token *token) {
+    uint8_t kind = token->type;
+    uint32_t offsets[2] = { token->offset, token->end_offset };
+    token_writer_bytes(writer, &kind, sizeof(kind));
+    token_writer_bytes(writer, offsets, sizeof(offsets));
+
+    if (token->type == INTLITERAL) {
+        token_writer_bytes(writer, &token->intValue, sizeof(int64_t));
+    } else if (token->type == FLOATLITERAL) {
+        token_writer_bytes(writer, &token->doubleValue, sizeof(double));
+    } else if (token->type == BOOLLITERAL || token->type == KEYWORD) {
+        uint8_t value = token->type == BOOLLITERAL ? (uint8_t) token->boolValue : (uint8_t) token->keyword;
+        token_writer_bytes(writer, &value, sizeof(value));
+    } else {
+        int length;
+        const char *text = token_text(output, token, &length);
+        if (text != NULL) {
+            uint32_t count = length;
+            token_writer_bytes(writer, &count, sizeof(count));
+            token_writer_bytes(writer, text, length);
+        }
+    }
+}
+
+void token_writer_token(TokenWriter *writer, Output *output, Token token) {
+    switch (writer->format) {
+        case TOKEN_FORMAT_TEXT: token_writer_text(writer, output, &token); break;
+        case TOKEN_FORMAT_JSON: token_writer_json(writer, output, &token); break;
+        case TOKEN_FORMAT_BINARY: token_writer_binary(writer, output, &token); break;
+    }
+}
+
+// before the tokens of each file, the tokens of a file can be written in more than one output
+// the kinds are all below 'Y', so the header can't be mistaken for a token
+void token_writer_header(TokenWriter *writer) {
+    if (writer->format == TOKEN_FORMAT_BINARY) {
+        token_writer_bytes(writer, "YWTK", 4);
+        token_writer_bytes(writer, &TOKEN_BINARY_VERSION, sizeof(TOKEN_BINARY_VERSION));
+    }
+}
+
+void token_writer_output(TokenWriter *writer, Output *output) {
+    writer->line = 0;
+    for (int i = 0; i < output->tokens_count; i++) {
+        token_writer_token(writer, output, output_token_at(output, i));
+    }
+}
+
+// a single token in the text format, straight to cout
+void print_token(Output *output, Token token) {
+    char buffer[256];
+    TokenWriter writer;
+    writer.stream = &cout;
+    writer.format = TOKEN_FORMAT_TEXT;
+    writer.buffer = buffer;
+    writer.length = 0;
+    writer.capacity = sizeof(buffer);
+    writer.line = 0;
+    token_writer_text(&writer, output, &token);
+    token_writer_flush(&writer);
+}
@@ -1,39 +1,336 @@
-#include <chrono> 
+#include <chrono>
 #include "main.h"
 
-using namespace std::chrono; 
+using namespace std::chrono;
+
+// LEXING JOBS
+
+struct LexJobs {
+    RunArguments *arguments;
+    Lexer **lexers; // one per worker, reused for every file it lexes
+    SourceBuffer *sources; // per file
+    bool *is_loaded; // per file
+    Output **outputs; // per file
+    bool *is_cached; // per file, loaded from the cache instead of lexed
+    int file_workers_count; // threads for a single file
+};
+typedef struct LexJobs LexJobs;
+
+void lex_file_job(int job, int worker, void *context) {
+    auto *jobs = (LexJobs*) context;
+
+    auto *source = &jobs->sources[job];
+    jobs->is_loaded[job] = source_buffer_open(source, jobs->arguments->file_paths[job]);
+    if (!jobs->is_loaded[job]) {
+        return;
+    }
+    auto *lexer = jobs->lexers[worker];
+    char *cache_directory = jobs->arguments->cache_directory;
+    if (cache_directory == NULL) {
+        jobs->outputs[job] = lexer_analyze_parallel(lexer, source->characters, source->length, jobs->file_workers_count,
+                                                     LEXER_PARALLEL_MIN_CHUNK_SIZE);
+        return;
+    }
+
+    // a changed file has a different hash, so it is never found
+    uint64_t hash = source_hash(source->characters, source->length);
+    char path[4096];
+    token_cache_path(path, sizeof(path), cache_directory, hash);
+    jobs->outputs[job] = token_cache_load(lexer, path, source->characters, source->length, hash);
+    jobs->is_cached[job] = jobs->outputs[job] != NULL;
+    if (!jobs->is_cached[job]) {
+        jobs->outputs[job] = lexer_analyze_parallel(lexer, source->characters, source->length, jobs->file_workers_count,
+                                                     LEXER_PARALLEL_MIN_CHUNK_SIZE);
+        token_cache_write(jobs->outputs[job], path, hash);
+    }
+}
+
+// STREAMING
+
+const int STREAM_WINDOW_SIZE = 1 << 16;
+
+struct StreamPrinter {
+    TokenWriter *writer; // NULL when the tokens are not printed
+    int tokens_count;
+    int largest_batch;
+    int errors_count;
+};
+typedef struct StreamPrinter StreamPrinter;
+
+void print_stream_tokens(Output *output, void *context) {
+    auto *printer = (StreamPrinter*) context;
+    if (printer->writer != NULL) {
+        token_writer_output(printer->writer, output);
+        token_writer_flush(printer->writer);
+    }
+    print_diagnostics(output);
+    printer->tokens_count += output->tokens_count;
+    printer->errors_count += output->diagnostics.count;
+    if (output->tokens_count > printer->largest_batch) {
+        printer->largest_batch = output->tokens_count;
+    }
+}
+
+// lexes the files one after another, one window at a time
+// returns the number of errors in all files
+int stream_files(RunArguments *arguments, TokenWriter *writer) {
+    auto *lexer = lexer_create();
+    auto start = high_resolution_clock::now();
+    int errors_count = 0;
+
+    for (int f = 0; f < arguments->file_paths_count; f++) {
+        char *path = arguments->file_paths[f];
+        int descriptor = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+        if (descriptor < 0) {
+            cout << "Could not load file: " << path << endl;
+            exit(1);
+        }
+        if (arguments->file_paths_count > 1) {
+            cout << "File: " << path << endl;
+        }
+
+        StreamPrinter printer;
+        memset(&printer, 0, sizeof(printer));
+        printer.writer = writer;
+        if (writer != NULL) {
+            token_writer_header(writer);
+        }
+        if (!lexer_analyze_stream(lexer, descriptor, STREAM_WINDOW_SIZE, print_stream_tokens, &printer)) {
+            cout << "Could not read file: " << path << endl;
+            exit(1);
+        }
+        if (descriptor != STDIN_FILENO) {
+            close(descriptor);
+        }
+        cout << "Token count: " << printer.tokens_count << endl;
+        cout << "Largest batch: " << printer.largest_batch << " tokens" << endl;
+        errors_count += printer.errors_count;
+    }
+
+    auto stop = high_resolution_clock::now();
+    auto seconds = (double) duration_cast<microseconds>(stop - start).count() / 1000000;
+    cout.precision(2);
+    cout << "Everything took " << seconds << " sec." << endl;
+    lexer_free(lexer);
+    return errors_count;
+}
+
+// PIPELINE
+
+// lexes and parses the files one after another, each on two threads at once
+// returns the number of errors in all files
+int pipeline_files(RunArguments *arguments) {
+    auto *lexer = lexer_create();
+    auto *parser = parser_create();
+    auto start = high_resolution_clock::now();
+    int errors_count = 0;
+    long nodes_count = 0;
+    int peak_tokens = 0; // of any file
+
+    for (int f = 0; f < arguments->file_paths_count; f++) {
+        char *path = arguments->file_paths[f];
+        SourceBuffer source;
+        if (!source_buffer_open(&source, path)) {
+            cout << "Could not load file: " << path << endl;
+            exit(1);
+        }
+        if (arguments->file_paths_count > 1) {
+            cout << "File: " << path << endl;
+        }
+
+        int file_peak_tokens;
+        auto *ast = lexer_parse_pipelined(lexer, parser, source.characters, source.length, &file_peak_tokens);
+        peak_tokens = std::max(peak_tokens, file_peak_tokens);
+        auto *output = ast->output;
+        cout << "Token count: " << output->tokens_count << endl;
+        print_diagnostics(output);
+        if (arguments->flags & ShouldPrintAst) {
+            cout << ast_format(ast);
+        }
+        print_parser_error(ast);
+        errors_count += output->diagnostics.count + ast->has_failed;
+        nodes_count += ast->arena.count - 1;
+        ast_free(ast);
+        output_free(output);
+        source_buffer_free(&source);
+    }
+
+    auto stop = high_resolution_clock::now();
+    auto seconds = (double) duration_cast<microseconds>(stop - start).count() / 1000000;
+    cout.precision(2);
+    cout << "Everything took " << seconds << " sec." << endl;
+    cout << "Parsed " << arguments->file_paths_count << " files, " << nodes_count << " nodes, "
+         << "at most " << peak_tokens << " tokens in memory" << endl;
+    parser_free(parser);
+    lexer_free(lexer);
+    return errors_count;
+}
 
 int main(int argc, char **argv) {
     auto *arguments = parse_arguments(argc, argv);
 
-    if (arguments == NULL || arguments->file_path == NULL) {
+    if (arguments == NULL || arguments->file_paths_count == 0) {
         cout << "Could not parse arguments" << endl;
         exit(1);
     }
 
-    // read program file
-    char* file_buffer = load_file_into_buffer(arguments->file_path);
-    if (file_buffer == NULL) {
-        cout << "Could not load file: " << arguments->file_path << endl;
-        exit(1);
+    // the tokens are not kept, so -tokens and -types are ignored with -pipeline
+    if (arguments->is_pipelined) {
+        return pipeline_files(arguments) > 0 ? 1 : 0;
+    }
+
+    // the tokens are only printed with -tokens
+    std::ofstream tokens_file;
+    TokenWriter writer;
+    bool should_print_tokens = (arguments->flags & ShouldPrintTokens) != 0;
+    if (should_print_tokens) {
+        token_writer_init(&writer, tokens_stream(arguments, &tokens_file), arguments->tokens_format);
+    }
+
+    // the parser needs the whole file, so -parse is ignored with -stream
+    if (arguments->is_streaming) {
+        int errors_count = stream_files(arguments, should_print_tokens ? &writer : NULL);
+        if (should_print_tokens) {
+            token_writer_free(&writer);
+        }
+        return errors_count > 0 ? 1 : 0;
+    }
+
+    int files_count = arguments->file_paths_count;
+    int workers_count = arguments->threads_count > 0 ? arguments->threads_count : thread_pool_default_workers_count();
+    int file_workers_count = files_count == 1 ? workers_count : 1; // a single file is split between the threads
+    if (workers_count > files_count) {
+        workers_count = files_count;
+    }
+
+    LexJobs jobs;
+    jobs.arguments = arguments;
+    jobs.lexers = new Lexer*[workers_count];
+    jobs.sources = new SourceBuffer[files_count]();
+    jobs.is_loaded = new bool[files_count]();
+    jobs.outputs = new Output*[files_count]();
+    jobs.is_cached = new bool[files_count]();
+    jobs.file_workers_count = file_workers_count;
+    for (int w = 0; w < workers_count; w++) {
+        jobs.lexers[w] = lexer_create();
     }
 
     auto start = high_resolution_clock::now();
-    
-    // run lexer
-    auto *output = lexer_analyze(file_buffer);
-    cout << "Token count: " << output->tokens_count << endl;
 
-    for (int i = 0; i < output->tokens_count; i++) {
-        print_token(output->tokens[i]);
+    // read and lex all files
+    auto stats = thread_pool_run(workers_count, files_count, lex_file_job, &jobs);
+
+    bool should_parse = (arguments->flags & ShouldParse) != 0;
+    auto *parser = should_parse ? parser_create() : NULL;
+    double parse_seconds = 0;
+    long nodes_count = 0;
+
+    bool should_type = (arguments->flags & ShouldType) != 0;
+    auto *typer = should_type ? typer_create() : NULL;
+    double type_seconds = 0;
+    long resolved_count = 0;
+    long instances_count = 0;
+
+    // print in the order of the arguments
+    long total_size = 0;
+    int errors_count = 0;
+    int cached_count = 0;
+    for (int f = 0; f < files_count; f++) {
+        if (!jobs.is_loaded[f]) {
+            cout << "Could not load file: " << arguments->file_paths[f] << endl;
+            exit(1);
+        }
+
+        auto *output = jobs.outputs[f];
+        total_size += jobs.sources[f].length;
+        cached_count += jobs.is_cached[f];
+        if (files_count > 1) {
+            cout << "File: " << arguments->file_paths[f] << endl;
+        }
+        cout << "Token count: " << output->tokens_count << endl;
+
+        if (should_print_tokens) {
+            token_writer_header(&writer);
+            token_writer_output(&writer, output);
+            token_writer_flush(&writer);
+        }
+        print_diagnostics(output);
+        errors_count += output->diagnostics.count;
+
+        if (should_parse) {
+            auto parse_start = high_resolution_clock::now();
+            auto *ast = parser_parse(parser, output);
+            parse_seconds += (double) duration_cast<microseconds>(high_resolution_clock::now() - parse_start).count() / 1000000;
+            nodes_count += ast->arena.count - 1;
+            if (arguments->flags & ShouldPrintAst) {
+                cout << ast_format(ast);
+            }
+            print_parser_error(ast);
+            errors_count += ast->has_failed;
+            if (should_type && !ast->has_failed) {
+                auto type_start = high_resolution_clock::now();
+                bool is_typed = typer_check(typer, ast);
+                type_seconds += (double) duration_cast<microseconds>(high_resolution_clock::now() - type_start).count() / 1000000;
+                resolved_count += typer->resolved_count;
+                instances_count += typer->instances.count;
+                print_typer_error(typer, ast);
+                errors_count += !is_typed;
+            }
+            ast_free(ast);
+        }
+        cout << "Token arena: " << output->tokens.high_water_mark << " tokens, "
+             << output->tokens.capacity << " reserved in " << output->tokens.chunks_count << " chunks, "
+             << (long) output->tokens.capacity * TOKEN_SIZE << " bytes" << endl;
     }
-    
+
     auto stop = high_resolution_clock::now();
     auto micros = (double) duration_cast<microseconds>(stop - start).count();
     auto seconds = micros / 1000000;
     cout.precision(2);
     cout << "Everything took " << seconds << " sec." << endl;
+    cout << "Lexed " << files_count << " files, " << total_size / 1000000.0 << " MB in "
+         << stats.wall_seconds << " sec: " << total_size / 1000000.0 / stats.wall_seconds << " MB/s" << endl;
+    if (should_parse) {
+        cout << "Parsed " << files_count << " files, " << nodes_count << " nodes in " << parse_seconds << " sec" << endl;
+    }
+    if (should_type) {
+        cout << "Typed " << files_count << " files, " << resolved_count << " nodes resolved in " << type_seconds << " sec, "
+             << typer->types.count << " types" << endl;
+        long lookups_count = typer->instances.lookups_count;
+        cout << "Instance cache: " << instances_count << " instances, " << typer->instances.hits_count << " of "
+             << lookups_count << " lookups hit (" << (lookups_count > 0 ? typer->instances.hits_count * 100.0 / lookups_count : 0)
+             << "%)" << endl;
+    }
+    if (arguments->cache_directory != NULL) {
+        cout << "Token cache: " << cached_count << " of " << files_count << " files loaded" << endl;
+    }
+    for (int w = 0; w < stats.workers_count; w++) {
+        cout << "Thread " << w << ": " << stats.jobs_done[w] << " files (" << stats.jobs_stolen[w] << " stolen), "
+             << (int) (stats.busy_seconds[w] / stats.wall_seconds * 100) << "% busy" << endl;
+    }
 
     // clean up
-    free(file_buffer);
+    if (should_print_tokens) {
+        token_writer_free(&writer);
+    }
+    for (int f = 0; f < files_count; f++) {
+        output_free(jobs.outputs[f]);
+        source_buffer_free(&jobs.sources[f]);
+    }
+    if (parser != NULL) {
+        parser_free(parser);
+    }
+    if (typer != NULL) {
+        typer_free(typer);
+    }
+    for (int w = 0; w < workers_count; w++) {
+        lexer_free(jobs.lexers[w]);
+    }
+    delete[] jobs.lexers;
+    delete[] jobs.sources;
+    delete[] jobs.is_loaded;
+    delete[] jobs.outputs;
+    delete[] jobs.is_cached;
+    thread_pool_stats_free(&stats);
+    return errors_count > 0 ? 1 : 0;
 }
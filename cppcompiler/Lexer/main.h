@@ -1,25 +1,85 @@
 // #include "Lexer.cpp"
 
 #include "Lexer.cpp"
+#include "LexerParallel.cpp"
+#include "LexerStream.cpp"
+#include "LexerCache.cpp"
+#include "LexerIncremental.cpp"
+#include "TokenWriter.hpp"
+#include "../Parser/Parser.cpp"
+#include "../Parser/ParserPipeline.cpp"
+#include "../Typer/Typer.cpp"
+#include "ThreadPool.hpp"
+#include "SourceBuffer.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <iostream>
+#include <fstream>
+#include <dirent.h>
+#include <sys/stat.h>
 
 using namespace std;
 
 // ARGUMENT PARSING
 
 enum RunArgumentsFlags {
-    ShouldPrintTokens
+    ShouldPrintTokens = 1 << 0,
+    ShouldParse = 1 << 1,
+    ShouldPrintAst = 1 << 2,
+    ShouldType = 1 << 3
 };
 
 struct RunArguments {
     RunArgumentsFlags flags;
-    char *file_path;
+    char **file_paths;
+    int file_paths_count;
+    int threads_count; // 0 for one per core
+    bool is_streaming; // files are read and lexed one window at a time
+    bool is_pipelined; // files are parsed while they're lexed, see ParserPipeline.cpp
+    char *cache_directory; // NULL to always lex, see LexerCache.cpp
+    TokenFormat tokens_format; // of -tokens, see TokenWriter.hpp
+    char *tokens_path; // NULL to write the tokens to the standard output
 };
 
+void run_arguments_add_file(RunArguments *arguments, char *path) {
+    arguments->file_paths = (char**) realloc(arguments->file_paths, (arguments->file_paths_count + 1) * sizeof(char*));
+    arguments->file_paths[arguments->file_paths_count] = path;
+    arguments->file_paths_count += 1;
+}
+
+int compare_paths(const void *lhs, const void *rhs) {
+    return strcmp(*(char**) lhs, *(char**) rhs);
+}
+
+// adds all .yw files in the directory, sorted by name so the output is always in the same order
+void run_arguments_add_directory(RunArguments *arguments, char *path) {
+    DIR *directory = opendir(path);
+    if (directory == NULL) {
+        return;
+    }
+
+    int first = arguments->file_paths_count;
+    while (auto *entry = readdir(directory)) {
+        int length = strlen(entry->d_name);
+        if (length <= 3 || strcmp(entry->d_name + length - 3, ".yw") != 0) {
+            continue;
+        }
+        char *file_path = (char*) malloc(strlen(path) + length + 2);
+        sprintf(file_path, "%s/%s", path, entry->d_name);
+        run_arguments_add_file(arguments, file_path);
+    }
+    closedir(directory);
+
+    qsort(arguments->file_paths + first, arguments->file_paths_count - first, sizeof(char*), compare_paths);
+}
+
+bool is_directory(char *path) {
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
 inline RunArgumentsFlags operator | (RunArgumentsFlags a, RunArgumentsFlags b) {
     return static_cast<RunArgumentsFlags>(static_cast<int>(a) | static_cast<int>(b));
 }
@@ -28,45 +88,82 @@ RunArguments* parse_arguments(int argc, char *argv[]) {
     auto *arguments = new RunArguments();
 
     bool isLookingForFile = false;
+    bool isLookingForThreads = false;
+    bool isLookingForCache = false;
+    bool isLookingForFormat = false;
+    bool isLookingForOutput = false;
     for (int i = 1; i < argc; ++i) {
         char *argument = argv[i];
 
         if (isLookingForFile) {
-            arguments->file_path = argument;
+            if (is_directory(argument)) {
+                run_arguments_add_directory(arguments, argument);
+            } else {
+                run_arguments_add_file(arguments, argument);
+            }
             isLookingForFile = false;
+        } else if (isLookingForThreads) {
+            arguments->threads_count = atoi(argument);
+            isLookingForThreads = false;
+        } else if (isLookingForCache) {
+            arguments->cache_directory = argument;
+            isLookingForCache = false;
+        } else if (isLookingForFormat) {
+            if (strcmp(argument, "text") == 0) {
+                arguments->tokens_format = TOKEN_FORMAT_TEXT;
+            } else if (strcmp(argument, "json") == 0) {
+                arguments->tokens_format = TOKEN_FORMAT_JSON;
+            } else if (strcmp(argument, "binary") == 0) {
+                arguments->tokens_format = TOKEN_FORMAT_BINARY;
+            } else {
+                return NULL;
+            }
+            isLookingForFormat = false;
+        } else if (isLookingForOutput) {
+            arguments->tokens_path = argument;
+            isLookingForOutput = false;
         } else if (strcmp(argument, "-file") == 0) {
             isLookingForFile = true;
+        } else if (strcmp(argument, "-threads") == 0) {
+            isLookingForThreads = true;
+        } else if (strcmp(argument, "-cache") == 0) {
+            isLookingForCache = true;
+        } else if (strcmp(argument, "-format") == 0) {
+            isLookingForFormat = true;
+        } else if (strcmp(argument, "-output") == 0) {
+            isLookingForOutput = true;
+        } else if (strcmp(argument, "-stream") == 0) {
+            arguments->is_streaming = true;
+        } else if (strcmp(argument, "-pipeline") == 0) {
+            arguments->is_pipelined = true;
+            arguments->flags = arguments->flags | ShouldParse;
         } else if (strcmp(argument, "-tokens") == 0) {
-            arguments->flags | ShouldPrintTokens;
+            arguments->flags = arguments->flags | ShouldPrintTokens;
+        } else if (strcmp(argument, "-parse") == 0) {
+            arguments->flags = arguments->flags | ShouldParse;
+        } else if (strcmp(argument, "-ast") == 0) {
+            arguments->flags = arguments->flags | ShouldParse | ShouldPrintAst;
+        } else if (strcmp(argument, "-types") == 0) {
+            arguments->flags = arguments->flags | ShouldParse | ShouldType;
         }
     }
 
-    if (isLookingForFile) {
+    if (isLookingForFile || isLookingForThreads || isLookingForCache || isLookingForFormat || isLookingForOutput) {
         return NULL;
     } else {
         return arguments;
     }
 }
 
-// FILE LOADING
-
-char* load_file_into_buffer(char const* path) {
-    char* buffer = 0;
-    long length;
-    FILE * f = fopen (path, "rb"); //was "rb"
-
-    if (f)
-    {
-      fseek (f, 0, SEEK_END);
-      length = ftell (f);
-      fseek (f, 0, SEEK_SET);
-      buffer = (char*)malloc ((length+1)*sizeof(char));
-      if (buffer)
-      {
-        fread (buffer, sizeof(char), length, f);
-      }
-      fclose (f);
+// where -tokens writes, the file is opened in the stream that is passed in
+std::ostream* tokens_stream(RunArguments *arguments, std::ofstream *file) {
+    if (arguments->tokens_path == NULL) {
+        return &cout;
+    }
+    file->open(arguments->tokens_path, std::ios::binary);
+    if (!file->is_open()) {
+        cout << "Could not open file: " << arguments->tokens_path << endl;
+        exit(1);
     }
-    buffer[length] = '\0';
-    return buffer;
-}
\ No newline at end of file
+    return file;
+}
@@ -0,0 +1,457 @@
+//
+//  Ast.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "../Lexer/Lexer.hpp"
+#include "ParserErrors.hpp"
+#include <string>
+
+// The node kinds of compiler/Compiler/Compiler/Parser/AST Model.
+// Nodes are 32 bytes, allocated one after another in an AstArena and linked by their index,
+// so a whole file's tree is two allocations that are freed at once.
+// Index 0 is never a node, it stands for a missing child.
+//
+// What the children a, b, c, d and e are, by kind:
+// CODE             a: list of statements
+// VALUE            a: symbol, b: the VARIABLE it reads, set by the typer
+// INT_LITERAL      int_value, NODE_FLAG_BOOL for true and false
+// FLOAT_LITERAL    float_value
+// STRING_LITERAL   a, b: the Slice of the value, see ast_string_value
+// NULL_LITERAL, VOID_LITERAL
+// SIZEOF, NEW      a: type
+// UNARY            operation, a: argument, b: type for NODE_FLAG_CAST
+// BINARY           operation, a: left, b: right
+// CALL             a: symbol, b: list of solid types, c: list of arguments, d: the PROCEDURE, set by the typer,
+//                  e: the instance of a generic PROCEDURE + 1 or 0, set by the typer, see Instances.hpp
+// MEMBER_ACCESS    a: base, b: member symbol
+// SUBSCRIPT        a: base, b: index
+// VARIABLE         a: symbol, b: type or 0, c: expression or 0, NODE_FLAG_CONSTANT
+// ASSIGNMENT       a: receiver, b: expression
+// PROCEDURE        a: symbol, b: list of generic type symbols, c: list of argument VARIABLEs,
+//                  d: return type or 0 for Void, e: body CODE or 0 for foreign procedures,
+//                  NODE_FLAG_VARARGS, NODE_FLAG_FOREIGN, NODE_FLAG_MAIN
+// STRUCT           a: symbol, b: list of generic type symbols, c: list of member VARIABLEs
+// IF               a: condition, b: body CODE, c: else CODE or 0
+// WHILE            a: label symbol or 0, b: condition, c: body CODE
+// BREAK, CONTINUE  a: label symbol or 0 (symbol 0 is a keyword, so it is never a label)
+// RETURN           a: value or 0, b: the PROCEDURE it returns from, set by the typer
+// FREE             a: expression
+// TYPE             a: symbol without the asterisks, b: list of solid types, c: pointer depth,
+//                  d: list of array length expressions, outermost first
+//
+// Lists are stored in AstArena::extra as their count followed by the items, list 0 is empty.
+// Every expression has a type slot for the passes after parsing, 0 while it's unresolved, see Typer.cpp.
+// TYPE nodes keep the type they are converted to there.
+
+enum NodeKind {
+    NODE_NONE,
+    NODE_CODE,
+    NODE_VALUE, NODE_INT_LITERAL, NODE_FLOAT_LITERAL, NODE_STRING_LITERAL, NODE_NULL_LITERAL, NODE_VOID_LITERAL,
+    NODE_SIZEOF, NODE_NEW, NODE_UNARY, NODE_BINARY, NODE_CALL, NODE_MEMBER_ACCESS, NODE_SUBSCRIPT,
+    NODE_VARIABLE, NODE_ASSIGNMENT, NODE_PROCEDURE, NODE_STRUCT,
+    NODE_IF, NODE_WHILE, NODE_BREAK, NODE_CONTINUE, NODE_RETURN, NODE_FREE,
+    NODE_TYPE,
+    NODE_KIND_COUNT
+};
+typedef enum NodeKind NodeKind;
+
+const uint8_t NODE_FLAG_CONSTANT = 1 << 0;
+const uint8_t NODE_FLAG_VARARGS = 1 << 1;
+const uint8_t NODE_FLAG_FOREIGN = 1 << 2;
+const uint8_t NODE_FLAG_MAIN = 1 << 3;
+const uint8_t NODE_FLAG_BOOL = 1 << 4;
+const uint8_t NODE_FLAG_CAST = 1 << 5;
+
+typedef uint32_t NodeIndex;
+typedef uint32_t ListIndex; // into AstArena::extra
+
+// kind, flags and operation are in the bytes after e that the 8 byte values would leave as padding,
+// the values only take the place of a and b
+struct AstNode {
+    uint32_t token; // the first token of the node
+    uint32_t type; // resolved after parsing, 0 until then
+    union {
+        struct {
+            uint32_t a, b, c, d, e;
+            uint8_t kind;
+            uint8_t flags;
+            uint8_t operation; // the Operator of unary and binary operators
+        };
+        int64_t int_value;
+        double float_value;
+    };
+};
+typedef struct AstNode AstNode;
+static_assert(sizeof(AstNode) == 32, "nodes are 32 bytes");
+
+// AST ARENA
+
+struct AstArena {
+    AstNode *nodes;
+    int count;
+    int capacity;
+
+    uint32_t *extra; // lists
+    int extra_count;
+    int extra_capacity;
+};
+typedef struct AstArena AstArena;
+
+// the capacities only need to be a guess, the arrays double when they're full
+void ast_arena_init(AstArena *arena, int nodes_capacity) {
+    memset(arena, 0, sizeof(*arena));
+    arena->capacity = nodes_capacity > 1024 ? nodes_capacity : 1024;
+    arena->nodes = (AstNode*) malloc(arena->capacity * sizeof(AstNode));
+    memset(&arena->nodes[0], 0, sizeof(AstNode)); // the missing child
+    arena->count = 1;
+    arena->extra_capacity = arena->capacity / 2;
+    arena->extra = (uint32_t*) malloc(arena->extra_capacity * sizeof(uint32_t));
+    arena->extra[0] = 0; // the empty list
+    arena->extra_count = 1;
+}
+
+void ast_arena_free(AstArena *arena) {
+    free(arena->nodes);
+    free(arena->extra);
+    memset(arena, 0, sizeof(*arena));
+}
+
+NodeIndex ast_node_make(AstArena *arena, NodeKind kind, uint32_t token) {
+    if (arena->count == arena->capacity) {
+        arena->capacity *= 2;
+        arena->nodes = (AstNode*) realloc(arena->nodes, arena->capacity * sizeof(AstNode));
+    }
+    AstNode *node = &arena->nodes[arena->count];
+    memset(node, 0, sizeof(*node));
+    node->kind = (uint8_t) kind;
+    node->token = token;
+    return arena->count++;
+}
+
+// the pointer is only valid until the next node is made
+inline AstNode* ast_node(AstArena *arena, NodeIndex index) {
+    return &arena->nodes[index];
+}
+
+// stores the items as a list, returns its index
+ListIndex ast_list_make(AstArena *arena, const uint32_t *items, int count) {
+    if (arena->extra_count + count + 1 > arena->extra_capacity) {
+        while (arena->extra_count + count + 1 > arena->extra_capacity) {
+            arena->extra_capacity *= 2;
+        }
+        arena->extra = (uint32_t*) realloc(arena->extra, arena->extra_capacity * sizeof(uint32_t));
+    }
+    ListIndex list = arena->extra_count;
+    arena->extra[list] = count;
+    memcpy(arena->extra + list + 1, items, count * sizeof(uint32_t));
+    arena->extra_count += count + 1;
+    return list;
+}
+
+inline int ast_list_count(AstArena *arena, ListIndex list) {
+    return arena->extra[list];
+}
+
+inline uint32_t* ast_list_items(AstArena *arena, ListIndex list) {
+    return arena->extra + list + 1;
+}
+
+// AST
+
+// the parser stops at the first error, like the Swift parser, the nodes are incomplete then
+struct Ast {
+    AstArena arena;
+    NodeIndex root; // CODE with the global declarations in the order of the source
+    Output *output; // the tokens the nodes point to, managed by the caller
+
+    bool has_failed;
+    ParserError error;
+    uint32_t error_offset; // of the token the error is at
+    uint32_t error_end_offset;
+};
+typedef struct Ast Ast;
+
+void ast_free(Ast *ast) {
+    ast_arena_free(&ast->arena);
+    delete ast;
+}
+
+// kept in the node, the token may not be in memory anymore when the tokens were streamed to the parser
+Slice ast_string_value(Ast *ast, NodeIndex index) {
+    Slice value;
+    memcpy(&value, &ast->arena.nodes[index].a, sizeof(Slice));
+    return value;
+}
+
+// PRINTING
+
+void print_parser_error(Ast *ast) {
+    if (!ast->has_failed) {
+        return;
+    }
+    Cursor start = output_cursor_at(ast->output, ast->error_offset);
+    Cursor end = output_cursor_at(ast->output, ast->error_end_offset);
+    cout << "error occured: " << parser_error_names[ast->error]
+         << " at " << start.line_number << ":" << start.character << " - " << end.line_number << ":" << end.character
+         << " (" << parser_error_messages[ast->error] << ")" << endl;
+}
+
+void ast_append_symbol(Ast *ast, std::string *string, Symbol symbol) {
+    string->append(interner_characters(ast->output->interner, symbol), interner_length(ast->output->interner, symbol));
+}
+
+void ast_append_node(Ast *ast, std::string *string, NodeIndex index, int indent);
+
+void ast_append_type(Ast *ast, std::string *string, NodeIndex index) {
+    AstNode node = ast->arena.nodes[index];
+    ast_append_symbol(ast, string, node.a);
+    int solid_count = ast_list_count(&ast->arena, node.b);
+    for (int s = 0; s < solid_count; s++) {
+        string->append(s == 0 ? "<" : ", ");
+        ast_append_type(ast, string, ast_list_items(&ast->arena, node.b)[s]);
+    }
+    string->append(solid_count > 0 ? ">" : "");
+    string->append(node.c, '*');
+    for (int d = 0; d < ast_list_count(&ast->arena, node.d); d++) {
+        string->push_back('[');
+        ast_append_node(ast, string, ast_list_items(&ast->arena, node.d)[d], 0);
+        string->push_back(']');
+    }
+}
+
+void ast_append_block(Ast *ast, std::string *string, ListIndex list, int indent) {
+    for (int s = 0; s < ast_list_count(&ast->arena, list); s++) {
+        string->push_back('\n');
+        string->append(indent, ' ');
+        ast_append_node(ast, string, ast_list_items(&ast->arena, list)[s], indent);
+    }
+}
+
+void ast_append_generics(Ast *ast, std::string *string, ListIndex list) {
+    int count = ast_list_count(&ast->arena, list);
+    for (int g = 0; g < count; g++) {
+        string->append(g == 0 ? "<" : ", ");
+        ast_append_symbol(ast, string, ast_list_items(&ast->arena, list)[g]);
+    }
+    string->append(count > 0 ? ">" : "");
+}
+
+// one s-expression, statements of blocks go on their own lines, indented
+void ast_append_node(Ast *ast, std::string *string, NodeIndex index, int indent) {
+    AstNode node = ast->arena.nodes[index];
+    AstArena *arena = &ast->arena;
+    char number[64];
+    switch (node.kind) {
+        case NODE_CODE:
+            string->append("(code");
+            ast_append_block(ast, string, node.a, indent + 2);
+            string->push_back(')');
+            break;
+        case NODE_VALUE:
+            ast_append_symbol(ast, string, node.a);
+            break;
+        case NODE_INT_LITERAL:
+            if (node.flags & NODE_FLAG_BOOL) {
+                string->append(node.int_value != 0 ? "true" : "false");
+            } else {
+                snprintf(number, sizeof(number), "%lld", (long long) node.int_value);
+                string->append(number);
+            }
+            break;
+        case NODE_FLOAT_LITERAL:
+            snprintf(number, sizeof(number), "%.17g", node.float_value);
+            string->append(number);
+            if (strpbrk(number, ".en") == NULL) {
+                string->append(".0");
+            }
+            break;
+        case NODE_STRING_LITERAL: {
+            // escaped again, so every declaration stays on its lines
+            Slice value = ast_string_value(ast, index);
+            char *characters = output_slice_characters(ast->output, value);
+            string->push_back('"');
+            for (unsigned int c = 0; c < value.length; c++) {
+                switch (characters[c]) {
+                    case '\n': string->append("\\n"); break;
+                    case '\t': string->append("\\t"); break;
+                    case '"': string->append("\\\""); break;
+                    case '\\': string->append("\\\\"); break;
+                    default: string->push_back(characters[c]);
+                }
+            }
+            string->push_back('"');
+            break;
+        }
+        case NODE_NULL_LITERAL: string->append("null"); break;
+        case NODE_VOID_LITERAL: string->append("void"); break;
+        case NODE_SIZEOF: case NODE_NEW:
+            string->append(node.kind == NODE_SIZEOF ? "(sizeof " : "(new ");
+            ast_append_type(ast, string, node.a);
+            string->push_back(')');
+            break;
+        case NODE_UNARY:
+            string->push_back('(');
+            if (node.flags & NODE_FLAG_CAST) {
+                string->append("cast ");
+                ast_append_type(ast, string, node.b);
+            } else {
+                string->append(operator_spellings[node.operation]);
+            }
+            string->push_back(' ');
+            ast_append_node(ast, string, node.a, indent);
+            string->push_back(')');
+            break;
+        case NODE_BINARY:
+            string->push_back('(');
+            string->append(operator_spellings[node.operation]);
+            string->push_back(' ');
+            ast_append_node(ast, string, node.a, indent);
+            string->push_back(' ');
+            ast_append_node(ast, string, node.b, indent);
+            string->push_back(')');
+            break;
+        case NODE_CALL: {
+            string->append("(call ");
+            ast_append_symbol(ast, string, node.a);
+            for (int s = 0; s < ast_list_count(arena, node.b); s++) {
+                string->append(s == 0 ? "<" : ", ");
+                ast_append_type(ast, string, ast_list_items(arena, node.b)[s]);
+            }
+            string->append(ast_list_count(arena, node.b) > 0 ? ">" : "");
+            for (int g = 0; g < ast_list_count(arena, node.c); g++) {
+                string->push_back(' ');
+                ast_append_node(ast, string, ast_list_items(arena, node.c)[g], indent);
+            }
+            string->push_back(')');
+            break;
+        }
+        case NODE_MEMBER_ACCESS:
+            string->append("(. ");
+            ast_append_node(ast, string, node.a, indent);
+            string->push_back(' ');
+            ast_append_symbol(ast, string, node.b);
+            string->push_back(')');
+            break;
+        case NODE_SUBSCRIPT:
+            string->append("([] ");
+            ast_append_node(ast, string, node.a, indent);
+            string->push_back(' ');
+            ast_append_node(ast, string, node.b, indent);
+            string->push_back(')');
+            break;
+        case NODE_VARIABLE:
+            // written back the way it was declared: x: T, x: T = e, x: T : e, x := e or x :: e
+            string->append("(var ");
+            ast_append_symbol(ast, string, node.a);
+            if (node.b != 0) {
+                string->append(": ");
+                ast_append_type(ast, string, node.b);
+            }
+            if (node.c != 0) {
+                bool is_constant = node.flags & NODE_FLAG_CONSTANT;
+                string->append(node.b != 0 ? (is_constant ? " : " : " = ") : (is_constant ? " :: " : " := "));
+                ast_append_node(ast, string, node.c, indent);
+            }
+            string->push_back(')');
+            break;
+        case NODE_ASSIGNMENT:
+            string->append("(= ");
+            ast_append_node(ast, string, node.a, indent);
+            string->push_back(' ');
+            ast_append_node(ast, string, node.b, indent);
+            string->push_back(')');
+            break;
+        case NODE_PROCEDURE: {
+            string->append("(func ");
+            ast_append_symbol(ast, string, node.a);
+            ast_append_generics(ast, string, node.b);
+            string->push_back('(');
+            for (int g = 0; g < ast_list_count(arena, node.c); g++) {
+                AstNode argument = arena->nodes[ast_list_items(arena, node.c)[g]];
+                string->append(g == 0 ? "" : ", ");
+                ast_append_symbol(ast, string, argument.a);
+                string->append(": ");
+                ast_append_type(ast, string, argument.b);
+            }
+            string->append(node.flags & NODE_FLAG_VARARGS ? ", ...)" : ")");
+            if (node.d != 0) {
+                string->append(" -> ");
+                ast_append_type(ast, string, node.d);
+            }
+            string->append(node.flags & NODE_FLAG_FOREIGN ? " #foreign" : "");
+            string->append(node.flags & NODE_FLAG_MAIN ? " #main" : "");
+            if (node.e != 0) {
+                ast_append_block(ast, string, arena->nodes[node.e].a, indent + 2);
+            }
+            string->push_back(')');
+            break;
+        }
+        case NODE_STRUCT:
+            string->append("(struct ");
+            ast_append_symbol(ast, string, node.a);
+            ast_append_generics(ast, string, node.b);
+            ast_append_block(ast, string, node.c, indent + 2);
+            string->push_back(')');
+            break;
+        case NODE_IF:
+            string->append("(if ");
+            ast_append_node(ast, string, node.a, indent);
+            ast_append_block(ast, string, arena->nodes[node.b].a, indent + 2);
+            if (node.c != 0) {
+                string->push_back('\n');
+                string->append(indent, ' ');
+                string->append("else");
+                ast_append_block(ast, string, arena->nodes[node.c].a, indent + 2);
+            }
+            string->push_back(')');
+            break;
+        case NODE_WHILE:
+            string->append("(while ");
+            if (node.a != 0) {
+                ast_append_symbol(ast, string, node.a);
+                string->append(": ");
+            }
+            ast_append_node(ast, string, node.b, indent);
+            ast_append_block(ast, string, arena->nodes[node.c].a, indent + 2);
+            string->push_back(')');
+            break;
+        case NODE_BREAK: case NODE_CONTINUE:
+            string->append(node.kind == NODE_BREAK ? "(break" : "(continue");
+            if (node.a != 0) {
+                string->push_back(' ');
+                ast_append_symbol(ast, string, node.a);
+            }
+            string->push_back(')');
+            break;
+        case NODE_RETURN: case NODE_FREE:
+            string->append(node.kind == NODE_RETURN ? "(return" : "(free");
+            if (node.a != 0) {
+                string->push_back(' ');
+                ast_append_node(ast, string, node.a, indent);
+            }
+            string->push_back(')');
+            break;
+        case NODE_TYPE:
+            ast_append_type(ast, string, index);
+            break;
+        default:
+            string->append("(?)");
+    }
+}
+
+// the global declarations, one per line
+std::string ast_format(Ast *ast) {
+    std::string string;
+    AstNode root = ast->arena.nodes[ast->root];
+    for (int s = 0; s < ast_list_count(&ast->arena, root.a); s++) {
+        ast_append_node(ast, &string, ast_list_items(&ast->arena, root.a)[s], 0);
+        string.push_back('\n');
+    }
+    return string;
+}
@@ -0,0 +1,1069 @@
+//
+//  Parser.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include "Ast.hpp"
+#include "ParserErrors.hpp"
+#include "ParserConst.hpp"
+#include "TokenRing.hpp"
+#include <climits>
+
+// A recursive descent parser with the grammar of compiler/Compiler/Compiler/Parser/Parser.swift.
+// It only builds the tree: declarations are not looked up and types are not checked,
+// so the errors that need them are left to the passes after parsing.
+// Names of types stay symbols in TYPE nodes until then.
+//
+// Two things differ from the Swift parser:
+// a '>>' token closes two lists of solid types, as in Node<Node<Int>>,
+// and an identifier followed by '<' is only a call when the types are followed by '(', otherwise it's a comparison.
+//
+// The tokens are either all in the output's arena, or streamed from the lexer through a TokenRing,
+// see ParserPipeline.cpp. Only the parser_*_at functions and the literal values differ between the two.
+
+struct Parser {
+    Output *output; // the tokens being parsed
+    TokenRing *ring; // where the tokens come from instead of the output's arena, NULL if they're all lexed
+    Ast *ast;
+    AstArena *arena;
+
+    int i; // the current token, never past the ENDOFFILE token
+    int count; // of the tokens, INT_MAX while they're streamed
+    TokenType kind; // of the current token
+    uint32_t payload;
+    uint32_t offset;
+    bool is_greater_split; // the first '>' of a '>>' token is consumed, the current token is the second
+
+    // the items of the lists being parsed, a list takes its items from the top when it ends
+    uint32_t *stack;
+    int stack_count;
+    int stack_capacity;
+
+    // labels of the loops around the current statement, 0 for loops without one
+    Symbol *loops;
+    int loops_count;
+    int loops_capacity;
+
+    bool has_main;
+    Symbol symbol_foreign;
+    Symbol symbol_main;
+
+    // no '<' before this index opens the solid types of a call, see parser_is_generic_call
+    int generic_rejected_until;
+
+    // the first error stops the parser, like the Swift parser
+    bool has_failed;
+};
+typedef struct Parser Parser;
+
+// TOKENS
+
+// the number of tokens before the current one that can still be looked at, see token_ring_release
+const int PARSER_RING_LOOKBEHIND = 8;
+
+// the index of the token, or of the last token when the file has fewer
+inline int parser_clamp(Parser *parser, int index) {
+    if (parser->ring) {
+        return token_ring_wait(parser->ring, index);
+    }
+    return index < parser->count ? index : parser->count - 1;
+}
+
+TokenType parser_kind_at(Parser *parser, int index) {
+    index = parser_clamp(parser, index);
+    if (parser->ring) {
+        return (TokenType) token_ring_at(parser->ring, index)->kind;
+    }
+    return token_arena_kind(&parser->output->tokens, index);
+}
+
+uint32_t parser_payload_at(Parser *parser, int index) {
+    index = parser_clamp(parser, index);
+    if (parser->ring) {
+        return token_ring_at(parser->ring, index)->payload;
+    }
+    int index_in_chunk;
+    TokenChunk *chunk = &parser->output->tokens.chunks[token_arena_chunk_of(index, &index_in_chunk)];
+    return chunk->payloads[index_in_chunk];
+}
+
+uint32_t parser_offset_at(Parser *parser, int index, uint32_t *end_offset) {
+    index = parser_clamp(parser, index);
+    if (parser->ring) {
+        RingToken *token = token_ring_at(parser->ring, index);
+        *end_offset = token->end_offset;
+        return token->offset;
+    }
+    int index_in_chunk;
+    TokenChunk *chunk = &parser->output->tokens.chunks[token_arena_chunk_of(index, &index_in_chunk)];
+    *end_offset = chunk->end_offsets[index_in_chunk];
+    return chunk->offsets[index_in_chunk];
+}
+
+void parser_read(Parser *parser) {
+    if (parser->ring) {
+        RingToken *token = token_ring_at(parser->ring, token_ring_wait(parser->ring, parser->i));
+        parser->kind = (TokenType) token->kind;
+        parser->payload = token->payload;
+        parser->offset = token->offset;
+        return;
+    }
+    parser->kind = parser_kind_at(parser, parser->i);
+    parser->payload = parser_payload_at(parser, parser->i);
+    uint32_t end_offset;
+    parser->offset = parser_offset_at(parser, parser->i, &end_offset);
+}
+
+void parser_advance(Parser *parser) {
+    parser->is_greater_split = false;
+    if (parser->kind != ENDOFFILE) {
+        parser->i += 1;
+    }
+    if (parser->ring) {
+        token_ring_release(parser->ring, parser->i - PARSER_RING_LOOKBEHIND);
+    }
+    parser_read(parser);
+}
+
+// LITERALS
+
+int64_t parser_int_value(Parser *parser) {
+    if (parser->ring) {
+        return token_ring_at(parser->ring, parser->i)->int_value;
+    }
+    return token_arena_int_value(&parser->output->tokens, parser->payload);
+}
+
+double parser_float_value(Parser *parser) {
+    if (parser->ring) {
+        return token_ring_at(parser->ring, parser->i)->float_value;
+    }
+    return parser->output->tokens.float_values[parser->payload];
+}
+
+Slice parser_string_value(Parser *parser) {
+    if (parser->ring) {
+        return token_ring_at(parser->ring, parser->i)->string_value;
+    }
+    return parser->output->tokens.string_values[parser->payload];
+}
+
+// the symbol of the current identifier without the asterisks at its end, the lexer keeps them as in Int8**
+Symbol parser_type_symbol(Parser *parser, int *pointer_depth) {
+    if (parser->ring) {
+        RingToken *token = token_ring_at(parser->ring, parser->i);
+        *pointer_depth = token->pointer_depth;
+        return token->type_symbol;
+    }
+    Interner *interner = parser->output->interner;
+    const char *characters = interner_characters(interner, parser->payload);
+    int length = interner_length(interner, parser->payload);
+    *pointer_depth = 0;
+    while (length > 1 && characters[length - 1] == '*') {
+        length -= 1;
+        *pointer_depth += 1;
+    }
+    return *pointer_depth > 0 ? interner_intern(interner, characters, length) : parser->payload;
+}
+
+bool parser_is_operator_at(Parser *parser, int index, Operator op) {
+    TokenType kind = parser_kind_at(parser, index);
+    return (kind == PUNCTUATOR || kind == OPERATOR) && parser_payload_at(parser, index) == (uint32_t) op;
+}
+
+// the operator or punctuator the current token stands for, OPERATOR_NONE for other tokens
+Operator parser_operator(Parser *parser) {
+    if (parser->kind != PUNCTUATOR && parser->kind != OPERATOR) {
+        return OPERATOR_NONE;
+    }
+    return parser->is_greater_split ? OPERATOR_GREATER : (Operator) parser->payload;
+}
+
+bool parser_is(Parser *parser, Operator op) {
+    Operator current = parser_operator(parser);
+    return current == op || (op == OPERATOR_GREATER && current == OPERATOR_SHIFT_RIGHT);
+}
+
+bool parser_consume(Parser *parser, Operator op) {
+    if (!parser_is(parser, op)) {
+        return false;
+    }
+    if (parser_operator(parser) == OPERATOR_SHIFT_RIGHT && op == OPERATOR_GREATER) {
+        parser->is_greater_split = true;
+    } else {
+        parser_advance(parser);
+    }
+    return true;
+}
+
+bool parser_is_separator(Parser *parser, char character) {
+    return parser->kind == SEPARATOR && parser->output->source[parser->offset] == character;
+}
+
+bool parser_consume_separator(Parser *parser, char character) {
+    if (!parser_is_separator(parser, character)) {
+        return false;
+    }
+    parser_advance(parser);
+    return true;
+}
+
+bool parser_is_keyword(Parser *parser, Keyword keyword) {
+    return parser->kind == KEYWORD && parser->payload == (uint32_t) keyword;
+}
+
+// ERRORS
+
+// keeps the first error and acts as if the file ended, which ends every loop of the parser
+void parser_fail(Parser *parser, ParserError error, int token) {
+    if (parser->has_failed) {
+        return;
+    }
+    parser->has_failed = true;
+    parser->ast->has_failed = true;
+    parser->ast->error = error;
+    parser->ast->error_offset = parser_offset_at(parser, token, &parser->ast->error_end_offset);
+    parser->kind = ENDOFFILE;
+    parser->is_greater_split = false;
+}
+
+void parser_fail_here(Parser *parser, ParserError error) {
+    parser_fail(parser, parser->kind == ENDOFFILE ? PARSER_ERROR_UNEXPECTED_END_OF_FILE : error, parser->i);
+}
+
+void parser_expect_semicolon(Parser *parser) {
+    if (!parser_consume_separator(parser, ';')) {
+        parser_fail_here(parser, PARSER_ERROR_EXPECTED_SEMICOLON);
+    }
+}
+
+// LISTS
+
+int parser_list_begin(Parser *parser) {
+    return parser->stack_count;
+}
+
+void parser_list_push(Parser *parser, uint32_t item) {
+    if (parser->stack_count == parser->stack_capacity) {
+        parser->stack_capacity *= 2;
+        parser->stack = (uint32_t*) realloc(parser->stack, parser->stack_capacity * sizeof(uint32_t));
+    }
+    parser->stack[parser->stack_count++] = item;
+}
+
+ListIndex parser_list_end(Parser *parser, int begin) {
+    int count = parser->stack_count - begin;
+    parser->stack_count = begin;
+    return count == 0 ? 0 : ast_list_make(parser->arena, parser->stack + begin, count);
+}
+
+NodeIndex parser_node(Parser *parser, NodeKind kind, uint32_t token) {
+    return ast_node_make(parser->arena, kind, token);
+}
+
+#define NODE(index) ast_node(parser->arena, index)
+
+// TYPES
+
+NodeIndex parse_type(Parser *parser);
+
+// '<' Type (',' Type)* '>'
+ListIndex parse_solid_types(Parser *parser) {
+    int list = parser_list_begin(parser);
+    if (parser_consume(parser, OPERATOR_LESS)) {
+        int count = 0;
+        while (!parser->has_failed && !parser_consume(parser, OPERATOR_GREATER)) {
+            if (count > 0 && !parser_consume_separator(parser, ',')) {
+                parser_fail_here(parser, PARSER_ERROR_STRUCT_EXPECTED_CLOSING_TRIANGLE_BRACKET);
+                break;
+            }
+            parser_list_push(parser, parse_type(parser));
+            count += 1;
+        }
+    }
+    return parser_list_end(parser, list);
+}
+
+// '<' Identifier (',' Identifier)* '>' of generic declarations
+ListIndex parse_generic_types(Parser *parser) {
+    int list = parser_list_begin(parser);
+    if (parser_consume(parser, OPERATOR_LESS)) {
+        int count = 0;
+        while (!parser->has_failed && !parser_consume(parser, OPERATOR_GREATER)) {
+            if (count > 0 && !parser_consume_separator(parser, ',')) {
+                parser_fail_here(parser, PARSER_ERROR_STRUCT_EXPECTED_CLOSING_TRIANGLE_BRACKET);
+                break;
+            }
+            if (parser->kind != IDENTIFIER) {
+                parser_fail_here(parser, PARSER_ERROR_STRUCT_EXPECTED_GENERIC_TYPE);
+                break;
+            }
+            parser_list_push(parser, parser->payload);
+            parser_advance(parser);
+            count += 1;
+        }
+    }
+    return parser_list_end(parser, list);
+}
+
+NodeIndex parse_expression(Parser *parser, int priority);
+
+// Identifier ['<' types '>' '*'*] ('[' expression ']')*
+// the lexer keeps the asterisks in the identifier when there are no solid types, as in Int8**
+NodeIndex parse_type(Parser *parser) {
+    if (parser->kind != IDENTIFIER) {
+        parser_fail_here(parser, PARSER_ERROR_EXPECTED_TYPE);
+        return 0;
+    }
+    int pointer_depth;
+    Symbol symbol = parser_type_symbol(parser, &pointer_depth);
+    NodeIndex type = parser_node(parser, NODE_TYPE, parser->i);
+    parser_advance(parser);
+    ListIndex solid_types = parse_solid_types(parser);
+    if (solid_types != 0) {
+        while (parser_consume(parser, OPERATOR_ASTERISK)) {
+            pointer_depth += 1;
+        }
+    }
+
+    int dimensions = parser_list_begin(parser);
+    while (!parser->has_failed && parser_consume(parser, PUNCTUATOR_BRACKET_OPEN)) {
+        parser_list_push(parser, parse_expression(parser, 0));
+        if (!parser_consume(parser, PUNCTUATOR_BRACKET_CLOSE)) {
+            parser_fail_here(parser, PARSER_ERROR_ARRAY_CLOSING_BRACKET);
+        }
+    }
+
+    AstNode *node = NODE(type);
+    node->a = symbol;
+    node->b = solid_types;
+    node->c = pointer_depth;
+    node->d = parser_list_end(parser, dimensions);
+    return type;
+}
+
+// EXPRESSIONS
+
+// whether the '<' after the identifier at the index opens the solid types of a call,
+// only the tokens that can be in a list of types are skipped.
+// A list still open after PARSER_GENERIC_LOOKAHEAD tokens is an error instead of a comparison,
+// that is as far as the ring lets the parser look ahead.
+// Lists nested deeper than PARSER_GENERIC_DEPTH are comparisons, so a chain like a < b < c < d stops early,
+// and the '<' inside a rejected list are not scanned again, see generic_rejected_until.
+const int PARSER_GENERIC_LOOKAHEAD = 1024;
+const int PARSER_GENERIC_DEPTH = 64;
+static_assert(PARSER_GENERIC_LOOKAHEAD + PARSER_RING_LOOKBEHIND + 2 * TOKEN_RING_BATCH + 2 <= TOKEN_RING_CAPACITY,
+              "the parser can't look that far ahead in the ring");
+
+bool parser_is_generic_call(Parser *parser, int index) {
+    if (index < parser->generic_rejected_until) {
+        return false;
+    }
+    int depth = 0;
+    for (int t = index; t < index + PARSER_GENERIC_LOOKAHEAD; t++) {
+        TokenType kind = parser_kind_at(parser, t);
+        Operator op = (kind == OPERATOR || kind == PUNCTUATOR) ? (Operator) parser_payload_at(parser, t) : OPERATOR_NONE;
+        if (op == OPERATOR_LESS) {
+            depth += 1;
+            if (depth > PARSER_GENERIC_DEPTH) {
+                return false;
+            }
+        } else if (op == OPERATOR_GREATER || op == OPERATOR_SHIFT_RIGHT) {
+            depth -= op == OPERATOR_GREATER ? 1 : 2;
+            if (depth <= 0 && !parser_is_operator_at(parser, t + 1, PUNCTUATOR_PAREN_OPEN)) {
+                // the lists of the '<' after this one close before it too, and not before a '('
+                parser->generic_rejected_until = t;
+                return false;
+            }
+            if (depth <= 0) {
+                return depth == 0;
+            }
+        } else if (kind == ENDOFFILE) {
+            parser->generic_rejected_until = t;
+            return false;
+        } else if (kind != IDENTIFIER && op != OPERATOR_ASTERISK) {
+            uint32_t end_offset;
+            if (kind != SEPARATOR || parser->output->source[parser_offset_at(parser, t, &end_offset)] != ',') {
+                // a list of a '<' after this one can still close right before the '('
+                bool is_closed = op == PUNCTUATOR_PAREN_OPEN
+                    && (parser_is_operator_at(parser, t - 1, OPERATOR_GREATER)
+                        || parser_is_operator_at(parser, t - 1, OPERATOR_SHIFT_RIGHT));
+                if (!is_closed) {
+                    parser->generic_rejected_until = t;
+                }
+                return false;
+            }
+        }
+    }
+    parser_fail(parser, PARSER_ERROR_CALL_TYPES_TOO_LONG, index);
+    return false;
+}
+
+bool parser_is_call(Parser *parser) {
+    if (parser->kind != IDENTIFIER) {
+        return false;
+    }
+    return parser_is_operator_at(parser, parser->i + 1, PUNCTUATOR_PAREN_OPEN)
+        || (parser_is_operator_at(parser, parser->i + 1, OPERATOR_LESS) && parser_is_generic_call(parser, parser->i + 1));
+}
+
+// Identifier ['<' types '>'] '(' [expression (',' expression)*] ')'
+NodeIndex parse_call(Parser *parser) {
+    NodeIndex call = parser_node(parser, NODE_CALL, parser->i);
+    Symbol symbol = parser->payload;
+    parser_advance(parser);
+    ListIndex solid_types = parse_solid_types(parser);
+    if (!parser_consume(parser, PUNCTUATOR_PAREN_OPEN)) {
+        parser_fail_here(parser, PARSER_ERROR_CALL_EXPECTED_OPEN_PARENTHESES);
+    }
+    int arguments = parser_list_begin(parser);
+    while (!parser->has_failed && !parser_is(parser, PUNCTUATOR_PAREN_CLOSE)) {
+        parser_list_push(parser, parse_expression(parser, 0));
+        if (!parser_consume_separator(parser, ',')) {
+            break;
+        }
+    }
+    ListIndex list = parser_list_end(parser, arguments);
+    if (!parser_consume(parser, PUNCTUATOR_PAREN_CLOSE)) {
+        parser_fail_here(parser, PARSER_ERROR_CALL_EXPECTED_CLOSING_PARENTHESES);
+    }
+    AstNode *node = NODE(call);
+    node->a = symbol;
+    node->b = solid_types;
+    node->c = list;
+    return call;
+}
+
+// ('.' Identifier | '[' expression ']')*
+NodeIndex parse_postfix(Parser *parser, NodeIndex base) {
+    while (!parser->has_failed) {
+        uint32_t token = NODE(base)->token;
+        if (parser_is(parser, PUNCTUATOR_DOT) && parser_kind_at(parser, parser->i + 1) == IDENTIFIER) {
+            parser_advance(parser);
+            NodeIndex access = parser_node(parser, NODE_MEMBER_ACCESS, token);
+            NODE(access)->a = base;
+            NODE(access)->b = parser->payload;
+            parser_advance(parser);
+            base = access;
+        } else if (parser_consume(parser, PUNCTUATOR_BRACKET_OPEN)) {
+            NodeIndex index = parse_expression(parser, 0);
+            if (!parser_consume(parser, PUNCTUATOR_BRACKET_CLOSE)) {
+                parser_fail_here(parser, PARSER_ERROR_SUBSCRIPT_CLOSING_BRACKET);
+            }
+            NodeIndex subscript = parser_node(parser, NODE_SUBSCRIPT, token);
+            NODE(subscript)->a = base;
+            NODE(subscript)->b = index;
+            base = subscript;
+        } else {
+            break;
+        }
+    }
+    return base;
+}
+
+// an operand of a binary operator
+NodeIndex parse_unit(Parser *parser) {
+    uint32_t start = parser->i;
+    if (parser_consume(parser, PUNCTUATOR_PAREN_OPEN)) {
+        NodeIndex expression = parse_expression(parser, 0);
+        if (!parser_consume(parser, PUNCTUATOR_PAREN_CLOSE)) {
+            parser_fail_here(parser, PARSER_ERROR_EXPR_EXPECTED_BRACKETS);
+        }
+        return expression;
+    }
+    if (parser->kind == OPERATOR) {
+        Operator op = parser_operator(parser);
+        parser_advance(parser);
+        NodeIndex argument = parse_unit(parser);
+        NodeIndex unary = parser_node(parser, NODE_UNARY, start);
+        NODE(unary)->operation = (uint8_t) op;
+        NODE(unary)->a = argument;
+        return unary;
+    }
+
+    NodeIndex expression = 0;
+    switch (parser->kind) {
+        case KEYWORD: {
+            Keyword keyword = (Keyword) parser->payload;
+            if (keyword != SIZEOF && keyword != NEW && keyword != CAST) {
+                parser_fail_here(parser, PARSER_ERROR_NOT_IMPLEMENTED);
+                return 0;
+            }
+            parser_advance(parser);
+            if (keyword == CAST) {
+                if (!parser_consume(parser, PUNCTUATOR_PAREN_OPEN)) {
+                    parser_fail_here(parser, PARSER_ERROR_CAST_EXPECTS_TYPE_IN_BRACKETS);
+                }
+                NodeIndex type = parse_type(parser);
+                if (!parser_consume(parser, PUNCTUATOR_PAREN_CLOSE)) {
+                    parser_fail_here(parser, PARSER_ERROR_CAST_EXPECTS_TYPE_IN_BRACKETS);
+                }
+                NodeIndex argument = parse_expression(parser, 0);
+                expression = parser_node(parser, NODE_UNARY, start);
+                NODE(expression)->flags = NODE_FLAG_CAST;
+                NODE(expression)->a = argument;
+                NODE(expression)->b = type;
+            } else {
+                NodeIndex type = parse_type(parser);
+                expression = parser_node(parser, keyword == SIZEOF ? NODE_SIZEOF : NODE_NEW, start);
+                NODE(expression)->a = type;
+            }
+            break;
+        }
+        case INTLITERAL: case BOOLLITERAL:
+            expression = parser_node(parser, NODE_INT_LITERAL, start);
+            if (parser->kind == BOOLLITERAL) {
+                NODE(expression)->flags = NODE_FLAG_BOOL;
+                NODE(expression)->int_value = parser->payload != 0;
+            } else {
+                NODE(expression)->int_value = parser_int_value(parser);
+            }
+            parser_advance(parser);
+            break;
+        case FLOATLITERAL:
+            expression = parser_node(parser, NODE_FLOAT_LITERAL, start);
+            NODE(expression)->float_value = parser_float_value(parser);
+            parser_advance(parser);
+            break;
+        case STRINGLITERAL: {
+            expression = parser_node(parser, NODE_STRING_LITERAL, start);
+            Slice value = parser_string_value(parser);
+            memcpy(&NODE(expression)->a, &value, sizeof(Slice));
+            parser_advance(parser);
+            break;
+        }
+        case NULLLITERAL: case VOIDLITERAL:
+            expression = parser_node(parser, parser->kind == NULLLITERAL ? NODE_NULL_LITERAL : NODE_VOID_LITERAL, start);
+            parser_advance(parser);
+            break;
+        case IDENTIFIER:
+            if (parser_is_call(parser)) {
+                expression = parse_call(parser);
+            } else {
+                expression = parser_node(parser, NODE_VALUE, start);
+                NODE(expression)->a = parser->payload;
+                parser_advance(parser);
+            }
+            break;
+        case PUNCTUATOR: case SEPARATOR:
+            parser_fail_here(parser, PARSER_ERROR_EXPECTED_EXPRESSION);
+            return 0;
+        default:
+            parser_fail_here(parser, PARSER_ERROR_NOT_IMPLEMENTED);
+            return 0;
+    }
+    return parse_postfix(parser, expression);
+}
+
+// Precedence climbing: operands are joined by the operators of at least the priority,
+// the right operand only takes the operators that bind tighter, so the same precedence groups to the left.
+// Every token is read once and the recursion is at most as deep as there are precedence levels
+// (and brackets), nothing but the nodes is allocated.
+NodeIndex parse_expression(Parser *parser, int priority) {
+    NodeIndex left = parse_unit(parser);
+    while (!parser->has_failed) {
+        Operator op = parser_operator(parser);
+        int precedence = binary_precedence(op);
+        if (precedence == PRECEDENCE_NONE || precedence < priority) {
+            break;
+        }
+        parser_consume(parser, op);
+        NodeIndex right = parse_expression(parser, precedence + 1);
+        NodeIndex binary = parser_node(parser, NODE_BINARY, NODE(left)->token);
+        NODE(binary)->operation = (uint8_t) op;
+        NODE(binary)->a = left;
+        NODE(binary)->b = right;
+        left = binary;
+    }
+    return left;
+}
+
+// DECLARATIONS
+
+// Identifier ':' (Identifier | '=' | ':') or Identifier ':='
+bool parser_is_variable(Parser *parser) {
+    if (parser->kind != IDENTIFIER) {
+        return false;
+    }
+    if (parser_is_operator_at(parser, parser->i + 1, OPERATOR_COLON_EQUAL)) {
+        return true;
+    }
+    return parser_is_operator_at(parser, parser->i + 1, PUNCTUATOR_COLON)
+        && (parser_kind_at(parser, parser->i + 2) == IDENTIFIER
+            || parser_is_operator_at(parser, parser->i + 2, OPERATOR_EQUAL)
+            || parser_is_operator_at(parser, parser->i + 2, PUNCTUATOR_COLON));
+}
+
+// name ':' Type ';' | name ':' [Type] '=' expression ';' | name ':' [Type] ':' expression ';' | name ':=' expression ';'
+NodeIndex parse_variable(Parser *parser) {
+    NodeIndex variable = parser_node(parser, NODE_VARIABLE, parser->i);
+    Symbol symbol = parser->payload;
+    parser_advance(parser);
+
+    bool has_value = parser_consume(parser, OPERATOR_COLON_EQUAL);
+    bool is_constant = false;
+    NodeIndex type = 0;
+    if (!has_value) {
+        parser_consume(parser, PUNCTUATOR_COLON);
+        if (parser->kind == IDENTIFIER) {
+            type = parse_type(parser);
+        }
+        if (parser_consume(parser, OPERATOR_EQUAL)) {
+            has_value = true;
+        } else if (parser_consume(parser, PUNCTUATOR_COLON)) {
+            has_value = true;
+            is_constant = true;
+        }
+    }
+
+    NodeIndex expression = 0;
+    if (has_value) {
+        expression = parse_expression(parser, 0);
+    }
+    parser_expect_semicolon(parser);
+
+    AstNode *node = NODE(variable);
+    node->a = symbol;
+    node->b = type;
+    node->c = expression;
+    node->flags = is_constant ? NODE_FLAG_CONSTANT : 0;
+    return variable;
+}
+
+NodeIndex parse_block(Parser *parser, ParserError error);
+
+// 'func' name [generics] '(' [arguments] [',' '...'] ')' ['->' Type] directives* ('{' statements '}' | ';')
+NodeIndex parse_procedure(Parser *parser) {
+    NodeIndex procedure = parser_node(parser, NODE_PROCEDURE, parser->i);
+    parser_advance(parser);
+    if (parser->kind != IDENTIFIER) {
+        parser_fail_here(parser, PARSER_ERROR_PROC_EXPECTED_NAME);
+        return procedure;
+    }
+    Symbol symbol = parser->payload;
+    parser_advance(parser);
+    ListIndex generics = parse_generic_types(parser);
+
+    if (!parser_consume(parser, PUNCTUATOR_PAREN_OPEN)) {
+        parser_fail_here(parser, PARSER_ERROR_EXPECTED_PARENTHESES);
+    }
+    uint8_t flags = 0;
+    int arguments = parser_list_begin(parser);
+    while (!parser->has_failed && !parser_is(parser, PUNCTUATOR_PAREN_CLOSE)) {
+        if (parser_is(parser, PUNCTUATOR_ELLIPSIS)) {
+            if (parser->stack_count == arguments) {
+                parser_fail_here(parser, PARSER_ERROR_PROC_EXPECTED_ARGUMENT_BEFORE_VARARGS);
+            }
+            parser_advance(parser);
+            flags |= NODE_FLAG_VARARGS;
+            break;
+        }
+        if (parser->kind != IDENTIFIER) {
+            parser_fail_here(parser, PARSER_ERROR_PROC_EXPECTED_ARGUMENT_NAME);
+            break;
+        }
+        NodeIndex argument = parser_node(parser, NODE_VARIABLE, parser->i);
+        Symbol name = parser->payload;
+        parser_advance(parser);
+        if (!parser_consume(parser, PUNCTUATOR_COLON)) {
+            parser_fail_here(parser, PARSER_ERROR_PROC_EXPECTED_ARGUMENT_TYPE);
+        }
+        NodeIndex type = parse_type(parser);
+        NODE(argument)->a = name;
+        NODE(argument)->b = type;
+        NODE(argument)->flags = NODE_FLAG_CONSTANT;
+        parser_list_push(parser, argument);
+        if (!parser_consume_separator(parser, ',')) {
+            break;
+        }
+    }
+    ListIndex list = parser_list_end(parser, arguments);
+    if (!parser_consume(parser, PUNCTUATOR_PAREN_CLOSE)) {
+        parser_fail_here(parser, PARSER_ERROR_PROC_ARGUMENT_PARENTHESES);
+    }
+    NodeIndex return_type = 0;
+    if (parser_consume(parser, PUNCTUATOR_ARROW)) {
+        return_type = parse_type(parser);
+    }
+
+    while (parser->kind == DIRECTIVE) {
+        Symbol directive = parser->payload;
+        if (directive == parser->symbol_foreign) {
+            if (flags & NODE_FLAG_FOREIGN) {
+                parser_fail_here(parser, PARSER_ERROR_PROC_DIRECTIVE_DUPLICATE);
+            }
+            if (flags & NODE_FLAG_MAIN) {
+                parser_fail_here(parser, PARSER_ERROR_PROC_DIRECTIVE_CONFLICT);
+            }
+            flags |= NODE_FLAG_FOREIGN;
+        } else if (directive == parser->symbol_main) {
+            if (flags & NODE_FLAG_FOREIGN) {
+                parser_fail_here(parser, PARSER_ERROR_PROC_DIRECTIVE_CONFLICT);
+            }
+            if (flags & NODE_FLAG_MAIN) {
+                parser_fail_here(parser, PARSER_ERROR_PROC_DIRECTIVE_DUPLICATE);
+            }
+            if (parser->has_main) {
+                parser_fail_here(parser, PARSER_ERROR_PROC_MAIN_REDECL);
+            }
+            flags |= NODE_FLAG_MAIN;
+            parser->has_main = true;
+        } else {
+            parser_fail_here(parser, PARSER_ERROR_PROC_UNDECLARED_DIRECTIVE);
+        }
+        if (!parser->has_failed) {
+            parser_advance(parser);
+        }
+    }
+
+    NodeIndex body = 0;
+    if (parser_is(parser, PUNCTUATOR_BRACE_OPEN)) {
+        if (flags & NODE_FLAG_FOREIGN) {
+            parser_fail_here(parser, PARSER_ERROR_PROC_FOREIGN_UNEXPECTED_BODY);
+        }
+        body = parse_block(parser, PARSER_ERROR_PROC_EXPECTED_BODY);
+    } else if (!(flags & NODE_FLAG_FOREIGN)) {
+        parser_fail_here(parser, PARSER_ERROR_PROC_EXPECTED_BODY);
+    }
+
+    AstNode *node = NODE(procedure);
+    node->a = symbol;
+    node->b = generics;
+    node->c = list;
+    node->d = return_type;
+    node->e = body;
+    node->flags = flags;
+    return procedure;
+}
+
+// 'struct' name [generics] '{' variables '}'
+NodeIndex parse_struct(Parser *parser) {
+    NodeIndex structure = parser_node(parser, NODE_STRUCT, parser->i);
+    parser_advance(parser);
+    if (parser->kind != IDENTIFIER) {
+        parser_fail_here(parser, PARSER_ERROR_STRUCT_EXPECTED_NAME);
+        return structure;
+    }
+    Symbol symbol = parser->payload;
+    parser_advance(parser);
+    ListIndex generics = parse_generic_types(parser);
+    if (!parser_consume(parser, PUNCTUATOR_BRACE_OPEN)) {
+        parser_fail_here(parser, PARSER_ERROR_STRUCT_EXPECTED_BRACKETS);
+    }
+    int members = parser_list_begin(parser);
+    while (!parser->has_failed) {
+        if (parser_is_variable(parser)) {
+            parser_list_push(parser, parse_variable(parser));
+        } else if (parser_consume(parser, PUNCTUATOR_BRACE_CLOSE)) {
+            break;
+        } else {
+            parser_fail_here(parser, PARSER_ERROR_STRUCT_EXPECTED_BRACKETS_END);
+        }
+    }
+    AstNode *node = NODE(structure);
+    node->a = symbol;
+    node->b = generics;
+    node->c = parser_list_end(parser, members);
+    return structure;
+}
+
+// STATEMENTS
+
+bool parser_has_loop(Parser *parser, Symbol label) {
+    for (int l = 0; l < parser->loops_count; l++) {
+        if (parser->loops[l] == label) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ('break' | 'continue') [label] ';'
+NodeIndex parse_jump(Parser *parser) {
+    uint32_t start = parser->i;
+    bool is_break = parser_is_keyword(parser, BREAK);
+    NodeIndex jump = parser_node(parser, is_break ? NODE_BREAK : NODE_CONTINUE, start);
+    parser_advance(parser);
+    Symbol label = 0;
+    uint32_t label_token = parser->i;
+    if (parser->kind == IDENTIFIER) {
+        label = parser->payload;
+        parser_advance(parser);
+    }
+    parser_expect_semicolon(parser);
+    if (label != 0 && !parser_has_loop(parser, label)) {
+        parser_fail(parser, PARSER_ERROR_LOOP_LABEL_NOT_FOUND, label_token);
+    } else if (parser->loops_count == 0) {
+        parser_fail(parser, is_break ? PARSER_ERROR_BREAK_CONTEXT : PARSER_ERROR_CONTINUE_CONTEXT, start);
+    }
+    NODE(jump)->a = label;
+    return jump;
+}
+
+// '(' expression ')' of if and while
+NodeIndex parse_condition(Parser *parser) {
+    if (!parser_consume(parser, PUNCTUATOR_PAREN_OPEN)) {
+        parser_fail_here(parser, PARSER_ERROR_EXPECTED_PARENTHESES);
+        return 0;
+    }
+    NodeIndex condition = parse_expression(parser, 0);
+    if (!parser_consume(parser, PUNCTUATOR_PAREN_CLOSE)) {
+        parser_fail_here(parser, PARSER_ERROR_EXPECTED_PARENTHESES);
+    }
+    return condition;
+}
+
+// 'if' condition block ['else' block]
+NodeIndex parse_if(Parser *parser) {
+    NodeIndex branch = parser_node(parser, NODE_IF, parser->i);
+    parser_advance(parser);
+    NodeIndex condition = parse_condition(parser);
+    NodeIndex body = parse_block(parser, PARSER_ERROR_IF_EXPECTED_BRACKETS);
+    NodeIndex otherwise = 0;
+    if (parser_is_keyword(parser, ELSE)) {
+        parser_advance(parser);
+        otherwise = parse_block(parser, PARSER_ERROR_IF_EXPECTED_BRACKETS);
+    }
+    AstNode *node = NODE(branch);
+    node->a = condition;
+    node->b = body;
+    node->c = otherwise;
+    return branch;
+}
+
+bool parser_is_while(Parser *parser) {
+    return parser_is_keyword(parser, WHILE)
+        || (parser->kind == IDENTIFIER && parser_is_operator_at(parser, parser->i + 1, PUNCTUATOR_COLON)
+            && parser_kind_at(parser, parser->i + 2) == KEYWORD && parser_payload_at(parser, parser->i + 2) == WHILE);
+}
+
+// [label ':'] 'while' condition block
+NodeIndex parse_while(Parser *parser) {
+    NodeIndex loop = parser_node(parser, NODE_WHILE, parser->i);
+    Symbol label = 0;
+    if (parser->kind == IDENTIFIER) {
+        label = parser->payload;
+        if (parser_has_loop(parser, label)) {
+            parser_fail_here(parser, PARSER_ERROR_LOOP_LABEL_DUPLICATE);
+            return loop;
+        }
+        parser_advance(parser);
+        parser_advance(parser);
+    }
+    parser_advance(parser);
+    NodeIndex condition = parse_condition(parser);
+
+    if (parser->loops_count == parser->loops_capacity) {
+        parser->loops_capacity *= 2;
+        parser->loops = (Symbol*) realloc(parser->loops, parser->loops_capacity * sizeof(Symbol));
+    }
+    parser->loops[parser->loops_count++] = label;
+    NodeIndex body = parse_block(parser, PARSER_ERROR_LOOP_EXPECTED_BRACKETS);
+    parser->loops_count -= 1;
+
+    AstNode *node = NODE(loop);
+    node->a = label;
+    node->b = condition;
+    node->c = body;
+    return loop;
+}
+
+// receiver ('.' Identifier | '[' expression ']')* '=' expression ';'
+NodeIndex parse_assignment(Parser *parser) {
+    uint32_t start = parser->i;
+    NodeIndex receiver = parser_node(parser, NODE_VALUE, start);
+    NODE(receiver)->a = parser->payload;
+    parser_advance(parser);
+    receiver = parse_postfix(parser, receiver);
+    if (!parser_consume(parser, OPERATOR_EQUAL)) {
+        parser_fail_here(parser, PARSER_ERROR_UNEXPECTED_MEMBER_ACCESS);
+        return receiver;
+    }
+    NodeIndex expression = parse_expression(parser, 0);
+    parser_expect_semicolon(parser);
+    NodeIndex assignment = parser_node(parser, NODE_ASSIGNMENT, start);
+    NODE(assignment)->a = receiver;
+    NODE(assignment)->b = expression;
+    return assignment;
+}
+
+// statements until the '}' that ends the block or the end of the file
+ListIndex parse_statements(Parser *parser) {
+    int statements = parser_list_begin(parser);
+    while (!parser->has_failed) {
+        NodeIndex statement = 0;
+        switch (parser->kind) {
+            case PUNCTUATOR:
+                if (!parser_is(parser, PUNCTUATOR_BRACE_CLOSE)) {
+                    parser_fail_here(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+                }
+                return parser_list_end(parser, statements);
+            case KEYWORD:
+                switch ((Keyword) parser->payload) {
+                    case FUNC:
+                        parser_fail_here(parser, PARSER_ERROR_PROC_NESTED_NOT_SUPPORTED);
+                        break;
+                    case BREAK: case CONTINUE:
+                        statement = parse_jump(parser);
+                        break;
+                    case IF:
+                        statement = parse_if(parser);
+                        break;
+                    case WHILE:
+                        statement = parse_while(parser);
+                        break;
+                    case FREE: {
+                        statement = parser_node(parser, NODE_FREE, parser->i);
+                        parser_advance(parser);
+                        NodeIndex expression = parse_expression(parser, 0);
+                        parser_expect_semicolon(parser);
+                        NODE(statement)->a = expression;
+                        break;
+                    }
+                    case RETURN: {
+                        // the semicolon after the value is left for the next statement, like the Swift parser does
+                        statement = parser_node(parser, NODE_RETURN, parser->i);
+                        parser_advance(parser);
+                        if (!parser_consume_separator(parser, ';')) {
+                            NodeIndex value = parse_expression(parser, 0);
+                            NODE(statement)->a = value;
+                        }
+                        break;
+                    }
+                    default:
+                        parser_fail_here(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+                }
+                break;
+            case IDENTIFIER:
+                if (parser_is_call(parser)) {
+                    statement = parse_call(parser);
+                } else if (parser_is_while(parser)) {
+                    statement = parse_while(parser);
+                } else if (parser_is_variable(parser)) {
+                    statement = parse_variable(parser);
+                } else if (parser_is_operator_at(parser, parser->i + 1, PUNCTUATOR_DOT)
+                           || parser_is_operator_at(parser, parser->i + 1, PUNCTUATOR_BRACKET_OPEN)
+                           || parser_is_operator_at(parser, parser->i + 1, OPERATOR_EQUAL)) {
+                    statement = parse_assignment(parser);
+                } else {
+                    parser_fail_here(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+                }
+                break;
+            case SEPARATOR:
+                if (!parser_consume_separator(parser, ';')) {
+                    parser_fail_here(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+                }
+                break;
+            case ENDOFFILE:
+                return parser_list_end(parser, statements);
+            default:
+                parser_fail_here(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+        }
+        if (statement != 0) {
+            parser_list_push(parser, statement);
+        }
+    }
+    return parser_list_end(parser, statements);
+}
+
+// '{' statements '}', the error is for either bracket missing
+NodeIndex parse_block(Parser *parser, ParserError error) {
+    NodeIndex code = parser_node(parser, NODE_CODE, parser->i);
+    if (!parser_consume(parser, PUNCTUATOR_BRACE_OPEN)) {
+        parser_fail_here(parser, error);
+        return code;
+    }
+    ListIndex statements = parse_statements(parser);
+    if (!parser_consume(parser, PUNCTUATOR_BRACE_CLOSE)) {
+        parser_fail_here(parser, error);
+    }
+    NODE(code)->a = statements;
+    return code;
+}
+
+// PARSER
+
+Parser* parser_create() {
+    Parser *parser = new Parser();
+    memset(parser, 0, sizeof(*parser));
+    parser->stack_capacity = 256;
+    parser->stack = (uint32_t*) malloc(parser->stack_capacity * sizeof(uint32_t));
+    parser->loops_capacity = 16;
+    parser->loops = (Symbol*) malloc(parser->loops_capacity * sizeof(Symbol));
+    return parser;
+}
+
+void parser_free(Parser *parser) {
+    free(parser->stack);
+    free(parser->loops);
+    delete parser;
+}
+
+// parses the tokens of one file, the ast refers to the output, which has to outlive it
+// the symbols of foreign and main are added to the output's interner,
+// unless the tokens are streamed, then the lexer owns the interner and has to add them before it starts
+Ast* parser_parse(Parser *parser, Output *output) {
+    Ast *ast = new Ast();
+    memset(ast, 0, sizeof(*ast));
+    ast->output = output;
+    ast_arena_init(&ast->arena, output->source_length / 8); // about a node for every other token
+
+    parser->output = output;
+    parser->ast = ast;
+    parser->arena = &ast->arena;
+    parser->count = parser->ring ? INT_MAX : output->tokens.count;
+    parser->i = 0;
+    parser->is_greater_split = false;
+    parser->stack_count = 0;
+    parser->loops_count = 0;
+    parser->has_main = false;
+    parser->has_failed = false;
+    parser->generic_rejected_until = 0;
+    if (!parser->ring) {
+        parser->symbol_foreign = interner_intern(output->interner, "foreign", 7);
+        parser->symbol_main = interner_intern(output->interner, "main", 4);
+    }
+
+    ast->root = parser_node(parser, NODE_CODE, 0);
+    if (parser->count == 0) {
+        return ast;
+    }
+    parser_read(parser);
+
+    int declarations = parser_list_begin(parser);
+    while (!parser->has_failed && parser->kind != ENDOFFILE) {
+        NodeIndex declaration = 0;
+        if (parser->kind == KEYWORD) {
+            switch ((Keyword) parser->payload) {
+                case FUNC: declaration = parse_procedure(parser); break;
+                case STRUCT: declaration = parse_struct(parser); break;
+                case IF: parser_fail_here(parser, PARSER_ERROR_IF_NOT_EXPECTED_AT_GLOBAL_SCOPE); break;
+                case WHILE: parser_fail_here(parser, PARSER_ERROR_LOOP_NOT_EXPECTED_AT_GLOBAL_SCOPE); break;
+                case BREAK: parser_fail_here(parser, PARSER_ERROR_BREAK_CONTEXT); break;
+                case CONTINUE: parser_fail_here(parser, PARSER_ERROR_CONTINUE_CONTEXT); break;
+                default: parser_fail_here(parser, PARSER_ERROR_NOT_IMPLEMENTED);
+            }
+        } else if (parser->kind == IDENTIFIER) {
+            if (parser_is_while(parser)) {
+                parser_fail_here(parser, PARSER_ERROR_LOOP_NOT_EXPECTED_AT_GLOBAL_SCOPE);
+            } else if (parser_is_variable(parser)) {
+                declaration = parse_variable(parser);
+            } else {
+                parser_fail_here(parser, PARSER_ERROR_NOT_IMPLEMENTED);
+            }
+        } else {
+            // like the Swift parser, other tokens between declarations are skipped
+            parser_advance(parser);
+        }
+        if (declaration != 0) {
+            parser_list_push(parser, declaration);
+        }
+    }
+    NODE(ast->root)->a = parser_list_end(parser, declarations);
+    return ast;
+}
+
+#undef NODE
@@ -0,0 +1,80 @@
+//
+//  ParserConst.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "../Lexer/LexerConst.hpp"
+
+// PRECEDENCE
+
+// the levels of Precedence in Operations.swift, higher binds tighter
+const unsigned char PRECEDENCE_NONE = 0;
+const unsigned char PRECEDENCE_MULTIPLICATION = 12;
+const unsigned char PRECEDENCE_ADDITION = 11;
+const unsigned char PRECEDENCE_BITWISE_SHIFT = 10;
+const unsigned char PRECEDENCE_COMPARISON = 9;
+const unsigned char PRECEDENCE_EQUALITY = 8;
+const unsigned char PRECEDENCE_BIT_AND = 7;
+const unsigned char PRECEDENCE_BIT_XOR = 6;
+const unsigned char PRECEDENCE_BIT_OR = 5;
+const unsigned char PRECEDENCE_LOGIC_AND = 4;
+const unsigned char PRECEDENCE_LOGIC_OR = 3;
+
+struct BinaryOperator {
+    const char *spelling;
+    unsigned char precedence;
+};
+
+// precedence(of:) of Operations.swift, '&' has the precedence of a bitwise or there too
+// '^' and '|' are not lexed as operators, so they are not in the table
+constexpr BinaryOperator binary_operators[] = {
+    { "*", PRECEDENCE_MULTIPLICATION }, { "/", PRECEDENCE_MULTIPLICATION }, { "%", PRECEDENCE_MULTIPLICATION },
+    { "+", PRECEDENCE_ADDITION }, { "-", PRECEDENCE_ADDITION },
+    { "<<", PRECEDENCE_BITWISE_SHIFT }, { ">>", PRECEDENCE_BITWISE_SHIFT },
+    { "<", PRECEDENCE_COMPARISON }, { ">", PRECEDENCE_COMPARISON },
+    { "<=", PRECEDENCE_COMPARISON }, { ">=", PRECEDENCE_COMPARISON },
+    { "==", PRECEDENCE_EQUALITY }, { "!=", PRECEDENCE_EQUALITY },
+    { "&", PRECEDENCE_BIT_OR },
+    { "&&", PRECEDENCE_LOGIC_AND },
+    { "||", PRECEDENCE_LOGIC_OR }
+};
+constexpr int BINARY_OPERATORS_COUNT = sizeof(binary_operators) / sizeof(binary_operators[0]);
+
+// the precedence of every Operator, so the parser looks it up with the payload of the token
+struct PrecedenceTable {
+    unsigned char precedences[OPERATOR_COUNT]; // PRECEDENCE_NONE for punctuators and other operators
+    int found_count; // of binary_operators, all of them have to be lexed
+};
+
+constexpr bool spellings_equal(const char *lhs, const char *rhs) {
+    int c = 0;
+    while (lhs[c] != 0 && lhs[c] == rhs[c]) {
+        c++;
+    }
+    return lhs[c] == rhs[c];
+}
+
+constexpr PrecedenceTable make_precedence_table() {
+    PrecedenceTable table = {};
+    for (int o = OPERATOR_FIRST; o < OPERATOR_COUNT; o++) {
+        for (int b = 0; b < BINARY_OPERATORS_COUNT; b++) {
+            if (spellings_equal(operator_spellings[o], binary_operators[b].spelling)) {
+                table.precedences[o] = binary_operators[b].precedence;
+                table.found_count += 1;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr PrecedenceTable precedence_table = make_precedence_table();
+static_assert(precedence_table.found_count == BINARY_OPERATORS_COUNT, "a binary operator is not lexed");
+
+inline unsigned char binary_precedence(Operator op) {
+    return precedence_table.precedences[op];
+}
@@ -0,0 +1,145 @@
+//
+//  ParserErrors.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+// the ParserMessage cases of the Swift parser that don't need types or declarations to be found
+enum ParserError {
+    PARSER_ERROR_UNEXPECTED_END_OF_FILE,
+    PARSER_ERROR_NOT_IMPLEMENTED,
+    PARSER_ERROR_EXPECTED_SEMICOLON,
+    PARSER_ERROR_EXPECTED_EXPRESSION,
+    PARSER_ERROR_EXPECTED_PARENTHESES,
+    PARSER_ERROR_EXPR_EXPECTED_BRACKETS,
+    PARSER_ERROR_UNEXPECTED_TOKEN,
+    PARSER_ERROR_EXPECTED_TYPE,
+    PARSER_ERROR_SUBSCRIPT_CLOSING_BRACKET,
+    PARSER_ERROR_ARRAY_CLOSING_BRACKET,
+    PARSER_ERROR_CAST_EXPECTS_TYPE_IN_BRACKETS,
+    PARSER_ERROR_EXPECTED_MEMBER_IDENTIFIER,
+    PARSER_ERROR_UNEXPECTED_MEMBER_ACCESS,
+    PARSER_ERROR_IF_EXPECTED_BRACKETS,
+    PARSER_ERROR_IF_NOT_EXPECTED_AT_GLOBAL_SCOPE,
+    PARSER_ERROR_LOOP_NOT_EXPECTED_AT_GLOBAL_SCOPE,
+    PARSER_ERROR_LOOP_EXPECTED_BRACKETS,
+    PARSER_ERROR_LOOP_LABEL_DUPLICATE,
+    PARSER_ERROR_LOOP_LABEL_NOT_FOUND,
+    PARSER_ERROR_BREAK_CONTEXT,
+    PARSER_ERROR_CONTINUE_CONTEXT,
+    PARSER_ERROR_CALL_EXPECTED_OPEN_PARENTHESES,
+    PARSER_ERROR_CALL_EXPECTED_CLOSING_PARENTHESES,
+    PARSER_ERROR_PROC_NESTED_NOT_SUPPORTED,
+    PARSER_ERROR_PROC_ARGUMENT_PARENTHESES,
+    PARSER_ERROR_PROC_FOREIGN_UNEXPECTED_BODY,
+    PARSER_ERROR_PROC_EXPECTED_BODY,
+    PARSER_ERROR_PROC_EXPECTED_ARGUMENT_TYPE,
+    PARSER_ERROR_PROC_EXPECTED_ARGUMENT_NAME,
+    PARSER_ERROR_PROC_EXPECTED_ARGUMENT_BEFORE_VARARGS,
+    PARSER_ERROR_PROC_UNDECLARED_DIRECTIVE,
+    PARSER_ERROR_PROC_MAIN_REDECL,
+    PARSER_ERROR_PROC_DIRECTIVE_DUPLICATE,
+    PARSER_ERROR_PROC_DIRECTIVE_CONFLICT,
+    PARSER_ERROR_PROC_EXPECTED_NAME,
+    PARSER_ERROR_STRUCT_EXPECTED_NAME,
+    PARSER_ERROR_STRUCT_EXPECTED_BRACKETS,
+    PARSER_ERROR_STRUCT_EXPECTED_BRACKETS_END,
+    PARSER_ERROR_STRUCT_EXPECTED_CLOSING_TRIANGLE_BRACKET,
+    PARSER_ERROR_STRUCT_EXPECTED_GENERIC_TYPE,
+    PARSER_ERROR_CALL_TYPES_TOO_LONG, // not in the Swift parser, see parser_is_generic_call
+    PARSER_ERROR_COUNT
+};
+typedef enum ParserError ParserError;
+
+// the names of the ParserMessage members, which the tests use
+const char* const parser_error_names[PARSER_ERROR_COUNT] = {
+    "unexpectedEndOfFile",
+    "notImplemented",
+    "expectedSemicolon",
+    "expectedExpression",
+    "expectedParentheses",
+    "exprExpectedBrackets",
+    "unexpectedToken",
+    "expectedType",
+    "subscriptClosingBracket",
+    "arrayClosingBracket",
+    "castExpectsTypeInBrackets",
+    "expectedMemberIdentifier",
+    "unexpectedMemberAccess",
+    "ifExpectedBrackets",
+    "ifNotExpectedAtGlobalScope",
+    "loopNotExpectedAtGlobalScope",
+    "loopExpectedBrackets",
+    "loopLabelDuplicate",
+    "loopLabelNotFound",
+    "breakContext",
+    "continueContext",
+    "callExpectedOpenParentheses",
+    "callExpectedClosingParentheses",
+    "procNestedNotSupported",
+    "procArgumentParentheses",
+    "procForeignUnexpectedBody",
+    "procExpectedBody",
+    "procExpectedArgumentType",
+    "procExpectedArgumentName",
+    "procExpectedArgumentBeforeVarargs",
+    "procUndeclaredDirective",
+    "procMainRedecl",
+    "procDirectiveDuplicate",
+    "procDirectiveConflict",
+    "procExpectedName",
+    "structExpectedName",
+    "structExpectedBrackets",
+    "structExpectedBracketsEnd",
+    "structExpectedClosingTriangleBracket",
+    "structExpectedGenericType",
+    "callTypesTooLong"
+};
+
+const char* const parser_error_messages[PARSER_ERROR_COUNT] = {
+    "Unexpected end of file.",
+    "Token not implemented.",
+    "Expected ';' after an expression.",
+    "Expected expression.",
+    "Parentheses are expected around the condition expression.",
+    "Expected closing bracket after expression.",
+    "Unexpected token.",
+    "Expected type declaration.",
+    "Closing square bracket is expected after subscript index expression.",
+    "Closing square bracket is expected after array length expression.",
+    "Expected type in round brackets after 'cast'.",
+    "Expected identifier after '.' for member access.",
+    "Unexpected member access expression.",
+    "Expected brackets around if-else blocks.",
+    "If statement is not expected at the global scope",
+    "While statement is not expected at the global scope",
+    "Expected brackets around a loop body.",
+    "Break with this label is already declared in the current scope.",
+    "Loop with this label is not found in the current scope.",
+    "Break can't be used outside of loop or switch.",
+    "Continue can't be used outside of loop or switch.",
+    "Open parentheses is expected after arguments.",
+    "Closing parentheses is expected after arguments.",
+    "Nested procedure declarations are not supported.",
+    "Expected parentheses around arguments declaration.",
+    "Foreign procedure can not declare a body.",
+    "Procedure is expected to have a body.",
+    "Expected a type of an argument after colon.",
+    "Expected argument name.",
+    "Variadic argument requires definition before '...'.",
+    "Undeclared procedure directive.",
+    "Redeclaration of the entry procedure.",
+    "Duplicate procedure directive.",
+    "Directive conflicts with a previously declared directive.",
+    "Expected procedure name identifier after 'func'.",
+    "Expected struct name after 'struct'.",
+    "Expected brackets for structure declaration.",
+    "Expected brackets after structure members.",
+    "Expected '>' after a list of types for a generic struct declaration.",
+    "Expected type name for a generic struct declaration.",
+    "The list of types is too long to tell a call from comparisons."
+};
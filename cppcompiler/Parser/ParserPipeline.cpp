@@ -0,0 +1,71 @@
+//
+//  ParserPipeline.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include "TokenRing.hpp"
+#include <thread>
+
+// Lexes and parses a file at the same time: the lexer runs on the calling thread and hands its tokens
+// to a parser on another thread through a TokenRing, a batch at a time.
+// The lexer's arena only holds the batch being lexed and the ring holds at most TOKEN_RING_CAPACITY tokens,
+// so the tokens take the same memory for any file, only the string values and the diagnostics grow with it.
+// The tree is the same as the one parser_parse builds from the output of lexer_analyze.
+
+// parses the string while it's lexed, the output is ast->output and has to be freed by the caller after the ast
+// the output has the diagnostics and the strings, but not the tokens, tokens_count is the number there were
+// peak_tokens is the most tokens that were held at once, in the lexer's arena and in the ring
+Ast* lexer_parse_pipelined(Lexer *lexer, Parser *parser, char *string, int count, int *peak_tokens) {
+    Output *output = output_create(string, count, &lexer->interner);
+    lexer_start(lexer, output, string, count, 0);
+
+    // interned before the parser starts, from then on only the lexer's thread adds symbols
+    parser->symbol_foreign = interner_intern(output->interner, "foreign", 7);
+    parser->symbol_main = interner_intern(output->interner, "main", 4);
+
+    TokenRing ring;
+    token_ring_init(&ring);
+    parser->ring = &ring;
+
+    Ast *ast = NULL;
+    std::thread consumer([&] {
+        ast = parser_parse(parser, output);
+        token_ring_drain(&ring);
+    });
+
+    int first = 0; // the index in the file of the batch's first token
+    bool has_more = lexer->characters_count > lexer->i;
+    while (true) {
+        int diagnostics_count = output->diagnostics.count;
+        while (has_more && output->tokens.count < TOKEN_RING_BATCH) {
+            has_more = lex_token(lexer) && lexer->characters_count > lexer->i;
+        }
+        int batch_count = output->tokens.count;
+        if (!has_more && (batch_count == 0 || token_arena_kind(&output->tokens, batch_count - 1) != ENDOFFILE)) {
+            // lexer_analyze doesn't make one for an empty file, the parser always needs one
+            token_arena_push(&output->tokens, ENDOFFILE, lexer->i, lexer->i, 0);
+        }
+
+        for (int d = diagnostics_count; d < output->diagnostics.count; d++) {
+            output->diagnostics.items[d].token += first;
+        }
+        token_ring_publish(&ring, output, first);
+        first += output->tokens.count;
+        token_arena_reset(&output->tokens);
+        if (!has_more) {
+            break;
+        }
+    }
+    token_ring_finish(&ring);
+
+    consumer.join();
+    *peak_tokens = output->tokens.high_water_mark + ring.high_water_mark;
+    parser->ring = NULL;
+    token_ring_free(&ring);
+    output->tokens_count = first;
+    lexer->output = NULL;
+    return ast;
+}
@@ -0,0 +1,166 @@
+//
+//  ParserTest.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+// Checks parser_parse against the cases of the Swift parser, that the programs parse without errors,
+// and that long chains of binary operators are parsed into the right trees.
+// Everything is parsed again while it's lexed, see ParserPipeline.cpp, which has to build the same tree.
+//
+// parsertest.app [cases.txt]
+
+#include "TestCases.hpp"
+#include "../ParserPipeline.cpp"
+
+using namespace std;
+
+const char* const PARSER_TEST_DEFAULT_CASES = "cppcompiler/Parser/Test/ParserTestCases.txt";
+
+// TEST CASES
+
+// the error name, with its cursors when the expected error has them
+std::string format_error(Ast *ast, bool with_cursors) {
+    if (!ast->has_failed) {
+        return "";
+    }
+    std::string error = parser_error_names[ast->error];
+    if (!with_cursors) {
+        return error;
+    }
+    return format_cursors(ast->output, ast->error_offset, ast->error_end_offset) + error;
+}
+
+// PIPELINE
+
+// the same nodes with the same tokens, and the same lists
+bool ast_equal(Ast *lhs, Ast *rhs) {
+    return lhs->root == rhs->root
+        && lhs->arena.count == rhs->arena.count && lhs->arena.extra_count == rhs->arena.extra_count
+        && memcmp(lhs->arena.nodes, rhs->arena.nodes, lhs->arena.count * sizeof(AstNode)) == 0
+        && memcmp(lhs->arena.extra, rhs->arena.extra, lhs->arena.extra_count * sizeof(uint32_t)) == 0;
+}
+
+// parses the code again while it's lexed, it has to give the tree of parser_parse
+// without holding more tokens than a batch and the ring
+bool check_pipelined(Lexer *lexer, Parser *parser, char *code, int count, Ast *expected, const char *name) {
+    int peak_tokens;
+    Ast *ast = lexer_parse_pipelined(lexer, parser, code, count, &peak_tokens);
+    bool is_same = format_error(ast, true) == format_error(expected, true) && ast_equal(ast, expected);
+    if (!is_same) {
+        cout << name << ": the pipeline has parsed it differently" << endl;
+    }
+    bool is_bounded = peak_tokens > 0 && peak_tokens <= TOKEN_RING_BATCH + 1 + TOKEN_RING_CAPACITY;
+    if (!is_bounded) {
+        cout << name << ": the pipeline has held " << peak_tokens << " tokens at once" << endl;
+    }
+    Output *output = ast->output;
+    ast_free(ast);
+    output_free(output);
+    return is_same && is_bounded;
+}
+
+bool run_test_case(Lexer *lexer, Parser *parser, TestCase *test_case, std::ostringstream &report, void *context) {
+    (void) context;
+    char *buffer;
+    Output *output = test_case_lex(lexer, test_case, &buffer);
+    Ast *ast = parser_parse(parser, output);
+
+    std::string expected_error = test_case_error(test_case);
+    bool with_cursors = !expected_error.empty() && expected_error[0] == '@';
+    bool is_passing = errors_match(expected_error, format_error(ast, with_cursors), report);
+    if (expected_error.empty()) {
+        is_passing &= lines_match("Expected", test_case_lines(test_case, "ast"), split_lines(ast_format(ast)), report);
+    }
+    is_passing &= check_pipelined(lexer, parser, buffer, (int) test_case->code.size(), ast, test_case->name.c_str());
+
+    ast_free(ast);
+    output_free(output);
+    free(buffer);
+    return is_passing;
+}
+
+// PROGRAMS
+
+bool check_program(Lexer *lexer, Parser *parser, SourceBuffer *source, Ast *ast, const char *path, void *context) {
+    (void) context;
+    return check_pipelined(lexer, parser, source->characters, source->length, ast, path);
+}
+
+// EXPRESSIONS
+
+const int PARSER_TEST_CHAIN_LENGTH = 100000;
+
+// the depth of the left operands below the node, which is the length of a chain grouped to the left
+int left_depth(Ast *ast, NodeIndex index, Operator op) {
+    int depth = 0;
+    while (ast->arena.nodes[index].kind == NODE_BINARY && ast->arena.nodes[index].operation == op) {
+        index = ast->arena.nodes[index].a;
+        depth += 1;
+    }
+    return depth;
+}
+
+// a long chain is as slow as the parser is for every token, an identifier followed by '<' is looked past
+int run_expression_checks() {
+    const char *operators[] = { " < ", " + ", " - ", " * " };
+    std::string code = "func main() {";
+    for (const char *op : operators) {
+        code += " x := a0";
+        for (int o = 1; o < PARSER_TEST_CHAIN_LENGTH; o++) {
+            code += op;
+            code += "a" + std::to_string(o);
+        }
+        code += ";";
+    }
+    code += " }";
+
+    char *buffer = (char*) calloc(code.size() + SOURCE_BUFFER_PADDING, 1);
+    memcpy(buffer, code.data(), code.size());
+    Lexer *lexer = lexer_create();
+    Parser *parser = parser_create();
+    Output *output = lexer_analyze(lexer, buffer, (int) code.size());
+    Ast *ast = parser_parse(parser, output);
+
+    int failed = 0;
+    if (ast->has_failed) {
+        failed += 1;
+        print_parser_error(ast);
+    } else if (!check_pipelined(lexer, parser, buffer, (int) code.size(), ast, "operator chains")) {
+        failed += 1;
+    } else {
+        AstArena *arena = &ast->arena;
+        NodeIndex procedure = ast_list_items(arena, arena->nodes[ast->root].a)[0];
+        ListIndex statements = arena->nodes[arena->nodes[procedure].e].a;
+        const Operator operations[] = { OPERATOR_LESS, OPERATOR_PLUS, OPERATOR_MINUS, OPERATOR_ASTERISK };
+        for (int s = 0; s < 4; s++) {
+            NodeIndex expression = arena->nodes[ast_list_items(arena, statements)[s]].c;
+            int depth = left_depth(ast, expression, operations[s]);
+            if (depth != PARSER_TEST_CHAIN_LENGTH - 1) {
+                failed += 1;
+                cout << "A chain of" << operators[s] << "is " << depth << " deep" << endl;
+            }
+        }
+    }
+    ast_free(ast);
+    output_free(output);
+    parser_free(parser);
+    lexer_free(lexer);
+    free(buffer);
+
+    if (failed != 0) {
+        cout << failed << " operator chains were parsed wrong!" << endl;
+    } else {
+        cout << "All operator chains are grouped to the left." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *cases_path = argc > 1 ? argv[1] : PARSER_TEST_DEFAULT_CASES;
+    int result = test_cases_run(cases_path, "parser", run_test_case, NULL);
+    result |= test_programs_run("parsed", check_program, NULL);
+    return run_expression_checks() | result;
+}
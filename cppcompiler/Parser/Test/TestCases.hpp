@@ -0,0 +1,207 @@
+//
+//  TestCases.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "../../Lexer/Lexer.cpp"
+#include "../../Lexer/SourceBuffer.hpp"
+#include "../Parser.cpp"
+#include <sstream>
+#include <vector>
+#include <map>
+
+// What the tests of the passes after the lexer share: the cases file, the programs every pass has to accept,
+// and how a mismatch is reported.
+//
+// A cases file is a list of "=== name" followed by sections that start with "--- section".
+// "--- code" keeps every line, other sections skip empty lines and lines that start with #.
+
+// lexertest.yw is a lexer input, not a program
+const char* const TEST_PROGRAMS[] = {
+    "programs/array.yw", "programs/casting.yw", "programs/list.yw", "programs/list_g.yw", "programs/transform_g.yw"
+};
+
+struct TestCase {
+    std::string name;
+    std::string code;
+    std::map<std::string, std::vector<std::string>> sections; // without code
+};
+typedef struct TestCase TestCase;
+
+std::vector<TestCase> test_cases_parse(const char *characters, long length) {
+    std::vector<TestCase> cases;
+    std::string section;
+    bool is_first_code_line = false;
+
+    std::istringstream stream(std::string(characters, length));
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.compare(0, 4, "=== ") == 0) {
+            cases.push_back(TestCase());
+            cases.back().name = line.substr(4);
+            section = "";
+        } else if (line.compare(0, 4, "--- ") == 0) {
+            section = line.substr(4);
+            is_first_code_line = true;
+        } else if (cases.empty() || (section != "code" && (line.empty() || line[0] == '#'))) {
+            continue;
+        } else if (section == "code") {
+            if (!is_first_code_line) {
+                cases.back().code.push_back('\n');
+            }
+            cases.back().code.append(line);
+            is_first_code_line = false;
+        } else {
+            cases.back().sections[section].push_back(line);
+        }
+    }
+
+    return cases;
+}
+
+// the lines of the section, none when the case doesn't have it
+std::vector<std::string> test_case_lines(TestCase *test_case, const char *section) {
+    auto found = test_case->sections.find(section);
+    return found != test_case->sections.end() ? found->second : std::vector<std::string>();
+}
+
+// the expected error, empty when the code has to pass
+std::string test_case_error(TestCase *test_case) {
+    auto lines = test_case_lines(test_case, "error");
+    return lines.empty() ? "" : lines[0];
+}
+
+// lexed from a copy of the code with the padding the lexer needs, the buffer is freed by the caller
+Output* test_case_lex(Lexer *lexer, TestCase *test_case, char **buffer) {
+    *buffer = (char*) calloc(test_case->code.size() + SOURCE_BUFFER_PADDING, 1);
+    memcpy(*buffer, test_case->code.data(), test_case->code.size());
+    return lexer_analyze(lexer, *buffer, (int) test_case->code.size());
+}
+
+std::vector<std::string> split_lines(const std::string &text) {
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// REPORTS
+
+// "@line:character-line:character " as the expected errors write them
+std::string format_cursors(Output *output, uint32_t offset, uint32_t end_offset) {
+    Cursor start = output_cursor_at(output, offset);
+    Cursor end = output_cursor_at(output, end_offset);
+    char cursors[64];
+    snprintf(cursors, sizeof(cursors), "@%d:%d-%d:%d ", start.line_number, start.character,
+             end.line_number, end.character);
+    return cursors;
+}
+
+// the cursors are only compared when the expected error has them
+bool errors_match(const std::string &expected, const std::string &error, std::ostringstream &report) {
+    if (error == expected) {
+        return true;
+    }
+    report << "Error: expected '" << expected << "', got '" << error << "'\n";
+    return false;
+}
+
+bool lines_match(const char *title, const std::vector<std::string> &expected, const std::vector<std::string> &lines,
+                 std::ostringstream &report) {
+    if (lines == expected) {
+        return true;
+    }
+    report << title << ":\n";
+    for (auto &line : expected) {
+        report << line << "\n";
+    }
+    report << "Got:\n";
+    for (auto &line : lines) {
+        report << line << "\n";
+    }
+    return false;
+}
+
+// RUNNING
+
+typedef bool (*TestCaseRun)(Lexer *lexer, Parser *parser, TestCase *test_case, std::ostringstream &report,
+                            void *context);
+
+// prints the report of every case that fails, returns 1 if any did
+int test_cases_run(const char *path, const char *pass, TestCaseRun run, void *context) {
+    SourceBuffer source;
+    if (!source_buffer_open(&source, path)) {
+        cout << "Could not load file: " << path << endl;
+        return 1;
+    }
+    auto cases = test_cases_parse(source.characters, source.length);
+    source_buffer_free(&source);
+
+    Lexer *lexer = lexer_create();
+    Parser *parser = parser_create();
+    int failed = 0;
+    for (auto &test_case : cases) {
+        std::ostringstream report;
+        if (!run(lexer, parser, &test_case, report, context)) {
+            failed += 1;
+            cout << test_case.name << "\n" << test_case.code << "\n\n" << report.str() << "\n";
+        }
+    }
+    parser_free(parser);
+    lexer_free(lexer);
+
+    if (failed != 0) {
+        cout << failed << " " << pass << " test" << (failed == 1 ? "" : "s") << " have failed!" << endl;
+    } else {
+        cout << "All " << pass << " tests have passed (" << cases.size() << " run)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// the program was parsed, prints why when it fails
+typedef bool (*TestProgramCheck)(Lexer *lexer, Parser *parser, SourceBuffer *source, Ast *ast, const char *path,
+                                 void *context);
+
+// every one of the programs has to parse, and pass the check, done is what the pass did to them
+int test_programs_run(const char *done, TestProgramCheck check, void *context) {
+    Lexer *lexer = lexer_create();
+    Parser *parser = parser_create();
+    int failed = 0;
+    for (const char *path : TEST_PROGRAMS) {
+        SourceBuffer source;
+        if (!source_buffer_open(&source, path)) {
+            cout << "Could not load file: " << path << endl;
+            failed += 1;
+            continue;
+        }
+        Output *output = lexer_analyze(lexer, source.characters, source.length);
+        Ast *ast = parser_parse(parser, output);
+        if (ast->has_failed) {
+            failed += 1;
+            cout << path << ": ";
+            print_parser_error(ast);
+        } else if (!check(lexer, parser, &source, ast, path, context)) {
+            failed += 1;
+        }
+        ast_free(ast);
+        output_free(output);
+        source_buffer_free(&source);
+    }
+    parser_free(parser);
+    lexer_free(lexer);
+
+    if (failed != 0) {
+        cout << failed << " programs could not be " << done << "!" << endl;
+    } else {
+        cout << "All programs have been " << done << "." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
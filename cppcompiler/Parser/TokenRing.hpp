@@ -0,0 +1,166 @@
+//
+//  TokenRing.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "../Lexer/Lexer.hpp"
+#include <atomic>
+#include <thread>
+
+// A single producer, single consumer queue of tokens, so that a file is lexed and parsed at the same time.
+// The lexer publishes tokens at the head, and the parser releases them at the tail once it won't look at them again,
+// so only TOKEN_RING_CAPACITY tokens are in memory however long the file is.
+// Tokens keep their index in the file, their slot is the index modulo the capacity.
+// Literal values are copied into the slot, because the lexer reuses its side tables for the next batch.
+// Both sides wait by spinning and then yielding, there are no locks.
+
+const int TOKEN_RING_CAPACITY = 1 << 12; // a power of two
+const int TOKEN_RING_BATCH = 256; // tokens published or released at once, so the counters are shared less often
+const int TOKEN_RING_SPINS = 64; // before a waiting side yields its core
+
+struct RingToken {
+    union {
+        int64_t int_value;
+        double float_value;
+        Slice string_value;
+        struct {
+            Symbol type_symbol; // of identifiers, without the trailing asterisks of pointer types
+            int pointer_depth; // the number of asterisks
+        };
+    };
+    uint32_t offset;
+    uint32_t end_offset;
+    uint32_t payload; // as in the token arena
+    uint8_t kind;
+};
+typedef struct RingToken RingToken;
+
+struct TokenRing {
+    RingToken *tokens;
+    alignas(64) std::atomic<int> head; // tokens published, written by the lexer
+    alignas(64) std::atomic<int> tail; // tokens released, written by the parser
+    alignas(64) std::atomic<int> count; // of the file once the last token is published, -1 until then
+    alignas(64) int known_head; // the parser's copy of the head, only reloaded when it needs more tokens
+    int high_water_mark; // the most tokens published and not released yet, as the lexer saw it, written by the lexer
+};
+typedef struct TokenRing TokenRing;
+
+void token_ring_init(TokenRing *ring) {
+    ring->tokens = (RingToken*) malloc(TOKEN_RING_CAPACITY * sizeof(RingToken));
+    ring->head.store(0);
+    ring->tail.store(0);
+    ring->count.store(-1);
+    ring->known_head = 0;
+    ring->high_water_mark = 0;
+}
+
+void token_ring_free(TokenRing *ring) {
+    free(ring->tokens);
+    ring->tokens = NULL;
+}
+
+void token_ring_pause(int *spins) {
+    if (++*spins > TOKEN_RING_SPINS) {
+        std::this_thread::yield();
+    }
+}
+
+// PRODUCER
+
+// copies the tokens of the arena into the ring, waiting for the parser to release enough slots,
+// the first of them has the index first in the file
+void token_ring_publish(TokenRing *ring, Output *output, int first) {
+    TokenArena *arena = &output->tokens;
+    int head = ring->head.load(std::memory_order_relaxed);
+    int spins = 0;
+    while (head + arena->count - ring->tail.load(std::memory_order_acquire) > TOKEN_RING_CAPACITY) {
+        token_ring_pause(&spins);
+    }
+
+    for (int t = 0; t < arena->count; t++) {
+        int index_in_chunk;
+        TokenChunk *chunk = &arena->chunks[token_arena_chunk_of(t, &index_in_chunk)];
+        RingToken *token = &ring->tokens[(first + t) & (TOKEN_RING_CAPACITY - 1)];
+        token->kind = chunk->kinds[index_in_chunk];
+        token->offset = chunk->offsets[index_in_chunk];
+        token->end_offset = chunk->end_offsets[index_in_chunk];
+        token->payload = chunk->payloads[index_in_chunk];
+        token->int_value = 0;
+        switch (token->kind) {
+            case INTLITERAL: token->int_value = token_arena_int_value(arena, token->payload); break;
+            case FLOATLITERAL: token->float_value = arena->float_values[token->payload]; break;
+            case STRINGLITERAL: token->string_value = arena->string_values[token->payload]; break;
+            case IDENTIFIER: {
+                // the parser can't intern while the lexer does, so the names of pointer types are looked up here
+                const char *characters = interner_characters(output->interner, token->payload);
+                int length = interner_length(output->interner, token->payload);
+                int depth = 0;
+                while (length - depth > 1 && characters[length - depth - 1] == '*') {
+                    depth += 1;
+                }
+                token->type_symbol = depth > 0 ? interner_intern(output->interner, characters, length - depth)
+                                               : token->payload;
+                token->pointer_depth = depth;
+                break;
+            }
+        }
+    }
+    ring->head.store(head + arena->count, std::memory_order_release);
+    int held = head + arena->count - ring->tail.load(std::memory_order_relaxed);
+    if (held > ring->high_water_mark) {
+        ring->high_water_mark = held;
+    }
+}
+
+// after the last token is published
+void token_ring_finish(TokenRing *ring) {
+    ring->count.store(ring->head.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+// CONSUMER
+
+// waits until the token is published, returns the index of the last token instead when the file has fewer
+int token_ring_wait(TokenRing *ring, int index) {
+    int spins = 0;
+    while (index >= ring->known_head) {
+        ring->known_head = ring->head.load(std::memory_order_acquire);
+        if (index < ring->known_head) {
+            break;
+        }
+        int count = ring->count.load(std::memory_order_acquire);
+        if (count >= 0) {
+            ring->known_head = count;
+            if (index >= count) {
+                return count - 1;
+            }
+        }
+        token_ring_pause(&spins);
+    }
+    return index;
+}
+
+// the token has to be published and not released, see token_ring_wait
+inline RingToken* token_ring_at(TokenRing *ring, int index) {
+    return &ring->tokens[index & (TOKEN_RING_CAPACITY - 1)];
+}
+
+// the tokens before the index won't be looked at again
+void token_ring_release(TokenRing *ring, int index) {
+    if (index - ring->tail.load(std::memory_order_relaxed) >= TOKEN_RING_BATCH) {
+        ring->tail.store(index, std::memory_order_release);
+    }
+}
+
+// releases everything until the lexer is done, for a parser that stopped early
+void token_ring_drain(TokenRing *ring) {
+    int spins = 0;
+    while (ring->count.load(std::memory_order_acquire) < 0) {
+        ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+        token_ring_pause(&spins);
+    }
+}
@@ -0,0 +1,141 @@
+//
+//  Instances.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+// A generic procedure or struct is solidified once for every list of solid types it's used with,
+// like solidifyProcedure() of Parser.swift, and the instances are kept in an InstanceCache.
+// The types are interned, so the key is the declaration and the ids of the solid types.
+// An instance keeps the types of the declaration with the solid types put in:
+// the arguments and the return type of a procedure, the members of a struct.
+
+struct Instance {
+    uint32_t declaration; // the NodeIndex of the PROCEDURE or STRUCT
+    uint32_t types; // into InstanceCache::extra: the count of solid types, the solid types, then the solidified types
+    uint32_t hash;
+};
+typedef struct Instance Instance;
+
+struct InstanceCache {
+    Instance *instances;
+    int count;
+    int capacity;
+
+    TypeId *extra;
+    int extra_count;
+    int extra_capacity;
+
+    uint32_t *slots; // instance + 1, 0 is an empty slot
+    unsigned int slots_capacity; // power of 2
+
+    // of every file since the cache was made
+    long lookups_count;
+    long hits_count;
+};
+typedef struct InstanceCache InstanceCache;
+
+void instance_cache_grow_slots(InstanceCache *cache) {
+    unsigned int capacity = cache->slots_capacity == 0 ? 256 : cache->slots_capacity * 2;
+    uint32_t *slots = (uint32_t*) calloc(capacity, sizeof(uint32_t));
+    for (int i = 0; i < cache->count; i++) {
+        unsigned int index = cache->instances[i].hash & (capacity - 1);
+        while (slots[index] != 0) {
+            index = (index + 1) & (capacity - 1);
+        }
+        slots[index] = i + 1;
+    }
+    free(cache->slots);
+    cache->slots = slots;
+    cache->slots_capacity = capacity;
+}
+
+void instance_cache_init(InstanceCache *cache) {
+    memset(cache, 0, sizeof(*cache));
+    cache->capacity = 64;
+    cache->instances = (Instance*) malloc(cache->capacity * sizeof(Instance));
+    cache->extra_capacity = 1024;
+    cache->extra = (TypeId*) malloc(cache->extra_capacity * sizeof(TypeId));
+    instance_cache_grow_slots(cache);
+}
+
+void instance_cache_free(InstanceCache *cache) {
+    free(cache->instances);
+    free(cache->extra);
+    free(cache->slots);
+    memset(cache, 0, sizeof(*cache));
+}
+
+// the declarations are nodes of one file, so the instances are forgotten before the next one, the counts are kept
+void instance_cache_reset(InstanceCache *cache) {
+    cache->count = 0;
+    cache->extra_count = 0;
+    memset(cache->slots, 0, cache->slots_capacity * sizeof(uint32_t));
+}
+
+inline int instance_solid_count(InstanceCache *cache, int instance) {
+    return cache->extra[cache->instances[instance].types];
+}
+
+// the pointers are only valid until the next instance is added
+inline TypeId* instance_solid_types(InstanceCache *cache, int instance) {
+    return cache->extra + cache->instances[instance].types + 1;
+}
+
+inline TypeId* instance_types(InstanceCache *cache, int instance) {
+    return instance_solid_types(cache, instance) + instance_solid_count(cache, instance);
+}
+
+// returns the instance of the declaration with the solid types, or adds one with types_count unresolved types
+// *is_new tells the caller to solidify them
+int instance_cache_get(InstanceCache *cache, uint32_t declaration, const TypeId *solid_types, int count,
+                       int types_count, bool *is_new) {
+    cache->lookups_count += 1;
+    uint32_t hash = (2166136261u ^ declaration) * 16777619u; // FNV-1a
+    for (int s = 0; s < count; s++) {
+        hash = (hash ^ solid_types[s]) * 16777619u;
+    }
+
+    unsigned int index = hash & (cache->slots_capacity - 1);
+    while (cache->slots[index] != 0) {
+        int instance = cache->slots[index] - 1;
+        Instance *candidate = &cache->instances[instance];
+        if (candidate->hash == hash && candidate->declaration == declaration && instance_solid_count(cache, instance) == count
+            && memcmp(instance_solid_types(cache, instance), solid_types, count * sizeof(TypeId)) == 0) {
+            cache->hits_count += 1;
+            *is_new = false;
+            return instance;
+        }
+        index = (index + 1) & (cache->slots_capacity - 1);
+    }
+
+    int size = 1 + count + types_count;
+    if (cache->extra_count + size > cache->extra_capacity) {
+        while (cache->extra_count + size > cache->extra_capacity) {
+            cache->extra_capacity *= 2;
+        }
+        cache->extra = (TypeId*) realloc(cache->extra, cache->extra_capacity * sizeof(TypeId));
+    }
+    if (cache->count == cache->capacity) {
+        cache->capacity *= 2;
+        cache->instances = (Instance*) realloc(cache->instances, cache->capacity * sizeof(Instance));
+    }
+    int instance = cache->count++;
+    cache->instances[instance] = { declaration, (uint32_t) cache->extra_count, hash };
+    cache->extra[cache->extra_count] = count;
+    memcpy(cache->extra + cache->extra_count + 1, solid_types, count * sizeof(TypeId));
+    memset(cache->extra + cache->extra_count + 1 + count, 0, types_count * sizeof(TypeId));
+    cache->extra_count += size;
+    cache->slots[index] = instance + 1;
+    if ((unsigned int) cache->count * 2 > cache->slots_capacity) {
+        instance_cache_grow_slots(cache);
+    }
+    *is_new = true;
+    return instance;
+}
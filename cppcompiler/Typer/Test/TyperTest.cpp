@@ -0,0 +1,256 @@
+//
+//  TyperTest.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+// Checks typer_check against the cases, that the programs are typed without errors,
+// that every node is resolved once, however the declarations are ordered,
+// and that every generic is solidified once for every list of solid types.
+//
+// typertest.app [cases.txt]
+
+#include "../../Parser/Test/TestCases.hpp"
+#include "../Typer.cpp"
+
+using namespace std;
+
+const char* const TYPER_TEST_DEFAULT_CASES = "cppcompiler/Typer/Test/TyperTestCases.txt";
+
+// TEST CASES
+
+// the error name, with the cursors of the node's first token when the expected error has them
+std::string format_error(Typer *typer, Ast *ast, bool with_cursors) {
+    if (ast->has_failed) {
+        return parser_error_names[ast->error];
+    }
+    if (!typer->has_failed) {
+        return "";
+    }
+    std::string error = typer_error_names[typer->error];
+    if (!with_cursors) {
+        return error;
+    }
+    uint32_t token = ast->arena.nodes[typer->error_node].token;
+    return format_cursors(ast->output, token_arena_offset(&ast->output->tokens, token),
+                          token_arena_end_offset(&ast->output->tokens, token)) + error;
+}
+
+// every node in the graph is resolved, and only once
+bool is_resolved_once(Typer *typer) {
+    if (typer->resolved_count != typer->nodes_count) {
+        return false;
+    }
+    for (int n = 0; n < typer->nodes_count; n++) {
+        if (typer->arena->nodes[typer->nodes[n]].type == TYPE_ID_UNRESOLVED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the instances are not checked when the case doesn't list them
+bool run_test_case(Lexer *lexer, Parser *parser, TestCase *test_case, std::ostringstream &report, void *context) {
+    auto *typer = (Typer*) context;
+    char *buffer;
+    Output *output = test_case_lex(lexer, test_case, &buffer);
+    Ast *ast = parser_parse(parser, output);
+    if (!ast->has_failed) {
+        typer_check(typer, ast);
+    }
+
+    std::string expected_error = test_case_error(test_case);
+    bool with_cursors = !expected_error.empty() && expected_error[0] == '@';
+    bool is_passing = errors_match(expected_error, format_error(typer, ast, with_cursors), report);
+    if (expected_error.empty()) {
+        is_passing &= lines_match("Expected", test_case_lines(test_case, "types"), split_lines(typer_format(typer, ast)),
+                                  report);
+        if (!is_resolved_once(typer)) {
+            is_passing = false;
+            report << "Resolved " << typer->resolved_count << " of " << typer->nodes_count << " nodes\n";
+        }
+        auto instances = test_case_lines(test_case, "instances");
+        if (!instances.empty()) {
+            is_passing &= lines_match("Expected instances", instances,
+                                      split_lines(typer_format_instances(typer, ast)), report);
+        }
+    }
+
+    ast_free(ast);
+    output_free(output);
+    free(buffer);
+    return is_passing;
+}
+
+// PROGRAMS
+
+bool check_program(Lexer *lexer, Parser *parser, SourceBuffer *source, Ast *ast, const char *path, void *context) {
+    (void) lexer;
+    (void) parser;
+    (void) source;
+    auto *typer = (Typer*) context;
+    if (!typer_check(typer, ast)) {
+        cout << path << ": ";
+        print_typer_error(typer, ast);
+        return false;
+    }
+    if (!is_resolved_once(typer)) {
+        cout << path << ": resolved " << typer->resolved_count << " of " << typer->nodes_count << " nodes" << endl;
+        return false;
+    }
+    return true;
+}
+
+// DEPENDENCIES
+
+const int TYPER_TEST_CHAIN_LENGTH = 100000;
+
+// globals that each read the next one, declared before it, so every global waits for the whole chain
+// and a long binop chain in a procedure that is called before it's declared
+std::string dependency_chain_code(int length) {
+    std::string code = "func main() { x := sum(); }\n";
+    for (int g = 0; g < length; g++) {
+        code += "g" + std::to_string(g) + " := g" + std::to_string(g + 1) + " + 1;\n";
+    }
+    code += "g" + std::to_string(length) + " :: 1.5;\n";
+    code += "func sum() -> Float { return g0";
+    for (int g = 1; g < length; g++) {
+        code += " + g" + std::to_string(g);
+    }
+    code += "; }\n";
+    return code;
+}
+
+// the work is the same for every node, so a chain of twice the length resolves twice the nodes
+int run_dependency_checks() {
+    Lexer *lexer = lexer_create();
+    Parser *parser = parser_create();
+    Typer *typer = typer_create();
+    int failed = 0;
+    int resolved_counts[2];
+    for (int r = 0; r < 2; r++) {
+        std::string code = dependency_chain_code(TYPER_TEST_CHAIN_LENGTH << r);
+        char *buffer = (char*) calloc(code.size() + SOURCE_BUFFER_PADDING, 1);
+        memcpy(buffer, code.data(), code.size());
+        Output *output = lexer_analyze(lexer, buffer, (int) code.size());
+        Ast *ast = parser_parse(parser, output);
+        if (ast->has_failed) {
+            failed += 1;
+            print_parser_error(ast);
+        } else if (!typer_check(typer, ast)) {
+            failed += 1;
+            print_typer_error(typer, ast);
+        } else if (!is_resolved_once(typer) || typer->parked_count != 0) {
+            failed += 1;
+            cout << "Resolved " << typer->resolved_count << " of " << typer->nodes_count << " nodes" << endl;
+        } else {
+            // x is the first declaration, every global is Float
+            std::string types = typer_format(typer, ast);
+            if (types.compare(0, 9, "x: Float\n") != 0 || types.find(": Int") != std::string::npos) {
+                failed += 1;
+                cout << "The chain is typed wrong: " << types.substr(0, 64) << endl;
+            }
+        }
+        resolved_counts[r] = typer->resolved_count;
+        ast_free(ast);
+        output_free(output);
+        free(buffer);
+    }
+    // 4 nodes for every global, 2 for every binop of the sum, and 4 for main, sum and the last global
+    if (failed == 0 && (resolved_counts[0] != 6 * TYPER_TEST_CHAIN_LENGTH + 4 || resolved_counts[1] != 12 * TYPER_TEST_CHAIN_LENGTH + 4)) {
+        failed += 1;
+        cout << "Resolved " << resolved_counts[0] << " and " << resolved_counts[1] << " nodes for twice the chain" << endl;
+    }
+    typer_free(typer);
+    parser_free(parser);
+    lexer_free(lexer);
+
+    if (failed != 0) {
+        cout << failed << " dependency chains were typed wrong!" << endl;
+    } else {
+        cout << "All dependency chains are resolved once per node." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+// INSTANCES
+
+const int TYPER_TEST_MODULES_COUNT = 8;
+const int TYPER_TEST_CALLS_COUNT = 10000;
+
+// every call reads a member of Node<Pair<Int, Int>> and of Pair<Int, Int>, then calls list_append_pair<Int, Int>
+std::string instances_code(int calls_count) {
+    std::string code = "struct Pair<Left, Right> { left: Left; right: Right; }\n"
+                       "struct Node<Value> { next: Node<Value>*; value: Value; }\n"
+                       "func list_append_pair<Left, Right>(head: Node<Pair<Left, Right>>*, left: Left, right: Right) { }\n"
+                       "func main() {\n    head := new Node<Pair<Int, Int>>;\n";
+    for (int c = 0; c < calls_count; c++) {
+        code += "    list_append_pair<Int, Int>(head, " + std::to_string(c) + ", head.value.left);\n";
+    }
+    return code + "}\n";
+}
+
+// the same modules are typed one after another, each solidifies the three generics once,
+// and the types of the later modules are all in the table already
+int run_instance_checks() {
+    std::string code = instances_code(TYPER_TEST_CALLS_COUNT);
+    char *buffer = (char*) calloc(code.size() + SOURCE_BUFFER_PADDING, 1);
+    memcpy(buffer, code.data(), code.size());
+    Lexer *lexer = lexer_create();
+    Parser *parser = parser_create();
+    Typer *typer = typer_create();
+    int failed = 0;
+    int types_count = 0;
+    for (int m = 0; m < TYPER_TEST_MODULES_COUNT && failed == 0; m++) {
+        Output *output = lexer_analyze(lexer, buffer, (int) code.size());
+        Ast *ast = parser_parse(parser, output);
+        if (ast->has_failed || !typer_check(typer, ast)) {
+            failed += 1;
+            print_parser_error(ast);
+            print_typer_error(typer, ast);
+        } else if (typer->instances.count != 3) {
+            failed += 1;
+            cout << "Made " << typer->instances.count << " instances:\n" << typer_format_instances(typer, ast);
+        } else if (m > 0 && typer->types.count != types_count) {
+            failed += 1;
+            cout << "Module " << m << " has added " << typer->types.count - types_count << " types" << endl;
+        }
+        types_count = typer->types.count;
+        ast_free(ast);
+        output_free(output);
+    }
+
+    long lookups_count = typer->instances.lookups_count;
+    long hits_count = typer->instances.hits_count;
+    long expected_lookups = 3L * TYPER_TEST_CALLS_COUNT * TYPER_TEST_MODULES_COUNT;
+    if (failed == 0 && (lookups_count != expected_lookups || hits_count != expected_lookups - 3 * TYPER_TEST_MODULES_COUNT)) {
+        failed += 1;
+        cout << hits_count << " of " << lookups_count << " instance lookups hit, expected "
+             << expected_lookups - 3 * TYPER_TEST_MODULES_COUNT << " of " << expected_lookups << endl;
+    }
+    typer_free(typer);
+    parser_free(parser);
+    lexer_free(lexer);
+    free(buffer);
+
+    if (failed != 0) {
+        cout << "The generics were solidified more than once!" << endl;
+    } else {
+        cout.precision(4);
+        cout << "All generics are solidified once per module (" << hits_count * 100.0 / lookups_count
+             << "% of " << lookups_count << " instance lookups hit)." << endl;
+    }
+    return failed != 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *cases_path = argc > 1 ? argv[1] : TYPER_TEST_DEFAULT_CASES;
+    Typer *typer = typer_create();
+    int result = test_cases_run(cases_path, "typer", run_test_case, typer);
+    result |= test_programs_run("typed", check_program, typer);
+    typer_free(typer);
+    result |= run_dependency_checks();
+    return run_instance_checks() | result;
+}
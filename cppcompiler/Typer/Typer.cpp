@@ -0,0 +1,1016 @@
+//
+//  Typer.cpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#include "../Parser/Ast.hpp"
+#include "Types.hpp"
+#include "Instances.hpp"
+#include "TyperErrors.hpp"
+
+// The second pass of typing.txt: declarations are looked up and types are resolved after the whole file is parsed,
+// so procedures and globals can be used before they're declared.
+//
+// Every expression and statement is a node of a dependency graph, its id is its index in the AstArena.
+// An edge goes from a node to a node that needs its type: from the arguments of a binop to the binop,
+// from a variable to the values that read it. The walk collects the edges, then they are sorted into
+// CSR arrays, the dependants of node n are targets[offsets[n]] up to targets[offsets[n + 1]].
+//
+// The worklist starts with the nodes that depend on nothing. A node is resolved when the last of its inputs is,
+// then its dependants are told, so every node is resolved once and the pass is linear in the size of the tree.
+// Nodes that are never resolved depend on themselves, which is a typeCycle.
+//
+// Types of declarations are written down, so they're converted while walking. The only type that can't be known
+// before the worklist is the type of a struct member declared with := and read with a member access:
+// the member access waits for the member then, see typer_resolve_member_access.
+//
+// Calls and member accesses with solid types use the instances of the generic declarations, see Instances.hpp,
+// so the types of every procedure and struct are solidified once for every list of solid types.
+
+struct TyperBinding {
+    Symbol symbol;
+    NodeIndex declaration;
+    uint32_t previous; // the binding the symbol had in the outer scope, 0 for none
+};
+typedef struct TyperBinding TyperBinding;
+
+struct Typer {
+    TypeTable types; // kept for every file, the nodes refer to it
+    InstanceCache instances; // of the last file
+    Ast *ast;
+    AstArena *arena;
+    Interner *interner;
+    Symbol named_symbols[NAMED_TYPES_COUNT]; // of named_types
+
+    // declarations by symbol, the arrays grow with the interner
+    NodeIndex *globals;
+    uint32_t *locals; // the binding of the symbol, 0 when it's not declared in a scope around the node
+    unsigned int symbols_capacity;
+
+    // locals in scope, the innermost last, binding 0 is never used
+    TyperBinding *bindings;
+    int bindings_count;
+    int bindings_capacity;
+
+    ListIndex generics; // symbols of the procedure or struct being walked
+    NodeIndex procedure; // being walked, for its returns
+
+    // the expressions left to walk
+    NodeIndex *stack;
+    int stack_count;
+    int stack_capacity;
+
+    // the dependency graph, edges are pairs of a dependency and its dependant
+    uint32_t *edges;
+    int edges_count;
+    int edges_capacity;
+    uint32_t *targets; // dependants, sorted by dependency
+    int targets_capacity;
+
+    // per node of the arena
+    uint32_t *offsets; // CSR, one more than the nodes
+    uint32_t *pending; // inputs that are not resolved yet
+    uint32_t *parked; // the first member access waiting for the member, 0 for none
+    uint32_t *next_parked; // the next member access waiting for the same member
+    int nodes_capacity;
+
+    uint32_t *nodes; // in the graph, in the order they're walked
+    int nodes_count;
+    uint32_t *worklist; // twice the nodes, a parked member access is queued twice
+    int worklist_count;
+
+    // of the last file
+    int resolved_count;
+    int parked_count;
+
+    // the first error stops the typer, like the Swift parser
+    bool has_failed;
+    TyperError error;
+    NodeIndex error_node;
+};
+typedef struct Typer Typer;
+
+inline AstNode* typer_node(Typer *typer, NodeIndex index) {
+    return &typer->arena->nodes[index];
+}
+
+void typer_fail(Typer *typer, TyperError error, NodeIndex node) {
+    if (typer->has_failed) {
+        return;
+    }
+    typer->has_failed = true;
+    typer->error = error;
+    typer->error_node = node;
+}
+
+// GRAPH
+
+void typer_add_node(Typer *typer, NodeIndex index) {
+    typer->nodes[typer->nodes_count++] = index;
+}
+
+// the dependant is resolved after the dependency
+void typer_depend(Typer *typer, NodeIndex dependant, NodeIndex dependency) {
+    if (dependency == 0) {
+        return;
+    }
+    if (typer->edges_count + 2 > typer->edges_capacity) {
+        typer->edges_capacity *= 2;
+        typer->edges = (uint32_t*) realloc(typer->edges, typer->edges_capacity * sizeof(uint32_t));
+    }
+    typer->edges[typer->edges_count++] = dependency;
+    typer->edges[typer->edges_count++] = dependant;
+    typer->pending[dependant] += 1;
+}
+
+// counts the dependants of every node, then puts every dependant before the ones already placed for its node,
+// so offsets[n] ends at the first dependant of n
+void typer_build_graph(Typer *typer) {
+    int nodes_count = typer->arena->count;
+    int edges_count = typer->edges_count / 2;
+    if (edges_count > typer->targets_capacity) {
+        typer->targets_capacity = edges_count;
+        typer->targets = (uint32_t*) realloc(typer->targets, typer->targets_capacity * sizeof(uint32_t));
+    }
+
+    uint32_t *offsets = typer->offsets;
+    memset(offsets, 0, (nodes_count + 1) * sizeof(uint32_t));
+    for (int e = 0; e < edges_count; e++) {
+        offsets[typer->edges[e * 2]] += 1;
+    }
+    for (int n = 1; n <= nodes_count; n++) {
+        offsets[n] += offsets[n - 1];
+    }
+    for (int e = 0; e < edges_count; e++) {
+        typer->targets[--offsets[typer->edges[e * 2]]] = typer->edges[e * 2 + 1];
+    }
+}
+
+// SCOPES
+
+NodeIndex typer_lookup(Typer *typer, Symbol symbol) {
+    uint32_t binding = typer->locals[symbol];
+    return binding != 0 ? typer->bindings[binding].declaration : typer->globals[symbol];
+}
+
+// a declaration conflicts with the ones of the same scope, the scope starts at its first binding
+void typer_bind(Typer *typer, NodeIndex declaration, int scope) {
+    Symbol symbol = typer_node(typer, declaration)->a;
+    uint32_t previous = typer->locals[symbol];
+    if (previous != 0 && (int) previous >= scope) {
+        typer_fail(typer, TYPER_ERROR_DECLARATION_CONFLICT, declaration);
+        return;
+    }
+    if (typer->bindings_count == typer->bindings_capacity) {
+        typer->bindings_capacity *= 2;
+        typer->bindings = (TyperBinding*) realloc(typer->bindings, typer->bindings_capacity * sizeof(TyperBinding));
+    }
+    typer->bindings[typer->bindings_count] = { symbol, declaration, previous };
+    typer->locals[symbol] = typer->bindings_count++;
+}
+
+// leaves the scope, the symbols get their bindings of the outer scopes back
+void typer_unbind(Typer *typer, int scope) {
+    while (typer->bindings_count > scope) {
+        TyperBinding *binding = &typer->bindings[--typer->bindings_count];
+        typer->locals[binding->symbol] = binding->previous;
+    }
+}
+
+// TYPES
+
+// typeNamed() of the name in the TYPE node, the generic types of the declaration become aliases
+// the type is kept in the node, so it's converted once
+TypeId typer_type(Typer *typer, NodeIndex index) {
+    if (index == 0) {
+        return TYPE_ID_VOID;
+    }
+    AstNode *node = typer_node(typer, index);
+    if (node->type != TYPE_ID_UNRESOLVED) {
+        return node->type;
+    }
+
+    Symbol symbol = node->a;
+    TypeId type = TYPE_ID_UNRESOLVED;
+    for (int n = 0; n < NAMED_TYPES_COUNT && type == TYPE_ID_UNRESOLVED; n++) {
+        if (typer->named_symbols[n] == symbol) {
+            type = named_types[n].type;
+        }
+    }
+    for (int g = 0; g < ast_list_count(typer->arena, typer->generics) && type == TYPE_ID_UNRESOLVED; g++) {
+        if (ast_list_items(typer->arena, typer->generics)[g] == symbol) {
+            type = type_make_alias(&typer->types, symbol);
+        }
+    }
+    if (type == TYPE_ID_UNRESOLVED) {
+        int count = ast_list_count(typer->arena, node->b);
+        NodeIndex declaration = typer->globals[symbol];
+        if (declaration != 0 && typer_node(typer, declaration)->kind == NODE_STRUCT
+            && ast_list_count(typer->arena, typer_node(typer, declaration)->b) != count) {
+            typer_fail(typer, TYPER_ERROR_STRUCT_SHOULD_BE_GENERIC, index);
+        }
+        TypeId *solid_types = (TypeId*) malloc((count + 1) * sizeof(TypeId));
+        for (int s = 0; s < count; s++) {
+            solid_types[s] = typer_type(typer, ast_list_items(typer->arena, node->b)[s]);
+        }
+        type = type_make_struct(&typer->types, symbol, solid_types, count);
+        free(solid_types);
+    }
+
+    for (uint32_t p = 0; p < node->c; p++) {
+        type = type_make_pointer(&typer->types, type);
+    }
+    // the outermost length is the first, so the innermost array is made first
+    for (int d = ast_list_count(typer->arena, node->d) - 1; d >= 0; d--) {
+        AstNode *length = typer_node(typer, ast_list_items(typer->arena, node->d)[d]);
+        bool is_static = length->kind == NODE_INT_LITERAL && !(length->flags & NODE_FLAG_BOOL);
+        type = type_make_array(&typer->types, type, is_static ? length->int_value : 0);
+    }
+    node->type = type;
+    return type;
+}
+
+// the type with the generic types of the declaration replaced by the solid types
+// the solid types can't be a list of the table, it grows
+TypeId typer_substitute(Typer *typer, TypeId type, ListIndex generics, const TypeId *solid_types) {
+    TypeInfo info = *type_at(&typer->types, type);
+    switch (info.kind) {
+        case TYPE_ALIAS:
+            for (int g = 0; g < ast_list_count(typer->arena, generics); g++) {
+                if (ast_list_items(typer->arena, generics)[g] == info.symbol) {
+                    return solid_types[g];
+                }
+            }
+            return type;
+        case TYPE_POINTER: case TYPE_ARRAY: {
+            TypeId element = typer_substitute(typer, info.element, generics, solid_types);
+            if (element == info.element) {
+                return type;
+            }
+            return info.kind == TYPE_POINTER ? type_make_pointer(&typer->types, element)
+                                             : type_make_array(&typer->types, element, info.length);
+        }
+        case TYPE_STRUCT: {
+            int count = type_solid_count(&typer->types, type);
+            if (count == 0) {
+                return type;
+            }
+            TypeId *substituted = (TypeId*) malloc(count * sizeof(TypeId));
+            memcpy(substituted, type_solid_types(&typer->types, type), count * sizeof(TypeId));
+            bool is_changed = false;
+            for (int s = 0; s < count; s++) {
+                TypeId solid = typer_substitute(typer, substituted[s], generics, solid_types);
+                is_changed |= solid != substituted[s];
+                substituted[s] = solid;
+            }
+            if (is_changed) {
+                type = type_make_struct(&typer->types, info.symbol, substituted, count);
+            }
+            free(substituted);
+            return type;
+        }
+        default:
+            return type;
+    }
+}
+
+// WALK
+
+void typer_push(Typer *typer, NodeIndex index) {
+    if (typer->stack_count == typer->stack_capacity) {
+        typer->stack_capacity *= 2;
+        typer->stack = (NodeIndex*) realloc(typer->stack, typer->stack_capacity * sizeof(NodeIndex));
+    }
+    typer->stack[typer->stack_count++] = index;
+}
+
+void typer_walk_type(Typer *typer, NodeIndex index);
+
+// an explicit stack instead of recursion, long chains of binops are as deep as they are long
+void typer_walk_expression(Typer *typer, NodeIndex root) {
+    if (root == 0) {
+        return;
+    }
+    int bottom = typer->stack_count;
+    typer_push(typer, root);
+    while (typer->stack_count > bottom && !typer->has_failed) {
+        NodeIndex index = typer->stack[--typer->stack_count];
+        AstNode *node = typer_node(typer, index);
+        typer_add_node(typer, index);
+
+        switch (node->kind) {
+            case NODE_VALUE: {
+                // the declaration is kept in the node, the scope is gone when it's resolved
+                NodeIndex declaration = typer_lookup(typer, node->a);
+                if (declaration == 0) {
+                    typer_fail(typer, TYPER_ERROR_ASSIGN_UNDECLARED, index);
+                } else if (typer_node(typer, declaration)->kind != NODE_VARIABLE) {
+                    typer_fail(typer, TYPER_ERROR_ASSIGN_PASSED_NOT_VALUE, index);
+                } else {
+                    node->b = declaration;
+                    typer_depend(typer, index, declaration);
+                }
+                break;
+            }
+            case NODE_SIZEOF: case NODE_NEW:
+                typer_walk_type(typer, node->a);
+                break;
+            case NODE_UNARY:
+                typer_walk_type(typer, node->b);
+                typer_depend(typer, index, node->a);
+                typer_push(typer, node->a);
+                break;
+            case NODE_BINARY: case NODE_SUBSCRIPT:
+                typer_depend(typer, index, node->a);
+                typer_depend(typer, index, node->b);
+                typer_push(typer, node->b);
+                typer_push(typer, node->a);
+                break;
+            case NODE_MEMBER_ACCESS:
+                typer_depend(typer, index, node->a);
+                typer_push(typer, node->a);
+                break;
+            case NODE_CALL: {
+                NodeIndex procedure = typer->globals[node->a];
+                if (procedure == 0 || typer_node(typer, procedure)->kind != NODE_PROCEDURE) {
+                    typer_fail(typer, TYPER_ERROR_CALL_NOT_PROCEDURE, index);
+                    break;
+                }
+                node->d = procedure;
+                for (int s = 0; s < ast_list_count(typer->arena, node->b); s++) {
+                    typer_walk_type(typer, ast_list_items(typer->arena, node->b)[s]);
+                }
+                int count = ast_list_count(typer->arena, node->c);
+                for (int g = count - 1; g >= 0; g--) {
+                    NodeIndex argument = ast_list_items(typer->arena, node->c)[g];
+                    typer_depend(typer, index, argument);
+                    typer_push(typer, argument);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    typer->stack_count = bottom;
+}
+
+// the lengths of arrays are expressions, but the type doesn't depend on them
+void typer_walk_type(Typer *typer, NodeIndex index) {
+    if (index == 0) {
+        return;
+    }
+    typer_type(typer, index);
+    ListIndex lengths = typer_node(typer, index)->d;
+    for (int d = 0; d < ast_list_count(typer->arena, lengths); d++) {
+        typer_walk_expression(typer, ast_list_items(typer->arena, lengths)[d]);
+    }
+}
+
+void typer_walk_variable(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    typer_add_node(typer, index);
+    typer_walk_type(typer, node->b);
+    typer_depend(typer, index, node->c);
+    typer_walk_expression(typer, node->c);
+}
+
+void typer_walk_block(Typer *typer, NodeIndex code);
+
+void typer_walk_statement(Typer *typer, NodeIndex index, int scope) {
+    AstNode *node = typer_node(typer, index);
+    switch (node->kind) {
+        case NODE_VARIABLE:
+            // bound after the expression, x := x; reads the x of the outer scope
+            typer_walk_variable(typer, index);
+            typer_bind(typer, index, scope);
+            break;
+        case NODE_ASSIGNMENT:
+            typer_add_node(typer, index);
+            typer_depend(typer, index, node->a);
+            typer_depend(typer, index, node->b);
+            typer_walk_expression(typer, node->a);
+            typer_walk_expression(typer, node->b);
+            break;
+        case NODE_CALL:
+            typer_walk_expression(typer, index);
+            break;
+        case NODE_IF:
+            typer_add_node(typer, index);
+            typer_depend(typer, index, node->a);
+            typer_walk_expression(typer, node->a);
+            typer_walk_block(typer, node->b);
+            if (node->c != 0) {
+                typer_walk_block(typer, node->c);
+            }
+            break;
+        case NODE_WHILE:
+            typer_add_node(typer, index);
+            typer_depend(typer, index, node->b);
+            typer_walk_expression(typer, node->b);
+            typer_walk_block(typer, node->c);
+            break;
+        case NODE_RETURN:
+            typer_add_node(typer, index);
+            node->b = typer->procedure;
+            typer_depend(typer, index, node->a);
+            typer_walk_expression(typer, node->a);
+            break;
+        case NODE_FREE:
+            typer_add_node(typer, index);
+            typer_depend(typer, index, node->a);
+            typer_walk_expression(typer, node->a);
+            break;
+        default:
+            break;
+    }
+}
+
+void typer_walk_block(Typer *typer, NodeIndex code) {
+    int scope = typer->bindings_count;
+    ListIndex statements = typer_node(typer, code)->a;
+    for (int s = 0; s < ast_list_count(typer->arena, statements) && !typer->has_failed; s++) {
+        typer_walk_statement(typer, ast_list_items(typer->arena, statements)[s], scope);
+    }
+    typer_unbind(typer, scope);
+}
+
+// the arguments and the members are in the scope of the declaration, the body is a scope inside of it
+void typer_walk_declaration(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    if (node->kind == NODE_VARIABLE) {
+        typer_walk_variable(typer, index);
+        return;
+    }
+
+    int scope = typer->bindings_count;
+    typer->generics = node->b;
+    typer->procedure = node->kind == NODE_PROCEDURE ? index : 0;
+    for (int m = 0; m < ast_list_count(typer->arena, node->c) && !typer->has_failed; m++) {
+        NodeIndex member = ast_list_items(typer->arena, node->c)[m];
+        typer_walk_variable(typer, member);
+        typer_bind(typer, member, scope);
+    }
+    if (node->kind == NODE_PROCEDURE) {
+        typer_walk_type(typer, node->d);
+        if (node->e != 0 && !typer->has_failed) {
+            typer_walk_block(typer, node->e);
+        }
+    }
+    typer_unbind(typer, scope);
+    typer->generics = 0;
+    typer->procedure = 0;
+}
+
+// CONVERSION
+
+inline bool typer_is_math(Typer *typer, TypeId type) {
+    uint8_t kind = type_at(&typer->types, type)->kind;
+    return type_is_number(&typer->types, type) || kind == TYPE_ALIAS || kind == TYPE_ANY;
+}
+
+// comparisons and logical operators give a Bool, the others the type of their arguments
+bool operator_is_arithmetic(Operator op) {
+    switch (op) {
+        case OPERATOR_ASTERISK: case OPERATOR_SLASH: case OPERATOR_PERCENT: case OPERATOR_PLUS: case OPERATOR_MINUS:
+        case OPERATOR_SHIFT_LEFT: case OPERATOR_SHIFT_RIGHT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// convertExpression of ParserTools.swift: the literals of the expression take the type, if they all can
+// nothing is changed unless the whole expression is convertible
+bool typer_try_convert(Typer *typer, NodeIndex root, TypeId to, bool should_apply) {
+    TypeInfo target = *type_at(&typer->types, to);
+    int bottom = typer->stack_count;
+    typer_push(typer, root);
+    bool is_convertible = true;
+    while (typer->stack_count > bottom && is_convertible) {
+        NodeIndex index = typer->stack[--typer->stack_count];
+        AstNode *node = typer_node(typer, index);
+        if (type_equal(&typer->types, node->type, to)) {
+            continue;
+        }
+        switch (node->kind) {
+            case NODE_INT_LITERAL:
+                is_convertible = !(node->flags & NODE_FLAG_BOOL) && (target.kind == TYPE_INT || target.kind == TYPE_FLOAT);
+                if (is_convertible && should_apply && target.kind == TYPE_FLOAT) {
+                    node->kind = NODE_FLOAT_LITERAL;
+                    node->float_value = (double) node->int_value;
+                }
+                break;
+            case NODE_FLOAT_LITERAL:
+                is_convertible = target.kind == TYPE_FLOAT;
+                break;
+            case NODE_NULL_LITERAL:
+                is_convertible = target.kind == TYPE_POINTER;
+                break;
+            case NODE_SIZEOF:
+                is_convertible = target.kind == TYPE_INT && target.bits >= 16;
+                break;
+            case NODE_BINARY:
+                is_convertible = operator_is_arithmetic((Operator) node->operation);
+                typer_push(typer, node->a);
+                typer_push(typer, node->b);
+                break;
+            case NODE_UNARY:
+                is_convertible = node->operation == OPERATOR_MINUS && !(node->flags & NODE_FLAG_CAST);
+                typer_push(typer, node->a);
+                break;
+            default:
+                is_convertible = false;
+        }
+        if (is_convertible && should_apply) {
+            node->type = to;
+        }
+    }
+    typer->stack_count = bottom;
+    return is_convertible;
+}
+
+bool typer_convert(Typer *typer, NodeIndex index, TypeId to) {
+    if (type_equal(&typer->types, typer_node(typer, index)->type, to)) {
+        return true;
+    }
+    if (!typer_try_convert(typer, index, to, false)) {
+        return false;
+    }
+    typer_try_convert(typer, index, to, true);
+    return true;
+}
+
+// RESOLUTION
+
+TypeId typer_resolve_unary(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    if (node->flags & NODE_FLAG_CAST) {
+        return typer_type(typer, node->b);
+    }
+    TypeId argument = typer_node(typer, node->a)->type;
+    TypeInfo info = *type_at(&typer->types, argument);
+    switch (node->operation) {
+        case OPERATOR_MINUS:
+            if (!typer_is_math(typer, argument)) {
+                typer_fail(typer, TYPER_ERROR_BINOP_ARG_TYPE_SUPPORT, index);
+            }
+            return argument;
+        case OPERATOR_ASTERISK:
+            if (info.kind == TYPE_ALIAS || info.kind == TYPE_ANY) {
+                return argument;
+            } else if (info.kind != TYPE_POINTER) {
+                typer_fail(typer, TYPER_ERROR_VALUE_NOT_POINTER, index);
+            }
+            return info.element;
+        default:
+            return type_make_pointer(&typer->types, argument);
+    }
+}
+
+// the right argument is converted to the left one, or the other way around, then they have to be equal
+TypeId typer_resolve_binary(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    TypeId left = typer_node(typer, node->a)->type;
+    TypeId right = typer_node(typer, node->b)->type;
+    if (!type_equal(&typer->types, left, right)) {
+        if (typer_convert(typer, node->b, left)) {
+            right = left;
+        } else if (typer_convert(typer, node->a, right)) {
+            left = right;
+        } else {
+            typer_fail(typer, TYPER_ERROR_BINOP_ARG_TYPE_MATCH, index);
+            return left;
+        }
+    }
+
+    Operator op = (Operator) node->operation;
+    bool is_accepting;
+    switch (op) {
+        case OPERATOR_EQUAL_EQUAL: case OPERATOR_NOT_EQUAL:
+            is_accepting = true;
+            break;
+        case OPERATOR_AMPERSAND: case OPERATOR_AND: case OPERATOR_OR:
+            is_accepting = type_equal(&typer->types, left, TYPE_ID_BOOL);
+            break;
+        default:
+            is_accepting = typer_is_math(typer, left);
+    }
+    if (!is_accepting) {
+        typer_fail(typer, TYPER_ERROR_BINOP_ARG_TYPE_SUPPORT, index);
+    }
+    return operator_is_arithmetic(op) ? left : TYPE_ID_BOOL;
+}
+
+// the types of the arguments and the return type are the ones of the procedure, with the solid types of the call
+TypeId typer_resolve_call(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    AstNode *procedure = typer_node(typer, node->d);
+    int solid_count = ast_list_count(typer->arena, node->b);
+    if (solid_count != ast_list_count(typer->arena, procedure->b)) {
+        typer_fail(typer, TYPER_ERROR_PROC_SHOULD_BE_GENERIC, index);
+        return TYPE_ID_VOID;
+    }
+    int parameters_count = ast_list_count(typer->arena, procedure->c);
+    int arguments_count = ast_list_count(typer->arena, node->c);
+    if ((procedure->flags & NODE_FLAG_VARARGS) && arguments_count < parameters_count) {
+        typer_fail(typer, TYPER_ERROR_CALL_ARGUMENTS_VAR_COUNT, index);
+        return TYPE_ID_VOID;
+    } else if (!(procedure->flags & NODE_FLAG_VARARGS) && arguments_count != parameters_count) {
+        typer_fail(typer, TYPER_ERROR_CALL_ARGUMENTS_COUNT, index);
+        return TYPE_ID_VOID;
+    }
+
+    TypeId *solid_types = (TypeId*) malloc((solid_count + 1) * sizeof(TypeId));
+    bool is_generic = false;
+    for (int s = 0; s < solid_count; s++) {
+        solid_types[s] = typer_node(typer, ast_list_items(typer->arena, node->b)[s])->type;
+        is_generic |= type_at(&typer->types, solid_types[s])->is_generic;
+    }
+
+    // the types of the arguments, then the return type
+    // the instance is not kept when the solid types are generic types of the procedure around the call,
+    // Parser.swift doesn't solidify those calls either
+    TypeId *signature = (TypeId*) malloc((parameters_count + 1) * sizeof(TypeId));
+    bool is_new = true;
+    int instance = -1;
+    if (solid_count > 0 && !is_generic) {
+        instance = instance_cache_get(&typer->instances, node->d, solid_types, solid_count, parameters_count + 1, &is_new);
+        node->e = instance + 1;
+    }
+    if (is_new) {
+        for (int p = 0; p < parameters_count; p++) {
+            NodeIndex parameter = ast_list_items(typer->arena, procedure->c)[p];
+            signature[p] = typer_substitute(typer, typer_type(typer, typer_node(typer, parameter)->b), procedure->b, solid_types);
+        }
+        signature[parameters_count] = typer_substitute(typer, typer_type(typer, procedure->d), procedure->b, solid_types);
+        if (instance >= 0) {
+            memcpy(instance_types(&typer->instances, instance), signature, (parameters_count + 1) * sizeof(TypeId));
+        }
+    } else {
+        memcpy(signature, instance_types(&typer->instances, instance), (parameters_count + 1) * sizeof(TypeId));
+    }
+
+    // the variadic arguments are not checked
+    for (int p = 0; p < parameters_count && !typer->has_failed; p++) {
+        NodeIndex argument = ast_list_items(typer->arena, node->c)[p];
+        if (!typer_convert(typer, argument, signature[p])) {
+            typer_fail(typer, TYPER_ERROR_CALL_ARGUMENT_TYPE_MISMATCH, argument);
+        }
+    }
+    TypeId type = signature[parameters_count];
+    free(signature);
+    free(solid_types);
+    return type;
+}
+
+// the member of the struct the base points to, with the solid types of the base
+// returns UNRESOLVED when the member's type is not resolved yet, the node is parked on the member then
+TypeId typer_resolve_member_access(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    TypeId base = type_value_type(&typer->types, typer_node(typer, node->a)->type);
+    TypeInfo info = *type_at(&typer->types, base);
+    NodeIndex declaration = info.kind == TYPE_STRUCT ? typer->globals[info.symbol] : 0;
+    if (declaration == 0 || typer_node(typer, declaration)->kind != NODE_STRUCT) {
+        typer_fail(typer, TYPER_ERROR_MEMBER_ACCESS_NON_STRUCT, index);
+        return TYPE_ID_VOID;
+    }
+
+    AstNode *structure = typer_node(typer, declaration);
+    int members_count = ast_list_count(typer->arena, structure->c);
+    NodeIndex member = 0;
+    int position = 0;
+    for (; position < members_count; position++) {
+        NodeIndex candidate = ast_list_items(typer->arena, structure->c)[position];
+        if (typer_node(typer, candidate)->a == node->b) {
+            member = candidate;
+            break;
+        }
+    }
+    if (member == 0) {
+        typer_fail(typer, TYPER_ERROR_MEMBER_ACCESS_UNDECLARED_MEMBER, index);
+        return TYPE_ID_VOID;
+    }
+
+    AstNode *variable = typer_node(typer, member);
+    TypeId type = variable->b != 0 ? typer_type(typer, variable->b) : variable->type;
+    if (type == TYPE_ID_UNRESOLVED) {
+        typer->next_parked[index] = typer->parked[member];
+        typer->parked[member] = index;
+        return TYPE_ID_UNRESOLVED;
+    }
+    int count = type_solid_count(&typer->types, base);
+    if (count == 0) {
+        return type;
+    }
+
+    // the members of an instance are solidified when they're first read
+    TypeId *solid_types = (TypeId*) malloc(count * sizeof(TypeId));
+    memcpy(solid_types, type_solid_types(&typer->types, base), count * sizeof(TypeId));
+    if (info.is_generic) {
+        type = typer_substitute(typer, type, structure->b, solid_types);
+    } else {
+        bool is_new;
+        int instance = instance_cache_get(&typer->instances, declaration, solid_types, count, members_count, &is_new);
+        TypeId *members = instance_types(&typer->instances, instance);
+        if (members[position] == TYPE_ID_UNRESOLVED) {
+            members[position] = typer_substitute(typer, type, structure->b, solid_types);
+        }
+        type = members[position];
+    }
+    free(solid_types);
+    return type;
+}
+
+// the type of the node from the types of its inputs, which are all resolved
+// returns false when the node is parked
+bool typer_resolve(Typer *typer, NodeIndex index) {
+    AstNode *node = typer_node(typer, index);
+    TypeId type = TYPE_ID_VOID;
+    switch (node->kind) {
+        case NODE_INT_LITERAL:
+            if (node->flags & NODE_FLAG_BOOL) {
+                type = TYPE_ID_BOOL;
+            } else {
+                type = node->int_value == (int32_t) node->int_value ? TYPE_ID_INT : TYPE_ID_INT64;
+            }
+            break;
+        case NODE_FLOAT_LITERAL: type = TYPE_ID_FLOAT; break;
+        case NODE_STRING_LITERAL: type = TYPE_ID_STRING; break;
+        case NODE_NULL_LITERAL: type = TYPE_ID_NULL; break;
+        case NODE_SIZEOF: type = TYPE_ID_INT; break;
+        case NODE_NEW: type = type_make_pointer(&typer->types, typer_type(typer, node->a)); break;
+        case NODE_VALUE: type = typer_node(typer, node->b)->type; break;
+        case NODE_UNARY: type = typer_resolve_unary(typer, index); break;
+        case NODE_BINARY: type = typer_resolve_binary(typer, index); break;
+        case NODE_CALL: type = typer_resolve_call(typer, index); break;
+        case NODE_MEMBER_ACCESS:
+            type = typer_resolve_member_access(typer, index);
+            if (type == TYPE_ID_UNRESOLVED && !typer->has_failed) {
+                return false;
+            }
+            break;
+        case NODE_SUBSCRIPT: {
+            TypeId base = typer_node(typer, node->a)->type;
+            TypeInfo info = *type_at(&typer->types, base);
+            if (!type_is_int(&typer->types, typer_node(typer, node->b)->type)) {
+                typer_fail(typer, TYPER_ERROR_SUBSCRIPT_EXPECTED_INDEX_EXPRESSION, node->b);
+            } else if (info.kind != TYPE_ARRAY && info.kind != TYPE_POINTER) {
+                typer_fail(typer, TYPER_ERROR_SUBSCRIPT_NOT_ARRAY, index);
+            }
+            type = info.element;
+            break;
+        }
+        case NODE_VARIABLE:
+            if (node->b == 0) {
+                type = typer_node(typer, node->c)->type;
+                break;
+            }
+            type = typer_type(typer, node->b);
+            if (node->c != 0 && !typer_convert(typer, node->c, type)) {
+                typer_fail(typer, TYPER_ERROR_VAR_DECL_TYPE_MISMATCH, node->c);
+            }
+            break;
+        case NODE_ASSIGNMENT: {
+            AstNode *receiver = typer_node(typer, node->a);
+            if (receiver->kind == NODE_VALUE && (typer_node(typer, receiver->b)->flags & NODE_FLAG_CONSTANT)) {
+                typer_fail(typer, TYPER_ERROR_ASSIGN_CONST, node->a);
+            } else if (!typer_convert(typer, node->b, receiver->type)) {
+                typer_fail(typer, TYPER_ERROR_ASSIGN_TYPE_MISMATCH, node->b);
+            }
+            break;
+        }
+        case NODE_IF: case NODE_WHILE: {
+            NodeIndex condition = node->kind == NODE_IF ? node->a : node->b;
+            if (!typer_convert(typer, condition, TYPE_ID_BOOL)) {
+                typer_fail(typer, TYPER_ERROR_CONDITION_TYPE_MISMATCH, condition);
+            }
+            break;
+        }
+        case NODE_RETURN: {
+            TypeId expected = typer_type(typer, typer_node(typer, node->b)->d);
+            if (node->a == 0 ? !type_equal(&typer->types, expected, TYPE_ID_VOID) : !typer_convert(typer, node->a, expected)) {
+                typer_fail(typer, TYPER_ERROR_RETURN_TYPE_NOT_MATCHING, node->a != 0 ? node->a : index);
+            }
+            break;
+        }
+        case NODE_FREE: {
+            uint8_t kind = type_at(&typer->types, typer_node(typer, node->a)->type)->kind;
+            if (kind != TYPE_POINTER && kind != TYPE_ALIAS && kind != TYPE_ANY) {
+                typer_fail(typer, TYPER_ERROR_FREE_EXPECTS_POINTER, node->a);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    node->type = type;
+    return true;
+}
+
+// WORKLIST
+
+void typer_queue(Typer *typer, NodeIndex index) {
+    typer->worklist[typer->worklist_count++] = index;
+}
+
+void typer_run_worklist(Typer *typer) {
+    for (int n = 0; n < typer->nodes_count; n++) {
+        if (typer->pending[typer->nodes[n]] == 0) {
+            typer_queue(typer, typer->nodes[n]);
+        }
+    }
+
+    for (int w = 0; w < typer->worklist_count && !typer->has_failed; w++) {
+        NodeIndex index = typer->worklist[w];
+        if (!typer_resolve(typer, index)) {
+            typer->parked_count += 1;
+            continue;
+        }
+        typer->resolved_count += 1;
+        for (uint32_t t = typer->offsets[index]; t < typer->offsets[index + 1]; t++) {
+            NodeIndex dependant = typer->targets[t];
+            if (--typer->pending[dependant] == 0) {
+                typer_queue(typer, dependant);
+            }
+        }
+        for (NodeIndex parked = typer->parked[index]; parked != 0; parked = typer->next_parked[parked]) {
+            typer_queue(typer, parked);
+        }
+    }
+
+    // what is left waits for itself, the error is at the first declaration of the cycle
+    if (!typer->has_failed && typer->resolved_count < typer->nodes_count) {
+        NodeIndex first = 0;
+        for (int n = 0; n < typer->nodes_count; n++) {
+            NodeIndex index = typer->nodes[n];
+            if (typer_node(typer, index)->type != TYPE_ID_UNRESOLVED) {
+                continue;
+            }
+            if (first == 0 || (typer_node(typer, first)->kind != NODE_VARIABLE && typer_node(typer, index)->kind == NODE_VARIABLE)) {
+                first = index;
+            }
+        }
+        typer_fail(typer, TYPER_ERROR_TYPE_CYCLE, first);
+    }
+}
+
+// TYPER
+
+Typer* typer_create() {
+    Typer *typer = new Typer();
+    memset(typer, 0, sizeof(*typer));
+    type_table_init(&typer->types);
+    instance_cache_init(&typer->instances);
+    typer->bindings_capacity = 256;
+    typer->bindings = (TyperBinding*) malloc(typer->bindings_capacity * sizeof(TyperBinding));
+    typer->stack_capacity = 256;
+    typer->stack = (NodeIndex*) malloc(typer->stack_capacity * sizeof(NodeIndex));
+    typer->edges_capacity = 1024;
+    typer->edges = (uint32_t*) malloc(typer->edges_capacity * sizeof(uint32_t));
+    return typer;
+}
+
+void typer_free(Typer *typer) {
+    type_table_free(&typer->types);
+    instance_cache_free(&typer->instances);
+    free(typer->globals);
+    free(typer->locals);
+    free(typer->bindings);
+    free(typer->stack);
+    free(typer->edges);
+    free(typer->targets);
+    free(typer->offsets);
+    free(typer->pending);
+    free(typer->parked);
+    free(typer->next_parked);
+    free(typer->nodes);
+    free(typer->worklist);
+    delete typer;
+}
+
+// the arrays of the previous file are kept, they only grow
+void typer_reserve(Typer *typer, Ast *ast) {
+    unsigned int symbols_count = ast->output->interner->strings_count;
+    if (symbols_count > typer->symbols_capacity) {
+        typer->globals = (NodeIndex*) realloc(typer->globals, symbols_count * sizeof(NodeIndex));
+        typer->locals = (uint32_t*) realloc(typer->locals, symbols_count * sizeof(uint32_t));
+        memset(typer->globals + typer->symbols_capacity, 0, (symbols_count - typer->symbols_capacity) * sizeof(NodeIndex));
+        memset(typer->locals + typer->symbols_capacity, 0, (symbols_count - typer->symbols_capacity) * sizeof(uint32_t));
+        typer->symbols_capacity = symbols_count;
+    }
+
+    int nodes_count = ast->arena.count;
+    if (nodes_count > typer->nodes_capacity) {
+        typer->nodes_capacity = nodes_count;
+        typer->offsets = (uint32_t*) realloc(typer->offsets, (nodes_count + 1) * sizeof(uint32_t));
+        typer->pending = (uint32_t*) realloc(typer->pending, nodes_count * sizeof(uint32_t));
+        typer->parked = (uint32_t*) realloc(typer->parked, nodes_count * sizeof(uint32_t));
+        typer->next_parked = (uint32_t*) realloc(typer->next_parked, nodes_count * sizeof(uint32_t));
+        typer->nodes = (uint32_t*) realloc(typer->nodes, nodes_count * sizeof(uint32_t));
+        typer->worklist = (uint32_t*) realloc(typer->worklist, nodes_count * 2 * sizeof(uint32_t));
+    }
+    memset(typer->pending, 0, nodes_count * sizeof(uint32_t));
+    memset(typer->parked, 0, nodes_count * sizeof(uint32_t));
+}
+
+// resolves the types of the expressions and declarations of a file that was parsed without errors
+// the types are kept in the nodes and refer to the typer's table, which has to outlive the ast
+// returns false at the first error, the types of the nodes are incomplete then
+bool typer_check(Typer *typer, Ast *ast) {
+    typer->ast = ast;
+    typer->arena = &ast->arena;
+    typer->interner = ast->output->interner;
+    for (int n = 0; n < NAMED_TYPES_COUNT; n++) {
+        typer->named_symbols[n] = interner_intern(typer->interner, named_types[n].name, strlen(named_types[n].name));
+    }
+    typer_reserve(typer, ast);
+    instance_cache_reset(&typer->instances);
+    typer->bindings_count = 1;
+    typer->generics = 0;
+    typer->procedure = 0;
+    typer->stack_count = 0;
+    typer->edges_count = 0;
+    typer->nodes_count = 0;
+    typer->worklist_count = 0;
+    typer->resolved_count = 0;
+    typer->parked_count = 0;
+    typer->has_failed = false;
+    typer->error_node = 0;
+
+    ListIndex declarations = typer_node(typer, ast->root)->a;
+    int count = ast_list_count(typer->arena, declarations);
+    uint32_t *items = ast_list_items(typer->arena, declarations);
+    int declared_count = 0;
+    for (; declared_count < count && !typer->has_failed; declared_count++) {
+        Symbol symbol = typer_node(typer, items[declared_count])->a;
+        if (typer->globals[symbol] != 0) {
+            typer_fail(typer, TYPER_ERROR_DECLARATION_CONFLICT, items[declared_count]);
+            break;
+        }
+        typer->globals[symbol] = items[declared_count];
+    }
+    for (int d = 0; d < count && !typer->has_failed; d++) {
+        typer_walk_declaration(typer, items[d]);
+    }
+    typer_unbind(typer, 1);
+
+    if (!typer->has_failed) {
+        typer_build_graph(typer);
+        typer_run_worklist(typer);
+    }
+
+    // only the globals of this file are cleared, the next file starts without them
+    for (int d = 0; d < declared_count; d++) {
+        typer->globals[typer_node(typer, items[d])->a] = 0;
+    }
+    return !typer->has_failed;
+}
+
+// PRINTING
+
+void print_typer_error(Typer *typer, Ast *ast) {
+    if (!typer->has_failed) {
+        return;
+    }
+    uint32_t token = ast->arena.nodes[typer->error_node].token;
+    Cursor start = output_cursor_at(ast->output, token_arena_offset(&ast->output->tokens, token));
+    Cursor end = output_cursor_at(ast->output, token_arena_end_offset(&ast->output->tokens, token));
+    cout << "error occured: " << typer_error_names[typer->error]
+         << " at " << start.line_number << ":" << start.character << " - " << end.line_number << ":" << end.character
+         << " (" << typer_error_messages[typer->error] << ")" << endl;
+}
+
+// "name: Type" for every declaration, in the order of the source
+std::string typer_format(Typer *typer, Ast *ast) {
+    std::string string;
+    for (int n = 1; n < ast->arena.count; n++) {
+        AstNode node = ast->arena.nodes[n];
+        if (node.kind != NODE_VARIABLE) {
+            continue;
+        }
+        ast_append_symbol(ast, &string, node.a);
+        string.append(": ");
+        type_append_name(&typer->types, ast->output->interner, &string, node.type);
+        string.push_back('\n');
+    }
+    return string;
+}
+
+// "name<Type, Type>" for every instance, in the order they were made
+std::string typer_format_instances(Typer *typer, Ast *ast) {
+    std::string string;
+    InstanceCache *cache = &typer->instances;
+    for (int i = 0; i < cache->count; i++) {
+        ast_append_symbol(ast, &string, ast->arena.nodes[cache->instances[i].declaration].a);
+        for (int s = 0; s < instance_solid_count(cache, i); s++) {
+            string.append(s == 0 ? "<" : ", ");
+            type_append_name(&typer->types, ast->output->interner, &string, instance_solid_types(cache, i)[s]);
+        }
+        string.append(">\n");
+    }
+    return string;
+}
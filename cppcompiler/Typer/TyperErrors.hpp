@@ -0,0 +1,92 @@
+//
+//  TyperErrors.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+// the ParserMessage cases of the Swift parser that need declarations or types,
+// and typeCycle for declarations that depend on themselves, which the Swift parser leaves unresolved
+enum TyperError {
+    TYPER_ERROR_DECLARATION_CONFLICT,
+    TYPER_ERROR_ASSIGN_UNDECLARED,
+    TYPER_ERROR_ASSIGN_PASSED_NOT_VALUE,
+    TYPER_ERROR_ASSIGN_CONST,
+    TYPER_ERROR_ASSIGN_TYPE_MISMATCH,
+    TYPER_ERROR_VAR_DECL_TYPE_MISMATCH,
+    TYPER_ERROR_BINOP_ARG_TYPE_MATCH,
+    TYPER_ERROR_BINOP_ARG_TYPE_SUPPORT,
+    TYPER_ERROR_VALUE_NOT_POINTER,
+    TYPER_ERROR_CONDITION_TYPE_MISMATCH,
+    TYPER_ERROR_FREE_EXPECTS_POINTER,
+    TYPER_ERROR_RETURN_TYPE_NOT_MATCHING,
+    TYPER_ERROR_SUBSCRIPT_NOT_ARRAY,
+    TYPER_ERROR_SUBSCRIPT_EXPECTED_INDEX_EXPRESSION,
+    TYPER_ERROR_MEMBER_ACCESS_NON_STRUCT,
+    TYPER_ERROR_MEMBER_ACCESS_UNDECLARED_MEMBER,
+    TYPER_ERROR_CALL_NOT_PROCEDURE,
+    TYPER_ERROR_CALL_ARGUMENTS_COUNT,
+    TYPER_ERROR_CALL_ARGUMENTS_VAR_COUNT,
+    TYPER_ERROR_CALL_ARGUMENT_TYPE_MISMATCH,
+    TYPER_ERROR_PROC_SHOULD_BE_GENERIC,
+    TYPER_ERROR_STRUCT_SHOULD_BE_GENERIC,
+    TYPER_ERROR_TYPE_CYCLE,
+    TYPER_ERROR_COUNT
+};
+typedef enum TyperError TyperError;
+
+// the names of the ParserMessage members, which the tests use
+const char* const typer_error_names[TYPER_ERROR_COUNT] = {
+    "declarationConflict",
+    "assignUndeclared",
+    "assignPassedNotValue",
+    "assignConst",
+    "assignTypeMismatch",
+    "varDeclTypeMismatch",
+    "binopArgTypeMatch",
+    "binopArgTypeSupport",
+    "valueNotPointer",
+    "conditionTypeMismatch",
+    "freeExpectsPointer",
+    "returnTypeNotMatching",
+    "subscriptNotArray",
+    "subscriptExpectedIndexExpression",
+    "memberAccessNonStruct",
+    "memberAccessUndeclaredMember",
+    "callNotProcedure",
+    "callArgumentsCount",
+    "callArgumentsVarCount",
+    "callArgumentTypeMismatch",
+    "procShouldBeGeneric",
+    "structShouldBeGeneric",
+    "typeCycle"
+};
+
+const char* const typer_error_messages[TYPER_ERROR_COUNT] = {
+    "Declaration conflicts with another declaration with the same name.",
+    "Undeclared variable.",
+    "Expression is not a value.",
+    "Variable is declared as constant.",
+    "Variable is declared with another type than the expression given evaluates to.",
+    "Type supplied does not match the type as specified.",
+    "Argument types don't match.",
+    "Operation doesn't support arguments of this type.",
+    "Dereference operation expects a pointer.",
+    "Condition is expected to be of type 'Bool'.",
+    "Expected expression of pointer type after 'free'.",
+    "Return type does not match the type the expression provided evaluates to.",
+    "Subscript is only applicable to an array type.",
+    "Expression of type 'Int' is expected for an array subscript index.",
+    "Trying to perform member access on a non-struct value.",
+    "Struct does not declare a member with this name.",
+    "Trying to call something that's not a procedure.",
+    "Procedure requires another number of arguments.",
+    "Procedure requires more arguments.",
+    "Argument of another type is expected by the procedure.",
+    "Procedure is declared generic and has to be solidified at usage.",
+    "Struct is declared generic and has to be solidified at usage.",
+    "Type of the declaration depends on itself."
+};
@@ -0,0 +1,372 @@
+//
+//  Types.hpp
+//  Compiler
+//
+//  Created by Ерохин Ярослав Игоревич on 17.10.2026.
+//  Copyright © 2026 Yaroslav Erokhin. All rights reserved.
+//
+
+#pragma once
+
+#include "../Lexer/Interner.hpp"
+#include <string>
+
+// The types of compiler/Compiler/Compiler/Parser/AST Model/Types.swift, stored in a TypeTable and referred to by index.
+// Type 0 is the unresolved type, the first types are the ones typeNamed() returns for the names of the language.
+// Every type is in the table once, see type_intern, so types are the same when their ids are.
+// type_equal is looser than that, Any and the generic types are equal to every type.
+
+typedef uint32_t TypeId;
+
+enum TypeKind {
+    TYPE_UNRESOLVED,
+    TYPE_VOID,
+    TYPE_INT,
+    TYPE_FLOAT,
+    TYPE_POINTER,
+    TYPE_ARRAY,
+    TYPE_STRUCT,
+    TYPE_ALIAS, // a generic type of the declaration, =T
+    TYPE_ANY
+};
+typedef enum TypeKind TypeKind;
+
+struct TypeInfo {
+    uint8_t kind;
+    bool is_generic; // the type is an ALIAS or has one inside of it
+    uint32_t bits; // of INT and FLOAT
+    TypeId element; // pointee of POINTER, element of ARRAY
+    int64_t length; // of ARRAY, 0 when it's only known at runtime
+    Symbol symbol; // name of STRUCT and ALIAS
+    uint32_t solid_types; // of STRUCT, into TypeTable::extra as the count followed by the types, 0 for none
+    uint32_t hash; // of everything above, see type_hash
+};
+typedef struct TypeInfo TypeInfo;
+
+struct TypeTable {
+    TypeInfo *types;
+    int count;
+    int capacity;
+
+    TypeId *extra; // lists of solid types
+    int extra_count;
+    int extra_capacity;
+
+    TypeId *slots; // type + 1, 0 is an empty slot
+    unsigned int slots_capacity; // power of 2
+};
+typedef struct TypeTable TypeTable;
+
+// NAMED TYPES
+
+const TypeId TYPE_ID_UNRESOLVED = 0;
+const TypeId TYPE_ID_VOID = 1;
+const TypeId TYPE_ID_ANY = 2;
+const TypeId TYPE_ID_BOOL = 3;
+const TypeId TYPE_ID_INT8 = 4;
+const TypeId TYPE_ID_INT16 = 5;
+const TypeId TYPE_ID_INT = 6; // Int32
+const TypeId TYPE_ID_INT64 = 7;
+const TypeId TYPE_ID_INT128 = 8;
+const TypeId TYPE_ID_HALF = 9;
+const TypeId TYPE_ID_FLOAT = 10; // Float32
+const TypeId TYPE_ID_DOUBLE = 11;
+const TypeId TYPE_ID_FLOAT128 = 12;
+const TypeId TYPE_ID_STRING = 13; // Int8*
+const TypeId TYPE_ID_NULL = 14; // Any*, the type of null until it's converted to a pointer
+
+struct NamedType {
+    const char *name;
+    TypeId type;
+};
+
+// the names typeNamed() knows, other names are structs or generic types
+const NamedType named_types[] = {
+    { "Int", TYPE_ID_INT }, { "Bool", TYPE_ID_BOOL }, { "Int8", TYPE_ID_INT8 }, { "Int16", TYPE_ID_INT16 },
+    { "Int32", TYPE_ID_INT }, { "Int64", TYPE_ID_INT64 }, { "Int128", TYPE_ID_INT128 },
+    { "Float", TYPE_ID_FLOAT }, { "Float16", TYPE_ID_HALF }, { "Float32", TYPE_ID_FLOAT },
+    { "Float64", TYPE_ID_DOUBLE }, { "Float128", TYPE_ID_FLOAT128 },
+    { "String", TYPE_ID_STRING }, { "Void", TYPE_ID_VOID }, { "Any", TYPE_ID_ANY }
+};
+const int NAMED_TYPES_COUNT = sizeof(named_types) / sizeof(named_types[0]);
+
+// TYPE TABLE
+
+// FNV-1a of the fields, the solid types are hashed instead of their index in the extra
+uint32_t type_hash(TypeInfo *info, const TypeId *solid_types, int count) {
+    uint32_t hash = 2166136261u;
+    uint32_t words[6] = { info->kind, info->bits, info->element, (uint32_t) info->length,
+                          (uint32_t) (info->length >> 32), info->symbol };
+    for (uint32_t word : words) {
+        hash = (hash ^ word) * 16777619u;
+    }
+    for (int s = 0; s < count; s++) {
+        hash = (hash ^ solid_types[s]) * 16777619u;
+    }
+    return hash;
+}
+
+bool type_is_same(TypeTable *table, TypeId type, TypeInfo *info, const TypeId *solid_types, int count) {
+    TypeInfo *other = &table->types[type];
+    return other->hash == info->hash && other->kind == info->kind && other->bits == info->bits
+        && other->element == info->element && other->length == info->length && other->symbol == info->symbol
+        && (int) table->extra[other->solid_types] == count
+        && (count == 0 || memcmp(table->extra + other->solid_types + 1, solid_types, count * sizeof(TypeId)) == 0);
+}
+
+void type_table_grow_slots(TypeTable *table) {
+    unsigned int capacity = table->slots_capacity == 0 ? 1024 : table->slots_capacity * 2;
+    TypeId *slots = (TypeId*) calloc(capacity, sizeof(TypeId));
+    for (int t = 0; t < table->count; t++) {
+        unsigned int index = table->types[t].hash & (capacity - 1);
+        while (slots[index] != 0) {
+            index = (index + 1) & (capacity - 1);
+        }
+        slots[index] = t + 1;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->slots_capacity = capacity;
+}
+
+// returns the type that is already in the table, or adds it
+// the solid types are copied, so they can't be a list of the table itself
+TypeId type_intern(TypeTable *table, TypeInfo info, const TypeId *solid_types, int count) {
+    info.hash = type_hash(&info, solid_types, count);
+    unsigned int index = info.hash & (table->slots_capacity - 1);
+    while (table->slots[index] != 0) {
+        TypeId type = table->slots[index] - 1;
+        if (type_is_same(table, type, &info, solid_types, count)) {
+            return type;
+        }
+        index = (index + 1) & (table->slots_capacity - 1);
+    }
+
+    info.is_generic = info.kind == TYPE_ALIAS || (info.element != 0 && table->types[info.element].is_generic);
+    if (count > 0) {
+        if (table->extra_count + count + 1 > table->extra_capacity) {
+            while (table->extra_count + count + 1 > table->extra_capacity) {
+                table->extra_capacity *= 2;
+            }
+            table->extra = (TypeId*) realloc(table->extra, table->extra_capacity * sizeof(TypeId));
+        }
+        info.solid_types = table->extra_count;
+        table->extra[table->extra_count] = count;
+        memcpy(table->extra + table->extra_count + 1, solid_types, count * sizeof(TypeId));
+        table->extra_count += count + 1;
+        for (int s = 0; s < count; s++) {
+            info.is_generic |= table->types[solid_types[s]].is_generic;
+        }
+    }
+    if (table->count == table->capacity) {
+        table->capacity *= 2;
+        table->types = (TypeInfo*) realloc(table->types, table->capacity * sizeof(TypeInfo));
+    }
+    TypeId type = table->count++;
+    table->types[type] = info;
+    table->slots[index] = type + 1;
+    if ((unsigned int) table->count * 2 > table->slots_capacity) {
+        type_table_grow_slots(table);
+    }
+    return type;
+}
+
+TypeId type_make(TypeTable *table, TypeKind kind, uint32_t bits, TypeId element) {
+    TypeInfo info;
+    memset(&info, 0, sizeof(info));
+    info.kind = (uint8_t) kind;
+    info.bits = bits;
+    info.element = element;
+    return type_intern(table, info, NULL, 0);
+}
+
+TypeId type_make_pointer(TypeTable *table, TypeId pointee) {
+    return type_make(table, TYPE_POINTER, 0, pointee);
+}
+
+TypeId type_make_array(TypeTable *table, TypeId element, int64_t length) {
+    TypeInfo info;
+    memset(&info, 0, sizeof(info));
+    info.kind = TYPE_ARRAY;
+    info.element = element;
+    info.length = length;
+    return type_intern(table, info, NULL, 0);
+}
+
+TypeId type_make_struct(TypeTable *table, Symbol symbol, const TypeId *solid_types, int count) {
+    TypeInfo info;
+    memset(&info, 0, sizeof(info));
+    info.kind = TYPE_STRUCT;
+    info.symbol = symbol;
+    return type_intern(table, info, solid_types, count);
+}
+
+TypeId type_make_alias(TypeTable *table, Symbol symbol) {
+    TypeInfo info;
+    memset(&info, 0, sizeof(info));
+    info.kind = TYPE_ALIAS;
+    info.symbol = symbol;
+    return type_intern(table, info, NULL, 0);
+}
+
+void type_table_init(TypeTable *table) {
+    memset(table, 0, sizeof(*table));
+    table->capacity = 1024;
+    table->types = (TypeInfo*) malloc(table->capacity * sizeof(TypeInfo));
+    table->extra_capacity = 1024;
+    table->extra = (TypeId*) malloc(table->extra_capacity * sizeof(TypeId));
+    table->extra[0] = 0; // no solid types
+    table->extra_count = 1;
+    type_table_grow_slots(table);
+
+    // in the order of the TYPE_ID constants
+    type_make(table, TYPE_UNRESOLVED, 0, 0);
+    type_make(table, TYPE_VOID, 0, 0);
+    type_make(table, TYPE_ANY, 0, 0);
+    const uint32_t int_bits[] = { 1, 8, 16, 32, 64, 128 };
+    for (uint32_t bits : int_bits) {
+        type_make(table, TYPE_INT, bits, 0);
+    }
+    const uint32_t float_bits[] = { 16, 32, 64, 128 };
+    for (uint32_t bits : float_bits) {
+        type_make(table, TYPE_FLOAT, bits, 0);
+    }
+    type_make_pointer(table, TYPE_ID_INT8);
+    type_make_pointer(table, TYPE_ID_ANY);
+}
+
+void type_table_free(TypeTable *table) {
+    free(table->types);
+    free(table->extra);
+    free(table->slots);
+    memset(table, 0, sizeof(*table));
+}
+
+inline TypeInfo* type_at(TypeTable *table, TypeId type) {
+    return &table->types[type];
+}
+
+inline int type_solid_count(TypeTable *table, TypeId type) {
+    return table->extra[table->types[type].solid_types];
+}
+
+// the pointer is only valid until the next type is made
+inline TypeId* type_solid_types(TypeTable *table, TypeId type) {
+    return table->extra + table->types[type].solid_types + 1;
+}
+
+// TYPES
+
+inline bool type_is_int(TypeTable *table, TypeId type) {
+    return table->types[type].kind == TYPE_INT;
+}
+
+// the types isAccepting() does math with, Bool is not one of them
+inline bool type_is_number(TypeTable *table, TypeId type) {
+    TypeInfo *info = &table->types[type];
+    return (info->kind == TYPE_INT && info->bits >= 8 && info->bits <= 64) || (info->kind == TYPE_FLOAT && info->bits <= 64);
+}
+
+// getValueType(): the type without its pointers, Node<Int*>** is Node<Int*>
+TypeId type_value_type(TypeTable *table, TypeId type) {
+    while (table->types[type].kind == TYPE_POINTER) {
+        type = table->types[type].element;
+    }
+    return type;
+}
+
+// equals(to:) of Types.swift: Any and generic types are equal to every type
+bool type_equal(TypeTable *table, TypeId lhs, TypeId rhs) {
+    while (lhs != rhs) {
+        TypeInfo *left = &table->types[lhs];
+        TypeInfo *right = &table->types[rhs];
+        if (left->kind == TYPE_ANY || right->kind == TYPE_ANY || left->kind == TYPE_ALIAS || right->kind == TYPE_ALIAS) {
+            return true;
+        }
+        if (left->kind != right->kind) {
+            return false;
+        }
+        switch (left->kind) {
+            case TYPE_INT: case TYPE_FLOAT:
+                return left->bits == right->bits;
+            case TYPE_ARRAY:
+                if (left->length != right->length) {
+                    return false;
+                }
+                break;
+            case TYPE_STRUCT: {
+                int count = type_solid_count(table, lhs);
+                if (left->symbol != right->symbol || count != type_solid_count(table, rhs)) {
+                    return false;
+                }
+                for (int s = 0; s < count; s++) {
+                    if (!type_equal(table, type_solid_types(table, lhs)[s], type_solid_types(table, rhs)[s])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case TYPE_POINTER:
+                break;
+            default:
+                return true;
+        }
+        lhs = left->element;
+        rhs = right->element;
+    }
+    return true;
+}
+
+// typeName of Types.swift, except that Int32 is written Int, Int1 Bool and Float32 Float,
+// and arrays with a length that is only known at runtime are written T[..]
+void type_append_name(TypeTable *table, Interner *interner, std::string *string, TypeId type) {
+    TypeInfo info = table->types[type];
+    switch (info.kind) {
+        case TYPE_UNRESOLVED: string->append("[Unresolved]"); break;
+        case TYPE_VOID: string->append("Void"); break;
+        case TYPE_ANY: string->append("Any"); break;
+        case TYPE_INT:
+            string->append(info.bits == 1 ? "Bool" : info.bits == 32 ? "Int" : "Int" + std::to_string(info.bits));
+            break;
+        case TYPE_FLOAT:
+            string->append(info.bits == 32 ? "Float" : "Float" + std::to_string(info.bits));
+            break;
+        case TYPE_POINTER:
+            type_append_name(table, interner, string, info.element);
+            string->push_back('*');
+            break;
+        case TYPE_ARRAY: {
+            // written the way it's declared, the outermost length first
+            TypeId element = info.element;
+            while (table->types[element].kind == TYPE_ARRAY) {
+                element = table->types[element].element;
+            }
+            type_append_name(table, interner, string, element);
+            for (TypeId array = type; array != element; array = table->types[array].element) {
+                int64_t length = table->types[array].length;
+                string->append(length > 0 ? "[" + std::to_string(length) + "]" : "[..]");
+            }
+            break;
+        }
+        case TYPE_STRUCT: {
+            string->append(interner_characters(interner, info.symbol), interner_length(interner, info.symbol));
+            int count = type_solid_count(table, type);
+            for (int s = 0; s < count; s++) {
+                string->append(s == 0 ? "<" : ", ");
+                type_append_name(table, interner, string, type_solid_types(table, type)[s]);
+            }
+            string->append(count > 0 ? ">" : "");
+            break;
+        }
+        case TYPE_ALIAS:
+            string->push_back('=');
+            string->append(interner_characters(interner, info.symbol), interner_length(interner, info.symbol));
+            break;
+    }
+}
+
+std::string type_name(TypeTable *table, Interner *interner, TypeId type) {
+    std::string string;
+    type_append_name(table, interner, &string, type);
+    return string;
+}